@@ -37,6 +37,8 @@ public class GAHAddon : ModuleRules
             new string[]
             {
                 "GAExt",
+                "Slate",
+                "SlateCore",
             }
         );
 
@@ -2,13 +2,20 @@
 
 #include "GAHAddon.h"
 
+#include "Telemetry/HealthTelemetry.h"
+#include "CombatLog/HealthCombatLog.h"
+
 IMPLEMENT_MODULE(FGAHAddonModule, GAHAddon)
 
 
 void FGAHAddonModule::StartupModule()
 {
+	GAHATelemetry::Startup();
+	GAHACombatLog::Startup();
 }
 
 void FGAHAddonModule::ShutdownModule()
 {
+	GAHACombatLog::Shutdown();
+	GAHATelemetry::Shutdown();
 }
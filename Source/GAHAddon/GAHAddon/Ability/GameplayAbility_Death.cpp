@@ -6,7 +6,9 @@
 #include "GameplayTag/GAHATags_Ability.h"
 #include "HealthFunctionLibrary.h"
 #include "HealthComponent.h"
+#include "Benchmark/HealthBenchmark.h"
 #include "GAHAddonLogs.h"
+#include "GAHAddonStats.h"
 
 #include "GameplayTag/GAETags_Ability.h"
 
@@ -15,6 +17,8 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(GameplayAbility_Death)
 
+DECLARE_CYCLE_STAT(TEXT("Death Ability Activate"), STAT_GAHA_DeathAbilityActivate, STATGROUP_GAHA);
+
 
 UGameplayAbility_Death::UGameplayAbility_Death(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -40,12 +44,15 @@ UGameplayAbility_Death::UGameplayAbility_Death(const FObjectInitializer& ObjectI
 
 void UGameplayAbility_Death::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Death, STAT_GAHA_DeathAbilityActivate);
+
 	check(ActorInfo);
 
 	auto* ASC{ ActorInfo->AbilitySystemComponent.Get() };
 
 	// Make it non-cancelable
 
+	bDeathCanceled = false;
 	SetCanBeCanceled(false);
 
 	// Cancel all abilities and block others from starting.
@@ -72,7 +79,12 @@ void UGameplayAbility_Death::EndAbility(const FGameplayAbilitySpecHandle Handle,
 	// Always try to finish the death when the ability ends in case the ability doesn't.
 	// This won't do anything if the death hasn't been started.
 
-	FinishDeath();
+	if (!bDeathCanceled)
+	{
+		FinishDeath();
+	}
+
+	bDeathCanceled = false;
 
 	Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
 }
@@ -101,6 +113,22 @@ void UGameplayAbility_Death::FinishDeath()
 }
 
 
+void UGameplayAbility_Death::CancelDeath()
+{
+	if (!IsActive())
+	{
+		return;
+	}
+
+	bDeathCanceled = true;
+
+	// Only the server replicates the cancel, clients cancel their own instance when the revive replicates
+
+	SetCanBeCanceled(true);
+	CancelAbility(CurrentSpecHandle, CurrentActorInfo, CurrentActivationInfo, CurrentActorInfo->IsNetAuthority());
+}
+
+
 UHealthComponent* UGameplayAbility_Death::GetHealthComponent() const
 {
 	if (auto* HCFromSourceObject{ GetTypedSourceObject<UHealthComponent>() })
@@ -16,7 +16,7 @@ struct FGameplayEventData;
  * Ability is activated automatically via the "Event.OutOfHealth" ability trigger tag.
  */
 UCLASS(Abstract)
-class UGameplayAbility_Death : public UGAEGameplayAbility
+class GAHADDON_API UGameplayAbility_Death : public UGAEGameplayAbility
 {
 	GENERATED_BODY()
 public:
@@ -49,6 +49,16 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Death")
 	void FinishDeath();
 
+public:
+	//
+	// Ends the active ability without finishing the death, e.g. when the owner is revived.
+	// The ability is made cancelable again since it blocks canceling while active.
+	//
+	void CancelDeath();
+
+private:
+	bool bDeathCanceled{ false };
+
 protected:
 	UHealthComponent* GetHealthComponent() const;
 
@@ -2,6 +2,8 @@
 
 #include "CombatAttributeSet.h"
 
+#include "Replication/HealthPushModel.h"
+
 #include "Net/UnrealNetwork.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CombatAttributeSet)
@@ -11,9 +13,45 @@ void UCombatAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UCombatAttributeSet, BaseDamage, COND_OwnerOnly, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UCombatAttributeSet, BaseHeal, COND_OwnerOnly, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UCombatAttributeSet, BaseHealShield, COND_OwnerOnly, REPNOTIFY_Always);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_OwnerOnly;
+	Params.RepNotifyCondition = REPNOTIFY_Always;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatAttributeSet, BaseDamage, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatAttributeSet, BaseHeal, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCombatAttributeSet, BaseHealShield, Params);
+}
+
+
+void UCombatAttributeSet::PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const
+{
+	Super::PostAttributeBaseChange(Attribute, OldValue, NewValue);
+
+	MarkAttributeDirty(Attribute);
+}
+
+void UCombatAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue)
+{
+	Super::PostAttributeChange(Attribute, OldValue, NewValue);
+
+	MarkAttributeDirty(Attribute);
+}
+
+void UCombatAttributeSet::MarkAttributeDirty(const FGameplayAttribute& Attribute) const
+{
+	if (Attribute == GetBaseDamageAttribute())
+	{
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, BaseDamage, this);
+	}
+	else if (Attribute == GetBaseHealAttribute())
+	{
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, BaseHeal, this);
+	}
+	else if (Attribute == GetBaseHealShieldAttribute())
+	{
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, BaseHealShield, this);
+	}
 }
 
 
@@ -13,7 +13,7 @@
  * Class that defines attributes for the amount of healing and damage from combat
  */
 UCLASS(BlueprintType)
-class UCombatAttributeSet : public UGAEAttributeSet
+class GAHADDON_API UCombatAttributeSet : public UGAEAttributeSet
 {
 	GENERATED_BODY()
 public:
@@ -21,6 +21,15 @@ public:
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+protected:
+	virtual void PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const override;
+	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
+
+	/**
+	 * Mark the replicated property of the attribute dirty for push model replication
+	 */
+	void MarkAttributeDirty(const FGameplayAttribute& Attribute) const;
+
 public:
 	ATTRIBUTE_ACCESSORS(UCombatAttributeSet, BaseDamage);
 	ATTRIBUTE_ACCESSORS(UCombatAttributeSet, BaseHeal);
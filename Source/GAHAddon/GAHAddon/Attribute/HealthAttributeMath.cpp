@@ -0,0 +1,192 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthAttributeMath.h"
+
+
+float& FHealthAttributeValues::GetValue(EHealthAttribute Attribute)
+{
+	switch (Attribute)
+	{
+	case EHealthAttribute::MinHealth:			return MinHealth;
+	case EHealthAttribute::MaxHealth:			return MaxHealth;
+	case EHealthAttribute::ExtraHealth:			return ExtraHealth;
+	case EHealthAttribute::Shield:				return Shield;
+	case EHealthAttribute::MaxShield:			return MaxShield;
+	case EHealthAttribute::DamageResistance:	return DamageResistance;
+	default:									check(Attribute == EHealthAttribute::Health); return Health;
+	}
+}
+
+float FHealthAttributeValues::GetValue(EHealthAttribute Attribute) const
+{
+	return const_cast<FHealthAttributeValues*>(this)->GetValue(Attribute);
+}
+
+float FHealthAttributeMath::ApplyDamageResistance(float Damage, float DamageResistance)
+{
+	return Damage * (1.0f - DamageResistance);
+}
+
+void FHealthAttributeMath::ApplyDamage(FHealthAttributeValues& Values, float Damage)
+{
+	auto DamageRemaing{ Damage };
+
+	// Skip if damage amount is less than 0
+
+	if (DamageRemaing <= 0.0f)
+	{
+		return;
+	}
+
+	// Apply to ExtraHealth
+
+	if (Values.ExtraHealth > 0.0f)
+	{
+		const auto DamageBuffer{ Values.ExtraHealth };
+		Values.ExtraHealth = FMath::Max(0.0f, DamageBuffer - DamageRemaing);
+
+		DamageRemaing -= DamageBuffer;
+
+		if (DamageRemaing <= 0.0f)
+		{
+			return;
+		}
+	}
+
+	// Apply to Shield
+
+	if (Values.Shield > 0.0f)
+	{
+		const auto DamageBuffer{ Values.Shield };
+		Values.Shield = FMath::Max(0.0f, DamageBuffer - DamageRemaing);
+
+		DamageRemaing -= DamageBuffer;
+
+		if (DamageRemaing <= 0.0f)
+		{
+			return;
+		}
+	}
+
+	// Apply to Health
+
+	if (Values.Health > 0.0f)
+	{
+		Values.Health = FMath::Max(Values.MinHealth, Values.Health - DamageRemaing);
+	}
+}
+
+void FHealthAttributeMath::ApplyHealing(FHealthAttributeValues& Values, float Healing)
+{
+	auto HealRemaing{ Healing };
+
+	// Skip if healing amount is less than 0
+
+	if (HealRemaing <= 0.0f)
+	{
+		return;
+	}
+
+	// Apply to Health
+
+	const auto HealthBuffer{ Values.MaxHealth - Values.Health };
+	if (HealthBuffer > 0.0f)
+	{
+		Values.Health = FMath::Min(Values.MaxHealth, Values.Health + HealRemaing);
+
+		HealRemaing -= HealthBuffer;
+
+		if (HealRemaing <= 0.0f)
+		{
+			return;
+		}
+	}
+
+	// Apply to Shield
+
+	if ((Values.MaxShield - Values.Shield) > 0.0f)
+	{
+		Values.Shield = FMath::Min(Values.MaxShield, Values.Shield + HealRemaing);
+	}
+}
+
+void FHealthAttributeMath::ApplyHealingShield(FHealthAttributeValues& Values, float Healing)
+{
+	// Skip if healing amount is less than 0
+
+	if (Healing > 0.0f)
+	{
+		Values.Shield = FMath::Min(Values.MaxShield, Values.Shield + Healing);
+	}
+}
+
+float FHealthAttributeMath::ClampValue(const FHealthAttributeValues& Values, EHealthAttribute Attribute, float NewValue)
+{
+	switch (Attribute)
+	{
+	case EHealthAttribute::Health:		return FMath::Clamp(NewValue, Values.MinHealth, Values.MaxHealth);
+	case EHealthAttribute::MaxHealth:	return FMath::Max(NewValue, 1.0f);
+	case EHealthAttribute::MinHealth:	return FMath::Clamp(NewValue, 0.0f, Values.MaxHealth);
+	case EHealthAttribute::ExtraHealth:	return FMath::Max(NewValue, 0.0f);
+	case EHealthAttribute::Shield:		return FMath::Clamp(NewValue, 0.0f, Values.MaxShield);
+	case EHealthAttribute::MaxShield:	return FMath::Max(NewValue, 0.0f);
+	default:							return NewValue;
+	}
+}
+
+bool FHealthAttributeMath::GetDependentClamp(const FHealthAttributeValues& Values, EHealthAttribute Attribute, EHealthAttribute& OutDependent, float& OutValue)
+{
+	// Lowering MaxHealth or MaxShield pulls Health or Shield down with it
+
+	if ((Attribute == EHealthAttribute::MaxHealth) && (Values.Health > Values.MaxHealth))
+	{
+		OutDependent = EHealthAttribute::Health;
+		OutValue = Values.MaxHealth;
+		return true;
+	}
+
+	if ((Attribute == EHealthAttribute::MaxShield) && (Values.Shield > Values.MaxShield))
+	{
+		OutDependent = EHealthAttribute::Shield;
+		OutValue = Values.MaxShield;
+		return true;
+	}
+
+	return false;
+}
+
+void FHealthAttributeMath::SetValue(FHealthAttributeValues& Values, EHealthAttribute Attribute, float NewValue)
+{
+	if (Attribute == EHealthAttribute::MAX)
+	{
+		return;
+	}
+
+	Values.GetValue(Attribute) = ClampValue(Values, Attribute, NewValue);
+
+	auto Dependent{ EHealthAttribute::MAX };
+	auto DependentValue{ 0.0f };
+
+	if (GetDependentClamp(Values, Attribute, Dependent, DependentValue))
+	{
+		Values.GetValue(Dependent) = ClampValue(Values, Dependent, DependentValue);
+	}
+}
+
+bool FHealthAttributeMath::UpdateOutOfHealth(float Health, bool& bOutOfHealth)
+{
+	const auto bIsZeroHealth{ IsOutOfHealth(Health) };
+	const auto bNotify{ bIsZeroHealth && !bOutOfHealth };
+
+	bOutOfHealth = bIsZeroHealth;
+
+	return bNotify;
+}
+
+void FHealthAttributeMath::ResetOutOfHealth(float Health, bool& bOutOfHealth)
+{
+	if (bOutOfHealth && (Health > 0.0f))
+	{
+		bOutOfHealth = false;
+	}
+}
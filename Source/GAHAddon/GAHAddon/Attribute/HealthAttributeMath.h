@@ -0,0 +1,103 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Stateful attributes of UHealthAttributeSet
+ */
+enum class EHealthAttribute : uint8
+{
+	Health,
+	MinHealth,
+	MaxHealth,
+	ExtraHealth,
+	Shield,
+	MaxShield,
+	DamageResistance,
+	MAX
+};
+
+
+/**
+ * Values of the stateful attributes of UHealthAttributeSet
+ */
+struct GAHADDON_API FHealthAttributeValues
+{
+public:
+	float Health{ 100.0f };
+	float MinHealth{ 0.0f };
+	float MaxHealth{ 100.0f };
+	float ExtraHealth{ 0.0f };
+	float Shield{ 50.0f };
+	float MaxShield{ 50.0f };
+	float DamageResistance{ 0.0f };
+
+public:
+	float& GetValue(EHealthAttribute Attribute);
+	float GetValue(EHealthAttribute Attribute) const;
+
+};
+
+
+/**
+ * Pure layer math of UHealthAttributeSet, shared with tools that simulate it without an ability system
+ */
+struct GAHADDON_API FHealthAttributeMath
+{
+public:
+	/**
+	 * Returns the damage reduced by the damage resistance
+	 */
+	static float ApplyDamageResistance(float Damage, float DamageResistance);
+
+	/**
+	 * Apply damage to ExtraHealth, Shield and Health in this order. Health does not fall below MinHealth.
+	 */
+	static void ApplyDamage(FHealthAttributeValues& Values, float Damage);
+
+	/**
+	 * Apply healing to Health and then to Shield
+	 */
+	static void ApplyHealing(FHealthAttributeValues& Values, float Healing);
+
+	/**
+	 * Apply healing to Shield
+	 */
+	static void ApplyHealingShield(FHealthAttributeValues& Values, float Healing);
+
+	/**
+	 * Returns the new value of the attribute clamped to the range allowed by the other values
+	 */
+	static float ClampValue(const FHealthAttributeValues& Values, EHealthAttribute Attribute, float NewValue);
+
+	/**
+	 * Returns whether a change of the attribute pushed a dependent attribute (Health or Shield) above its new maximum,
+	 * and the value it must be set to
+	 */
+	static bool GetDependentClamp(const FHealthAttributeValues& Values, EHealthAttribute Attribute, EHealthAttribute& OutDependent, float& OutValue);
+
+	/**
+	 * Set the attribute to the clamped value and clamp its dependent attribute, like a direct modification of UHealthAttributeSet
+	 */
+	static void SetValue(FHealthAttributeValues& Values, EHealthAttribute Attribute, float NewValue);
+
+	/**
+	 * Returns whether health has reached 0 and the out of health event must be notified
+	 */
+	static bool IsOutOfHealth(float Health) { return Health <= 0.0f; }
+
+	/**
+	 * Update the out of health flag after Damage or Health was executed.
+	 * Returns true when health just reached 0 and the out of health event must be notified.
+	 */
+	static bool UpdateOutOfHealth(float Health, bool& bOutOfHealth);
+
+	/**
+	 * Clear the out of health flag once health exceeds 0 after any attribute change
+	 */
+	static void ResetOutOfHealth(float Health, bool& bOutOfHealth);
+
+};
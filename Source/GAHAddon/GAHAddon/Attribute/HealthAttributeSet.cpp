@@ -2,8 +2,18 @@
 
 #include "HealthAttributeSet.h"
 
+#include "HealthAttributeMath.h"
+
 #include "GameplayTag/GAHATags_Flag.h"
 #include "GameplayTag/GAHATags_Damage.h"
+#include "GameplayTag/GAHATags_Status.h"
+#include "Replication/HealthPushModel.h"
+#include "Benchmark/HealthBenchmark.h"
+#include "Replay/HealthStream.h"
+#include "CombatLog/HealthCombatLog.h"
+#include "HitConfirm/HealthHitConfirmComponent.h"
+#include "Telemetry/HealthTelemetry.h"
+#include "GAHAddonStats.h"
 
 #include "GameplayEffectExtension.h"
 #include "GameplayEffectTypes.h"
@@ -13,29 +23,89 @@
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HealthAttributeSet)
 
+DECLARE_CYCLE_STAT(TEXT("Pre Gameplay Effect Execute"), STAT_GAHA_PreGameplayEffectExecute, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Post Gameplay Effect Execute"), STAT_GAHA_PostGameplayEffectExecute, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Clamp Attribute"), STAT_GAHA_ClampAttribute, STATGROUP_GAHA);
+
+
+static void RecordCombatLogEvent(const UHealthAttributeSet* AttributeSet, const FGameplayEffectModCallbackData& Data, const FGameplayTag& DamageType, EHealthCombatLogFlags Flags)
+{
+	auto Type{ EHealthCombatLogEventType::MAX };
+
+	if (Data.EvaluatedData.Attribute == UHealthAttributeSet::GetDamageAttribute())				Type = EHealthCombatLogEventType::Damage;
+	else if (Data.EvaluatedData.Attribute == UHealthAttributeSet::GetHealingAttribute())		Type = EHealthCombatLogEventType::Heal;
+	else if (Data.EvaluatedData.Attribute == UHealthAttributeSet::GetHealingShieldAttribute())	Type = EHealthCombatLogEventType::HealShield;
+
+	const auto* Owner{ AttributeSet->GetOwningActor() };
+
+	if ((Type == EHealthCombatLogEventType::MAX) || !Owner || !Owner->HasAuthority())
+	{
+		return;
+	}
+
+	const auto& EffectContext{ Data.EffectSpec.GetEffectContext() };
+	const auto TotalHealth{ AttributeSet->GetHealth() + AttributeSet->GetExtraHealth() + AttributeSet->GetShield() };
+
+	GAHACombatLog::RecordEvent(Type, Data.Target.GetAvatarActor(), EffectContext.GetOriginalInstigator(), EffectContext.GetEffectCauser(),
+		DamageType, Data.EvaluatedData.Magnitude, TotalHealth, Flags);
+}
+
+static bool IsHealingBlocked(const UAbilitySystemComponent& Target)
+{
+	return Target.HasMatchingGameplayTag(TAG_Status_Downed) || Target.HasMatchingGameplayTag(TAG_Status_Death_Pending);
+}
+
+static bool IsGain(const FGameplayModifierEvaluatedData& EvaluatedData, float CurrentValue)
+{
+	switch (EvaluatedData.ModifierOp)
+	{
+	case EGameplayModOp::Additive:		return EvaluatedData.Magnitude > 0.0f;
+	case EGameplayModOp::Multiplicitive:	return EvaluatedData.Magnitude > 1.0f;
+	case EGameplayModOp::Division:		return (EvaluatedData.Magnitude > 0.0f) && (EvaluatedData.Magnitude < 1.0f);
+	case EGameplayModOp::Override:		return EvaluatedData.Magnitude > CurrentValue;
+	default:							return false;
+	}
+}
+
 
 void UHealthAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, Health, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, MinHealth, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, MaxHealth, COND_None, REPNOTIFY_Always);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_None;
+	Params.RepNotifyCondition = REPNOTIFY_Always;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, Health, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, MinHealth, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, MaxHealth, Params);
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, ExtraHealth, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, ExtraHealth, Params);
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, Shield, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, MaxShield, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, Shield, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, MaxShield, Params);
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UHealthAttributeSet, DamageResistance, COND_None, REPNOTIFY_Always);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthAttributeSet, DamageResistance, Params);
 }
 
 
 bool UHealthAttributeSet::PreGameplayEffectExecute(FGameplayEffectModCallbackData& Data)
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(PreExecute, STAT_GAHA_PreGameplayEffectExecute);
+
+	// Consumed before any early out so that a rejected output does not flag the next modifier
+
+	bExecutionOutput = GAHACombatLog::IsEnabled() && GAHACombatLog::ConsumeExecutionOutput(Data.Target.GetAvatarActor());
+
 	if (!Super::PreGameplayEffectExecute(Data))
 	{
-		return false;
+		return RejectGameplayEffectExecute(Data);
+	}
+
+	if (GAHAHealthStream::IsRecording())
+	{
+		GAHAHealthStream::NotifyPreExecute(this);
 	}
 
 	/**
@@ -55,80 +125,100 @@ bool UHealthAttributeSet::PreGameplayEffectExecute(FGameplayEffectModCallbackDat
 			if (bHasDamageImmunity && !bIsDamageFromSelfDestruct)
 			{
 				Data.EvaluatedData.Magnitude = 0.0f;
-				return false;
+				return RejectGameplayEffectExecute(Data);
 			}
 
 			// Apply damage reduction due to damage resistance
 
-			Data.EvaluatedData.Magnitude *= (1.0f - GetDamageResistance());
+			Data.EvaluatedData.Magnitude = FHealthAttributeMath::ApplyDamageResistance(Data.EvaluatedData.Magnitude, GetDamageResistance());
 		}
 	}
 
-	return true;
-}
+	/**
+	 * Attribute [Healing]
+	 */
+	else if ((Data.EvaluatedData.Attribute == GetHealingAttribute()) || (Data.EvaluatedData.Attribute == GetHealingShieldAttribute()))
+	{
+		// Downed owners only come back through UHealthComponent::Revive, healing them would leave the bleed-out running
+		// and shield would absorb the damage meant for the downed health.
+		// Owners whose death is still queued in UHealthDeathQueueSubsystem would be killed after the heal.
 
-void UHealthAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
-{
-	Super::PostGameplayEffectExecute(Data);
+		if (IsHealingBlocked(Data.Target))
+		{
+			Data.EvaluatedData.Magnitude = 0.0f;
+			return RejectGameplayEffectExecute(Data);
+		}
+	}
 
 	/**
-	 * Attribute [Damage]
-	 * 
-	 * Apply Damage values to Health and Shield
+	 * Attribute [ExtraHealth] [Shield]
 	 */
-	if (Data.EvaluatedData.Attribute == GetDamageAttribute())
+	else if ((Data.EvaluatedData.Attribute == GetExtraHealthAttribute()) || (Data.EvaluatedData.Attribute == GetShieldAttribute()))
 	{
-		auto DamageRemaing{ Data.EvaluatedData.Magnitude };
+		// Same as healing, but only for the modifiers that raise the value
 
-		// Skip if damage amount is less than 0
+		if (IsHealingBlocked(Data.Target) && IsGain(Data.EvaluatedData, Data.EvaluatedData.Attribute.GetNumericValue(this)))
+		{
+			return false;
+		}
+	}
 
-		if (DamageRemaing > 0.0f)
-		{	
-			while (DamageRemaing > 0)
-			{
-				auto DamageBuffer{ 0.0f };
+	return true;
+}
 
-				// Apply to ExtraHealth
+bool UHealthAttributeSet::RejectGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
+{
+	// Lets replays skip the input of the execution instead of applying its output
 
-				DamageBuffer = GetExtraHealth();
-				if (DamageBuffer > 0)
-				{
-					SetExtraHealth(FMath::Max(0.0f, DamageBuffer - DamageRemaing));
+	if (bExecutionOutput)
+	{
+		bExecutionOutput = false;
 
-					DamageRemaing -= DamageBuffer;
+		RecordCombatLogEvent(this, Data, GetDamageTypeTag(Data.EffectSpec), EHealthCombatLogFlags::FromExecution | EHealthCombatLogFlags::Rejected);
+	}
 
-					continue;
-				}
+	return false;
+}
 
-				// Apply to Shield
+void UHealthAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(PostExecute, STAT_GAHA_PostGameplayEffectExecute);
 
-				DamageBuffer = GetShield();
-				if (DamageBuffer > 0)
-				{
-					SetShield(FMath::Max(0.0f, DamageBuffer - DamageRemaing));
+	Super::PostGameplayEffectExecute(Data);
 
-					DamageRemaing -= DamageBuffer;
+	// Read before the out of health delegates can execute other modifiers on this set
 
-					continue;
-				}
+	const auto bFromExecution{ bExecutionOutput };
+	bExecutionOutput = false;
 
-				// Apply to Health
+	auto bBrokeShield{ false };
+	auto DamageToHealth{ 0.0f };
 
-				DamageBuffer = GetHealth();
-				if (DamageBuffer > 0)
-				{
-					SetHealth(FMath::Max(GetMinHealth(), DamageBuffer - DamageRemaing));
+	/**
+	 * Attribute [Damage]
+	 * 
+	 * Apply Damage values to Health and Shield
+	 */
+	if (Data.EvaluatedData.Attribute == GetDamageAttribute())
+	{
+		INC_DWORD_STAT(STAT_GAHA_DamageEvents);
+		GAHA_TELEMETRY_INC(DamageApplications);
 
-					DamageRemaing -= DamageBuffer;
+		const auto OldValues{ GetAttributeValues() };
+		auto NewValues{ OldValues };
 
-					break;
-				}
+		FHealthAttributeMath::ApplyDamage(NewValues, Data.EvaluatedData.Magnitude);
 
-				break;
-			}
-		}
+		SetLayerValues(OldValues, NewValues);
 
 		SetDamage(0.0f);
+
+		bBrokeShield = (OldValues.Shield > 0.0f) && (NewValues.Shield <= 0.0f);
+
+		// Damage left after ExtraHealth and Shield, which is what drains the downed health
+
+		const auto DamageAbsorbed{ (OldValues.ExtraHealth - NewValues.ExtraHealth) + (OldValues.Shield - NewValues.Shield) };
+		DamageToHealth = FMath::Max(Data.EvaluatedData.Magnitude - DamageAbsorbed, 0.0f);
 	}
 
 	
@@ -139,43 +229,15 @@ void UHealthAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 	 */
 	else if (Data.EvaluatedData.Attribute == GetHealingAttribute())
 	{
-		auto HealRemaing{ Data.EvaluatedData.Magnitude };
-
-		// Skip if healing amount is less than 0
-
-		if (HealRemaing > 0.0f)
-		{
-			while (HealRemaing > 0)
-			{
-				auto HealingBuffer{ 0.0f };
-
-				// Apply to Health
-
-				HealingBuffer = GetMaxHealth() - GetHealth();
-				if (HealingBuffer > 0)
-				{
-					SetHealth(FMath::Min(GetMaxHealth(), GetHealth() + HealRemaing));
-
-					HealRemaing -= HealingBuffer;
-
-					continue;
-				}
+		INC_DWORD_STAT(STAT_GAHA_HealEvents);
+		GAHA_TELEMETRY_INC(HealApplications);
 
-				// Apply to Shield
+		const auto OldValues{ GetAttributeValues() };
+		auto NewValues{ OldValues };
 
-				HealingBuffer = GetMaxShield() - GetShield();
-				if (HealingBuffer > 0)
-				{
-					SetShield(FMath::Min(GetMaxShield(), GetShield() + HealRemaing));
+		FHealthAttributeMath::ApplyHealing(NewValues, Data.EvaluatedData.Magnitude);
 
-					HealRemaing -= HealingBuffer;
-
-					break;
-				}
-
-				break;
-			}
-		}
+		SetLayerValues(OldValues, NewValues);
 
 		SetHealing(0.0f);
 	}
@@ -187,14 +249,15 @@ void UHealthAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 	 */
 	else if (Data.EvaluatedData.Attribute == GetHealingShieldAttribute())
 	{
-		auto HealRemaing{ Data.EvaluatedData.Magnitude };
+		INC_DWORD_STAT(STAT_GAHA_HealEvents);
+		GAHA_TELEMETRY_INC(HealApplications);
 
-		// Skip if healing amount is less than 0
+		const auto OldValues{ GetAttributeValues() };
+		auto NewValues{ OldValues };
 
-		if (HealRemaing > 0)
-		{
-			SetShield(FMath::Min(GetMaxShield(), GetShield() + HealRemaing));
-		}
+		FHealthAttributeMath::ApplyHealingShield(NewValues, Data.EvaluatedData.Magnitude);
+
+		SetLayerValues(OldValues, NewValues);
 
 		SetHealingShield(0.0f);
 	}
@@ -206,7 +269,7 @@ void UHealthAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 	 */
 	else if (Data.EvaluatedData.Attribute == GetHealthAttribute())
 	{
-		SetHealth(FMath::Clamp(GetHealth(), GetMinHealth(), GetMaxHealth()));
+		SetHealth(FHealthAttributeMath::ClampValue(GetAttributeValues(), EHealthAttribute::Health, GetHealth()));
 	}
 
 	/**
@@ -216,29 +279,71 @@ void UHealthAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 	 */
 	else if (Data.EvaluatedData.Attribute == GetShieldAttribute())
 	{
-		SetShield(FMath::Clamp(GetShield(), 0.0f, GetMaxShield()));
+		SetShield(FHealthAttributeMath::ClampValue(GetAttributeValues(), EHealthAttribute::Shield, GetShield()));
 	}
 
 	//  If Health is less than 0.0, Death is indicated.
 
-	if ((Data.EvaluatedData.Attribute == GetHealthAttribute()) ||
-		(Data.EvaluatedData.Attribute == GetDamageAttribute()))
+	const auto bAffectsHealth{ (Data.EvaluatedData.Attribute == GetHealthAttribute()) || (Data.EvaluatedData.Attribute == GetDamageAttribute()) };
+	const auto bNotifiedOutOfHealth{ bAffectsHealth && FHealthAttributeMath::UpdateOutOfHealth(GetHealth(), bOutOfHealth) };
+
+	// Recorded before the out of health delegates, which can execute other modifiers on this set
+
+	RecordGameplayEffectExecute(Data, bFromExecution, bNotifiedOutOfHealth, bBrokeShield);
+
+	if (bNotifiedOutOfHealth)
 	{
-		const auto bIsZeroHealth{ GetHealth() <= 0.0f };
+		if (OnOutOfHealth.IsBound())
+		{
+			const auto& EffectContext{ Data.EffectSpec.GetEffectContext() };
+			auto* Instigator{ EffectContext.GetOriginalInstigator() };
+			auto* Causer{ EffectContext.GetEffectCauser() };
 
-		if (bIsZeroHealth && !bOutOfHealth)
+			OnOutOfHealth.Broadcast(Instigator, Causer, Data.EffectSpec, Data.EvaluatedData.Magnitude);
+		}
+	}
+	else if (bOutOfHealth && (Data.EvaluatedData.Attribute == GetDamageAttribute()) && (DamageToHealth > 0.0f))
+	{
+		if (OnDamagedOutOfHealth.IsBound())
 		{
-			if (OnOutOfHealth.IsBound())
-			{
-				const auto& EffectContext{ Data.EffectSpec.GetEffectContext() };
-				auto* Instigator{ EffectContext.GetOriginalInstigator() };
-				auto* Causer{ EffectContext.GetEffectCauser() };
+			const auto& EffectContext{ Data.EffectSpec.GetEffectContext() };
+			auto* Instigator{ EffectContext.GetOriginalInstigator() };
+			auto* Causer{ EffectContext.GetEffectCauser() };
 
-				OnOutOfHealth.Broadcast(Instigator, Causer, Data.EffectSpec, Data.EvaluatedData.Magnitude);
-			}
+			OnDamagedOutOfHealth.Broadcast(Instigator, Causer, Data.EffectSpec, DamageToHealth);
 		}
+	}
+}
+
+void UHealthAttributeSet::RecordGameplayEffectExecute(const FGameplayEffectModCallbackData& Data, bool bFromExecution, bool bNotifiedOutOfHealth, bool bBrokeShield) const
+{
+	// Damage type is resolved once for the combat log and the hit confirms
+
+	const auto bRecordCombatLog{ GAHACombatLog::IsEnabled() };
+	const auto bRecordHitConfirm{ UHealthHitConfirmComponent::IsAnyCollecting() && (Data.EvaluatedData.Attribute == GetDamageAttribute()) };
+	const auto DamageType{ (bRecordCombatLog || bRecordHitConfirm) ? GetDamageTypeTag(Data.EffectSpec) : FGameplayTag() };
+
+	if (bRecordCombatLog)
+	{
+		auto Flags{ EHealthCombatLogFlags::None };
+		Flags |= bNotifiedOutOfHealth ? EHealthCombatLogFlags::OutOfHealth : EHealthCombatLogFlags::None;
+		Flags |= bFromExecution ? EHealthCombatLogFlags::FromExecution : EHealthCombatLogFlags::None;
+
+		RecordCombatLogEvent(this, Data, DamageType, Flags);
+	}
+
+	if (bRecordHitConfirm)
+	{
+		// Downed and killed are recorded by the health component when they actually happen
+
+		const auto Flags{ bBrokeShield ? EHealthHitConfirmFlags::ShieldBroken : EHealthHitConfirmFlags::None };
 
-		bOutOfHealth = bIsZeroHealth;
+		UHealthHitConfirmComponent::RecordDamage(this, Data, Flags, DamageType);
+	}
+
+	if (GAHAHealthStream::IsRecording())
+	{
+		GAHAHealthStream::RecordExecute(this, Data.EvaluatedData.Attribute, Data.EvaluatedData.Magnitude, bNotifiedOutOfHealth);
 	}
 }
 
@@ -249,6 +354,13 @@ void UHealthAttributeSet::PreAttributeBaseChange(const FGameplayAttribute& Attri
 	ClampAttribute(Attribute, NewValue);
 }
 
+void UHealthAttributeSet::PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const
+{
+	Super::PostAttributeBaseChange(Attribute, OldValue, NewValue);
+
+	MarkAttributeDirty(Attribute, true);
+}
+
 void UHealthAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue)
 {
 	Super::PreAttributeChange(Attribute, NewValue);
@@ -260,141 +372,226 @@ void UHealthAttributeSet::PostAttributeChange(const FGameplayAttribute& Attribut
 {
 	Super::PostAttributeChange(Attribute, OldValue, NewValue);
 
+	MarkAttributeDirty(Attribute, false);
+
 	/**
-	 * Attribute [MaxHealth]
+	 * Attribute [MaxHealth] [MaxShield]
 	 *
-	 * Clamp Health Value
+	 * Clamp Health or Shield Value
 	 */
-	if (Attribute == GetMaxHealthAttribute())
+	auto Dependent{ EHealthAttribute::MAX };
+	auto DependentValue{ 0.0f };
+
+	if (FHealthAttributeMath::GetDependentClamp(GetAttributeValues(), ToHealthAttribute(Attribute), Dependent, DependentValue))
 	{
-		if (GetHealth() > GetMaxHealth())
-		{
-			auto* ASC{ GetAbilitySystemComponent<UAbilitySystemComponent>() };
-			check(ASC);
+		auto* ASC{ GetAbilitySystemComponent<UAbilitySystemComponent>() };
+		check(ASC);
 
-			ASC->ApplyModToAttribute(GetHealthAttribute(), EGameplayModOp::Override, GetMaxHealth());
-		}
+		ASC->ApplyModToAttribute(ToGameplayAttribute(Dependent), EGameplayModOp::Override, DependentValue);
 	}
 
-	/**
-	 * Attribute [MaxShield]
-	 *
-	 * Clamp Shield Value
-	 */
-	if (Attribute == GetMaxShieldAttribute())
+	// If Health exceeds 0 after application, remove flag
+
+	FHealthAttributeMath::ResetOutOfHealth(GetHealth(), bOutOfHealth);
+}
+
+FHealthAttributeValues UHealthAttributeSet::GetAttributeValues() const
+{
+	FHealthAttributeValues Values;
+	Values.Health = GetHealth();
+	Values.MinHealth = GetMinHealth();
+	Values.MaxHealth = GetMaxHealth();
+	Values.ExtraHealth = GetExtraHealth();
+	Values.Shield = GetShield();
+	Values.MaxShield = GetMaxShield();
+	Values.DamageResistance = GetDamageResistance();
+
+	return Values;
+}
+
+EHealthAttribute UHealthAttributeSet::ToHealthAttribute(const FGameplayAttribute& Attribute)
+{
+	if (Attribute == GetHealthAttribute())				return EHealthAttribute::Health;
+	if (Attribute == GetMinHealthAttribute())			return EHealthAttribute::MinHealth;
+	if (Attribute == GetMaxHealthAttribute())			return EHealthAttribute::MaxHealth;
+	if (Attribute == GetExtraHealthAttribute())			return EHealthAttribute::ExtraHealth;
+	if (Attribute == GetShieldAttribute())				return EHealthAttribute::Shield;
+	if (Attribute == GetMaxShieldAttribute())			return EHealthAttribute::MaxShield;
+	if (Attribute == GetDamageResistanceAttribute())	return EHealthAttribute::DamageResistance;
+
+	return EHealthAttribute::MAX;
+}
+
+FGameplayAttribute UHealthAttributeSet::ToGameplayAttribute(EHealthAttribute Attribute)
+{
+	switch (Attribute)
 	{
-		if (GetShield() > GetMaxShield())
-		{
-			auto* ASC{ GetAbilitySystemComponent<UAbilitySystemComponent>() };
-			check(ASC);
+	case EHealthAttribute::Health:				return GetHealthAttribute();
+	case EHealthAttribute::MinHealth:			return GetMinHealthAttribute();
+	case EHealthAttribute::MaxHealth:			return GetMaxHealthAttribute();
+	case EHealthAttribute::ExtraHealth:			return GetExtraHealthAttribute();
+	case EHealthAttribute::Shield:				return GetShieldAttribute();
+	case EHealthAttribute::MaxShield:			return GetMaxShieldAttribute();
+	case EHealthAttribute::DamageResistance:	return GetDamageResistanceAttribute();
+	default:									return FGameplayAttribute();
+	}
+}
 
-			ASC->ApplyModToAttribute(GetShieldAttribute(), EGameplayModOp::Override, GetMaxShield());
-		}
+void UHealthAttributeSet::SetLayerValues(const FHealthAttributeValues& OldValues, const FHealthAttributeValues& NewValues)
+{
+	// Only set changed layers, in the order they are consumed by damage
+
+	if (NewValues.ExtraHealth != OldValues.ExtraHealth)
+	{
+		SetExtraHealth(NewValues.ExtraHealth);
 	}
 
-	// If Health exceeds 0 after application, remove flag
+	if (NewValues.Shield != OldValues.Shield)
+	{
+		SetShield(NewValues.Shield);
+	}
 
-	if (bOutOfHealth && (GetHealth() > 0.0f))
+	if (NewValues.Health != OldValues.Health)
 	{
-		bOutOfHealth = false;
+		SetHealth(NewValues.Health);
 	}
 }
 
 void UHealthAttributeSet::ClampAttribute(const FGameplayAttribute& Attribute, float& NewValue) const
 {
-	/**
-	 * Attribute [Health]
-	 *
-	 * Clamp Health Value
-	 */
-	if (Attribute == GetHealthAttribute())
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_ClampAttribute);
+
+	const auto HealthAttribute{ ToHealthAttribute(Attribute) };
+
+	if (HealthAttribute != EHealthAttribute::MAX)
 	{
-		NewValue = FMath::Clamp(NewValue, GetMinHealth(), GetMaxHealth());
+		NewValue = FHealthAttributeMath::ClampValue(GetAttributeValues(), HealthAttribute, NewValue);
 	}
+}
 
-	/**
-	 * Attribute [MaxHealth]
-	 *
-	 * Clamp MaxHealth Value
-	 */
-	else if (Attribute == GetMaxHealthAttribute())
+void UHealthAttributeSet::MarkAttributeDirty(const FGameplayAttribute& Attribute, bool bBaseValue) const
+{
+	auto AttributeIndex{ INDEX_NONE };
+
+	if (Attribute == GetHealthAttribute())
 	{
-		NewValue = FMath::Max(NewValue, 1.0f);
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, Health, this);
+		AttributeIndex = 0;
 	}
-
-	/**
-	 * Attribute [MinHealth]
-	 *
-	 * Clamp MinHealth Value
-	 */
 	else if (Attribute == GetMinHealthAttribute())
 	{
-		NewValue = FMath::Clamp(NewValue, 0.0f, GetMaxHealth());
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, MinHealth, this);
+		AttributeIndex = 1;
+	}
+	else if (Attribute == GetMaxHealthAttribute())
+	{
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, MaxHealth, this);
+		AttributeIndex = 2;
 	}
-
-	/**
-	 * Attribute [ExtraHealth]
-	 *
-	 * Clamp ExtraHealth Value
-	 */
 	else if (Attribute == GetExtraHealthAttribute())
 	{
-		NewValue = FMath::Max(NewValue, 0.0f);
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, ExtraHealth, this);
+		AttributeIndex = 3;
 	}
-
-	/**
-	 * Attribute [Shield]
-	 *
-	 * Clamp Shield Value
-	 */
 	else if (Attribute == GetShieldAttribute())
 	{
-		NewValue = FMath::Clamp(NewValue, 0.0f, GetMaxShield());
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, Shield, this);
+		AttributeIndex = 4;
 	}
-	
-	/**
-	 * Attribute [MaxShield]
-	 *
-	 * Clamp MaxShield Value
-	 */
 	else if (Attribute == GetMaxShieldAttribute())
 	{
-		NewValue = FMath::Max(NewValue, 0.0f);
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, MaxShield, this);
+		AttributeIndex = 5;
+	}
+	else if (Attribute == GetDamageResistanceAttribute())
+	{
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, DamageResistance, this);
+		AttributeIndex = 6;
+	}
+
+	// Meta attributes are not replicated
+
+	if (AttributeIndex != INDEX_NONE)
+	{
+		RecordReplicatedValue(AttributeIndex, bBaseValue);
+	}
+}
+
+void UHealthAttributeSet::RecordReplicatedValue(int32 AttributeIndex, bool bBaseValue) const
+{
+	// Only counted where the attributes are replicated from
+
+	const auto* OwningActor{ GetOwningActor() };
+	if (!OwningActor || !OwningActor->HasAuthority())
+	{
+		return;
+	}
+
+	// A value is sent at most once per net update, which happens at most once per frame.
+	// Base and current values are separate replicated floats of FGameplayAttributeData.
+
+	if (ReplicatedValuesFrame != GFrameCounter)
+	{
+		ReplicatedValuesFrame = GFrameCounter;
+		ReplicatedValuesMask = 0;
+	}
+
+	const auto ValueBit{ static_cast<uint16>(1 << ((AttributeIndex * 2) + (bBaseValue ? 1 : 0))) };
+
+	if ((ReplicatedValuesMask & ValueBit) == 0)
+	{
+		ReplicatedValuesMask |= ValueBit;
+
+		GAHA_TELEMETRY_ADD(ReplicatedBytes, sizeof(float));
 	}
 }
 
 
 void UHealthAttributeSet::OnRep_Health(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(Health);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, Health, OldValue);
 }
 
 void UHealthAttributeSet::OnRep_MinHealth(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(MinHealth);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, MinHealth, OldValue);
 }
 
 void UHealthAttributeSet::OnRep_MaxHealth(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(MaxHealth);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, MaxHealth, OldValue);
 }
 
 void UHealthAttributeSet::OnRep_ExtraHealth(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(ExtraHealth);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, ExtraHealth, OldValue);
 }
 
 void UHealthAttributeSet::OnRep_Shield(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(Shield);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, Shield, OldValue);
 }
 
 void UHealthAttributeSet::OnRep_MaxShield(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(MaxShield);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, MaxShield, OldValue);
 }
 
 void UHealthAttributeSet::OnRep_DamageResistance(const FGameplayAttributeData& OldValue)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(DamageResistance);
+
 	GAMEPLAYATTRIBUTE_REPNOTIFY(UHealthAttributeSet, DamageResistance, OldValue);
 }
@@ -6,6 +6,8 @@
 
 #include "AbilitySystemComponent.h"
 
+#include "HealthAttributeMath.h"
+
 #include "HealthAttributeSet.generated.h"
 
 
@@ -13,7 +15,7 @@
  * Classes that define attributes such as character health, shields, max strength, max shields, etc.
  */
 UCLASS(BlueprintType)
-class UHealthAttributeSet : public UGAEAttributeSet
+class GAHADDON_API UHealthAttributeSet : public UGAEAttributeSet
 {
 	GENERATED_BODY()
 public:
@@ -26,6 +28,7 @@ protected:
 	virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
 
 	virtual void PreAttributeBaseChange(const FGameplayAttribute& Attribute, float& NewValue) const override;
+	virtual void PostAttributeBaseChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) const override;
 	virtual void PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue) override;
 	virtual void PostAttributeChange(const FGameplayAttribute& Attribute, float OldValue, float NewValue) override;
 
@@ -34,6 +37,47 @@ protected:
 	 */
 	void ClampAttribute(const FGameplayAttribute& Attribute, float& NewValue) const;
 
+	/**
+	 * Mark the replicated property of the attribute dirty for push model replication
+	 */
+	void MarkAttributeDirty(const FGameplayAttribute& Attribute, bool bBaseValue) const;
+
+	/**
+	 * Count the replicated value towards the ReplicatedBytes telemetry, at most once per frame
+	 */
+	void RecordReplicatedValue(int32 AttributeIndex, bool bBaseValue) const;
+
+	/**
+	 * Set the layers (ExtraHealth, Shield, Health) that differ from the old values
+	 */
+	void SetLayerValues(const FHealthAttributeValues& OldValues, const FHealthAttributeValues& NewValues);
+
+	/**
+	 * Returns false for PreGameplayEffectExecute, recording the rejection of an execution output in the combat log
+	 */
+	bool RejectGameplayEffectExecute(const FGameplayEffectModCallbackData& Data);
+
+	/**
+	 * Record the executed modifier to the combat log, the hit confirms and the health stream
+	 */
+	void RecordGameplayEffectExecute(const FGameplayEffectModCallbackData& Data, bool bFromExecution, bool bNotifiedOutOfHealth, bool bBrokeShield) const;
+
+public:
+	/**
+	 * Returns the current values of the stateful attributes
+	 */
+	FHealthAttributeValues GetAttributeValues() const;
+
+	/**
+	 * Returns the stateful attribute matching the gameplay attribute, or MAX for meta attributes
+	 */
+	static EHealthAttribute ToHealthAttribute(const FGameplayAttribute& Attribute);
+
+	/**
+	 * Returns the gameplay attribute of the stateful attribute
+	 */
+	static FGameplayAttribute ToGameplayAttribute(EHealthAttribute Attribute);
+
 
 public:
 	//
@@ -41,12 +85,29 @@ public:
 	//
 	mutable FAttributeEvent OnOutOfHealth;
 
+	//
+	// Delegate to broadcast when damage is received while already out of health, e.g. to finish off a downed actor.
+	// The magnitude is the damage left after ExtraHealth and Shield.
+	//
+	mutable FAttributeEvent OnDamagedOutOfHealth;
+
 private:
 	//
 	// Used to track when the health reaches 0.
 	//
 	bool bOutOfHealth{ false };
 
+	//
+	// Whether the modifier being executed is the output of an execution recorded in the combat log
+	//
+	bool bExecutionOutput{ false };
+
+	//
+	// Replicated values changed during ReplicatedValuesFrame, one bit per attribute and base or current value
+	//
+	mutable uint16 ReplicatedValuesMask{ 0 };
+	mutable uint64 ReplicatedValuesFrame{ 0 };
+
 public:
 	ATTRIBUTE_ACCESSORS(UHealthAttributeSet, Health);
 	ATTRIBUTE_ACCESSORS(UHealthAttributeSet, MinHealth);
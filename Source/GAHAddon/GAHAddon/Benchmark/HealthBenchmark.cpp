@@ -0,0 +1,82 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthBenchmark.h"
+
+#if GAHA_WITH_BENCHMARK
+
+namespace GAHABenchmark
+{
+	bool bCapturing{ false };
+
+	static uint64 PhaseCycles[static_cast<int32>(EHealthBenchmarkPhase::MAX)]{ 0 };
+	static int64 RepNotifyCounts[static_cast<int32>(EHealthBenchmarkRepProperty::MAX)]{ 0 };
+
+
+	void AddPhaseCycles(EHealthBenchmarkPhase Phase, uint64 Cycles)
+	{
+		PhaseCycles[static_cast<int32>(Phase)] += Cycles;
+	}
+
+	void ResetPhases()
+	{
+		for (auto& Cycles : PhaseCycles)
+		{
+			Cycles = 0;
+		}
+	}
+
+	double GetPhaseMilliseconds(EHealthBenchmarkPhase Phase)
+	{
+		return FPlatformTime::ToMilliseconds64(PhaseCycles[static_cast<int32>(Phase)]);
+	}
+
+	const TCHAR* GetPhaseName(EHealthBenchmarkPhase Phase)
+	{
+		switch (Phase)
+		{
+		case EHealthBenchmarkPhase::Execution:		return TEXT("Execution");
+		case EHealthBenchmarkPhase::PreExecute:		return TEXT("PreExecute");
+		case EHealthBenchmarkPhase::PostExecute:	return TEXT("PostExecute");
+		case EHealthBenchmarkPhase::Notification:	return TEXT("Notification");
+		case EHealthBenchmarkPhase::Death:			return TEXT("Death");
+		default:									return TEXT("Unknown");
+		}
+	}
+
+
+	void AddRepNotify(EHealthBenchmarkRepProperty Property)
+	{
+		++RepNotifyCounts[static_cast<int32>(Property)];
+	}
+
+	void ResetRepNotifies()
+	{
+		for (auto& Count : RepNotifyCounts)
+		{
+			Count = 0;
+		}
+	}
+
+	int64 GetRepNotifyCount(EHealthBenchmarkRepProperty Property)
+	{
+		return RepNotifyCounts[static_cast<int32>(Property)];
+	}
+
+	const TCHAR* GetRepPropertyName(EHealthBenchmarkRepProperty Property)
+	{
+		switch (Property)
+		{
+		case EHealthBenchmarkRepProperty::Health:			return TEXT("Health");
+		case EHealthBenchmarkRepProperty::MinHealth:		return TEXT("MinHealth");
+		case EHealthBenchmarkRepProperty::MaxHealth:		return TEXT("MaxHealth");
+		case EHealthBenchmarkRepProperty::ExtraHealth:		return TEXT("ExtraHealth");
+		case EHealthBenchmarkRepProperty::Shield:			return TEXT("Shield");
+		case EHealthBenchmarkRepProperty::MaxShield:		return TEXT("MaxShield");
+		case EHealthBenchmarkRepProperty::DamageResistance:	return TEXT("DamageResistance");
+		case EHealthBenchmarkRepProperty::DeathState:		return TEXT("DeathState");
+		default:											return TEXT("Unknown");
+		}
+	}
+}
+
+#endif // #if GAHA_WITH_BENCHMARK
@@ -0,0 +1,112 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "HAL/PlatformTime.h"
+
+#include "GAHAddonStats.h"
+
+
+#if !UE_BUILD_SHIPPING
+#define GAHA_WITH_BENCHMARK 1
+#else
+#define GAHA_WITH_BENCHMARK 0
+#endif
+
+
+/**
+ * Phases of the damage and heal pipeline measured by the benchmark
+ */
+enum class EHealthBenchmarkPhase : uint8
+{
+	Execution,		// Damage and heal executions
+	PreExecute,		// UHealthAttributeSet::PreGameplayEffectExecute
+	PostExecute,	// UHealthAttributeSet::PostGameplayEffectExecute
+	Notification,	// Attribute change handlers and damage / heal notifications of UHealthComponent
+	Death,			// Out of health handling and death transitions
+	MAX
+};
+
+
+/**
+ * Replicated health properties whose rep notifies are counted by the replication benchmark
+ */
+enum class EHealthBenchmarkRepProperty : uint8
+{
+	Health,
+	MinHealth,
+	MaxHealth,
+	ExtraHealth,
+	Shield,
+	MaxShield,
+	DamageResistance,
+	DeathState,
+	MAX
+};
+
+
+#if GAHA_WITH_BENCHMARK
+
+/**
+ * Per phase timers of the damage and heal pipeline, accumulated only while a benchmark is capturing.
+ * 
+ * Tips:
+ *	The pipeline runs on the game thread, so the timers are not synchronized.
+ *	Phases are inclusive, e.g. Death is also part of the PostExecute that caused it.
+ */
+namespace GAHABenchmark
+{
+	extern GAHADDON_API bool bCapturing;
+
+	GAHADDON_API void AddPhaseCycles(EHealthBenchmarkPhase Phase, uint64 Cycles);
+	GAHADDON_API void ResetPhases();
+	GAHADDON_API double GetPhaseMilliseconds(EHealthBenchmarkPhase Phase);
+	GAHADDON_API const TCHAR* GetPhaseName(EHealthBenchmarkPhase Phase);
+
+	/**
+	 * Rep notify counters, accumulated on every client in the process while a benchmark is capturing
+	 */
+	GAHADDON_API void AddRepNotify(EHealthBenchmarkRepProperty Property);
+	GAHADDON_API void ResetRepNotifies();
+	GAHADDON_API int64 GetRepNotifyCount(EHealthBenchmarkRepProperty Property);
+	GAHADDON_API const TCHAR* GetRepPropertyName(EHealthBenchmarkRepProperty Property);
+
+	struct FScopedPhase
+	{
+	public:
+		explicit FScopedPhase(EHealthBenchmarkPhase InPhase)
+			: Phase(InPhase)
+			, StartCycles(bCapturing ? FPlatformTime::Cycles64() : 0)
+		{
+		}
+
+		~FScopedPhase()
+		{
+			if (StartCycles != 0)
+			{
+				AddPhaseCycles(Phase, FPlatformTime::Cycles64() - StartCycles);
+			}
+		}
+
+	private:
+		EHealthBenchmarkPhase Phase;
+		uint64 StartCycles;
+	};
+}
+
+#define GAHA_BENCHMARK_PHASE(Phase) GAHABenchmark::FScopedPhase ANONYMOUS_VARIABLE(GAHABenchmarkPhase_)(EHealthBenchmarkPhase::Phase)
+#define GAHA_BENCHMARK_REP_NOTIFY(Property) do { if (GAHABenchmark::bCapturing) { GAHABenchmark::AddRepNotify(EHealthBenchmarkRepProperty::Property); } } while (0)
+
+#else
+
+#define GAHA_BENCHMARK_PHASE(Phase)
+#define GAHA_BENCHMARK_REP_NOTIFY(Property)
+
+#endif
+
+/**
+ * Scope of a GAHA cycle stat that is also measured as a phase by the benchmark
+ */
+#define GAHA_SCOPE_PHASE_CYCLE_COUNTER(Phase, Stat) \
+	GAHA_BENCHMARK_PHASE(Phase); \
+	GAHA_SCOPE_CYCLE_COUNTER(Stat)
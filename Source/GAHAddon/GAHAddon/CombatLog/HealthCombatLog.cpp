@@ -0,0 +1,433 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthCombatLog.h"
+
+#include "GameplayTag/GAHATags_Damage.h"
+#include "GAHAddonLogs.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameplayEffectExecutionCalculation.h"
+#include "AbilitySystemComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "Containers/Queue.h"
+#include "UObject/ObjectKey.h"
+
+
+namespace GAHACombatLog
+{
+	bool bEnabled{ false };
+
+	static TAutoConsoleVariable<int32> CVarMaxQueuedBytes(
+		TEXT("GAHA.CombatLog.MaxQueuedBytes"),
+		16 * 1024 * 1024,
+		TEXT("Bytes of combat log frames waiting to be written above which new frames are dropped."));
+
+	/**
+	 * Buffer of a frame or a request to start a new file, processed in order by the writer thread
+	 */
+	struct FWriteCommand
+	{
+		TArray<uint8> Data;
+		FString NewFilePath;
+	};
+
+	/**
+	 * Background thread writing the combat log frames to disk
+	 */
+	class FWriter : public FRunnable
+	{
+	public:
+		FWriter()
+		{
+			WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+			Thread = FRunnableThread::Create(this, TEXT("GAHACombatLogWriter"), 0, TPri_BelowNormal);
+		}
+
+		virtual ~FWriter()
+		{
+			if (Thread)
+			{
+				Thread->Kill(true);
+				delete Thread;
+			}
+
+			FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		}
+
+		virtual uint32 Run() override
+		{
+			while (!bStopping)
+			{
+				WakeEvent->Wait();
+				ProcessCommands();
+			}
+
+			ProcessCommands();
+			CloseFile();
+
+			return 0;
+		}
+
+		virtual void Stop() override
+		{
+			bStopping = true;
+			WakeEvent->Trigger();
+		}
+
+		/**
+		 * Queue a command from the game thread. Frames are dropped when too many bytes are already queued.
+		 */
+		bool Enqueue(FWriteCommand&& Command)
+		{
+			const auto NumBytes{ static_cast<int64>(Command.Data.Num()) };
+
+			if (Command.NewFilePath.IsEmpty() && (QueuedBytes.load() + NumBytes > CVarMaxQueuedBytes.GetValueOnGameThread()))
+			{
+				return false;
+			}
+
+			QueuedBytes += NumBytes;
+			Commands.Enqueue(MoveTemp(Command));
+			WakeEvent->Trigger();
+
+			return true;
+		}
+
+		/**
+		 * Returns a written buffer to reuse its allocation on the game thread
+		 */
+		bool DequeueFreeBuffer(TArray<uint8>& OutBuffer)
+		{
+			return FreeBuffers.Dequeue(OutBuffer);
+		}
+
+	private:
+		void ProcessCommands()
+		{
+			FWriteCommand Command;
+
+			while (Commands.Dequeue(Command))
+			{
+				if (!Command.NewFilePath.IsEmpty())
+				{
+					OpenFile(Command.NewFilePath);
+				}
+
+				if (!Command.Data.IsEmpty())
+				{
+					if (File)
+					{
+						File->Write(Command.Data.GetData(), Command.Data.Num());
+					}
+
+					QueuedBytes -= Command.Data.Num();
+
+					Command.Data.Reset();
+					FreeBuffers.Enqueue(MoveTemp(Command.Data));
+				}
+			}
+
+			if (File)
+			{
+				File->Flush();
+			}
+		}
+
+		void OpenFile(const FString& FilePath)
+		{
+			CloseFile();
+
+			auto& PlatformFile{ FPlatformFileManager::Get().GetPlatformFile() };
+			PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+			File = PlatformFile.OpenWrite(*FilePath);
+			if (!File)
+			{
+				UE_LOG(LogGAHA, Error, TEXT("GAHACombatLog: Failed to open %s"), *FilePath);
+			}
+		}
+
+		void CloseFile()
+		{
+			delete File;
+			File = nullptr;
+		}
+
+	private:
+		FRunnableThread* Thread{ nullptr };
+		FEvent* WakeEvent{ nullptr };
+		std::atomic<bool> bStopping{ false };
+		std::atomic<int64> QueuedBytes{ 0 };
+
+		TQueue<FWriteCommand, EQueueMode::Spsc> Commands;
+		TQueue<TArray<uint8>, EQueueMode::Spsc> FreeBuffers;
+
+		IFileHandle* File{ nullptr };
+	};
+
+	static TUniquePtr<FWriter> Writer;
+
+	static TArray<uint8> FrameBuffer;
+	static int32 NumFrameRecords{ 0 };
+	static int64 NumDroppedRecords{ 0 };
+
+	static TMap<FObjectKey, uint32> ActorIds;
+	static TMap<FName, uint32> TagIds;
+	static uint32 NextId{ 1 };
+
+	static FObjectKey PendingExecutionTarget;
+
+	static FDelegateHandle EndFrameHandle;
+	static FDelegateHandle WorldInitializedActorsHandle;
+
+
+	static void AppendRecord(const FHealthCombatLogRecord& Record)
+	{
+		FrameBuffer.Append(reinterpret_cast<const uint8*>(&Record), sizeof(FHealthCombatLogRecord));
+	}
+
+	static uint32 AppendName(const FString& Name)
+	{
+		const auto Id{ NextId++ };
+		const auto Utf8Name{ StringCast<UTF8CHAR>(*Name) };
+		const auto NameLength{ static_cast<uint16>(FMath::Min(Utf8Name.Length(), static_cast<int32>(MAX_uint16))) };
+
+		FHealthCombatLogRecord Record;
+		Record.Type = EHealthCombatLogEventType::Name;
+		Record.TargetId = Id;
+		Record.NameLength = NameLength;
+		AppendRecord(Record);
+
+		FrameBuffer.Append(reinterpret_cast<const uint8*>(Utf8Name.Get()), NameLength);
+		FrameBuffer.AddZeroed(Align(NameLength, 8) - NameLength);
+
+		return Id;
+	}
+
+	static uint32 GetActorId(const AActor* Actor)
+	{
+		if (!Actor)
+		{
+			return 0;
+		}
+
+		if (const auto* Id{ ActorIds.Find(Actor) })
+		{
+			return *Id;
+		}
+
+		return ActorIds.Add(Actor, AppendName(Actor->GetName()));
+	}
+
+	static uint32 GetTagId(const FGameplayTag& Tag)
+	{
+		if (!Tag.IsValid())
+		{
+			return 0;
+		}
+
+		if (const auto* Id{ TagIds.Find(Tag.GetTagName()) })
+		{
+			return *Id;
+		}
+
+		return TagIds.Add(Tag.GetTagName(), AppendName(Tag.ToString()));
+	}
+
+	void RecordEvent(EHealthCombatLogEventType Type, const AActor* Target, const AActor* Instigator, const AActor* Causer, const FGameplayTag& Tag, float Magnitude, float TotalHealthAfter, EHealthCombatLogFlags Flags)
+	{
+		if (!Writer.IsValid())
+		{
+			return;
+		}
+
+		FHealthCombatLogRecord Record;
+		Record.Time = (Target && Target->GetWorld()) ? Target->GetWorld()->GetTimeSeconds() : 0.0;
+		Record.Frame = static_cast<uint32>(GFrameCounter);
+		Record.Type = Type;
+		Record.Flags = Flags;
+		Record.TargetId = GetActorId(Target);
+		Record.InstigatorId = GetActorId(Instigator);
+		Record.CauserId = GetActorId(Causer);
+		Record.TagId = GetTagId(Tag);
+		Record.Magnitude = Magnitude;
+		Record.TotalHealthAfter = TotalHealthAfter;
+
+		AppendRecord(Record);
+		++NumFrameRecords;
+	}
+
+	void RecordExecutionInput(EHealthCombatLogEventType Type, const FGameplayEffectCustomExecutionParameters& ExecutionParams, float BaseMagnitude, bool bHasOutput)
+	{
+		PendingExecutionTarget = FObjectKey();
+
+		const auto* TargetASC{ ExecutionParams.GetTargetAbilitySystemComponent() };
+		const auto* Target{ TargetASC ? TargetASC->GetAvatarActor() : nullptr };
+
+		if (!Target || !Target->HasAuthority())
+		{
+			return;
+		}
+
+		const auto& Spec{ ExecutionParams.GetOwningSpec() };
+		const auto& EffectContext{ Spec.GetEffectContext() };
+
+		RecordEvent(Type, Target, EffectContext.GetOriginalInstigator(), EffectContext.GetEffectCauser(), GetDamageTypeTag(Spec), BaseMagnitude, 0.0f);
+
+		// The output modifier is executed right after the execution
+
+		if (bHasOutput)
+		{
+			PendingExecutionTarget = FObjectKey(Target);
+		}
+	}
+
+	bool ConsumeExecutionOutput(const AActor* Target)
+	{
+		const auto bIsOutput{ (PendingExecutionTarget != FObjectKey()) && (PendingExecutionTarget == FObjectKey(Target)) };
+
+		PendingExecutionTarget = FObjectKey();
+
+		return bIsOutput;
+	}
+
+	static void FlushFrame()
+	{
+		if (!Writer.IsValid() || FrameBuffer.IsEmpty())
+		{
+			return;
+		}
+
+		FWriteCommand Command;
+		Command.Data = MoveTemp(FrameBuffer);
+
+		if (!Writer->Enqueue(MoveTemp(Command)))
+		{
+			// Names interned in the dropped frame must be written again
+
+			NumDroppedRecords += NumFrameRecords;
+			ActorIds.Reset();
+			TagIds.Reset();
+		}
+
+		NumFrameRecords = 0;
+
+		// Reuse a buffer already written by the writer to avoid allocating every frame
+
+		FrameBuffer.Reset();
+		Writer->DequeueFreeBuffer(FrameBuffer);
+	}
+
+	void Rotate(const FString& MatchName)
+	{
+		if (!Writer.IsValid())
+		{
+			return;
+		}
+
+		FlushFrame();
+
+		ActorIds.Reset();
+		TagIds.Reset();
+		NextId = 1;
+
+		const auto Now{ FDateTime::UtcNow() };
+		const auto FilePath{ FPaths::ProfilingDir() / TEXT("GAHA") / TEXT("CombatLog") / FString::Printf(TEXT("%s_%s.gahalog"), *MatchName, *Now.ToString()) };
+
+		FWriteCommand Command;
+		Command.NewFilePath = FilePath;
+
+		FHealthCombatLogFileHeader Header;
+		Header.StartUnixTime = Now.ToUnixTimestamp();
+		Command.Data.Append(reinterpret_cast<const uint8*>(&Header), sizeof(FHealthCombatLogFileHeader));
+
+		Writer->Enqueue(MoveTemp(Command));
+
+		UE_LOG(LogGAHA, Log, TEXT("GAHACombatLog: Started %s"), *FilePath);
+	}
+
+	int64 GetNumDroppedRecords()
+	{
+		return NumDroppedRecords;
+	}
+
+
+	static void HandleEndFrame()
+	{
+		FlushFrame();
+	}
+
+	static void HandleWorldInitializedActors(const FActorsInitializedParams& Params)
+	{
+		if (Params.World && Params.World->IsGameWorld() && (Params.World->GetNetMode() != NM_Client))
+		{
+			Rotate(Params.World->GetMapName());
+		}
+	}
+
+	static void SetEnabled(bool bNewEnabled)
+	{
+		if (bNewEnabled == Writer.IsValid())
+		{
+			return;
+		}
+
+		if (bNewEnabled)
+		{
+			Writer = MakeUnique<FWriter>();
+			Rotate(TEXT("Manual"));
+		}
+		else
+		{
+			FlushFrame();
+			Writer.Reset();
+
+			FrameBuffer.Empty();
+			ActorIds.Reset();
+			TagIds.Reset();
+		}
+
+		bEnabled = bNewEnabled;
+	}
+
+	static TAutoConsoleVariable<bool> CVarEnable(
+		TEXT("GAHA.CombatLog.Enable"),
+		false,
+		TEXT("Record damage, heal and death events on the server into binary combat log files."),
+		FConsoleVariableDelegate::CreateLambda(
+			[](IConsoleVariable* Variable)
+			{
+				SetEnabled(Variable->GetBool());
+			}));
+
+	static FAutoConsoleCommand RotateCommand(
+		TEXT("GAHA.CombatLog.Rotate"),
+		TEXT("Start a new combat log file. Usage: GAHA.CombatLog.Rotate [MatchName]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda(
+			[](const TArray<FString>& Args)
+			{
+				Rotate(Args.IsValidIndex(0) ? Args[0] : TEXT("Manual"));
+			}));
+
+
+	void Startup()
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&HandleEndFrame);
+		WorldInitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddStatic(&HandleWorldInitializedActors);
+	}
+
+	void Shutdown()
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		FWorldDelegates::OnWorldInitializedActors.Remove(WorldInitializedActorsHandle);
+
+		SetEnabled(false);
+	}
+}
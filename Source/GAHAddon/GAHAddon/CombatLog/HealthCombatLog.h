@@ -0,0 +1,129 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "GameplayTagContainer.h"
+
+struct FGameplayEffectCustomExecutionParameters;
+
+
+/**
+ * Types of the records in a combat log
+ */
+enum class EHealthCombatLogEventType : uint8
+{
+	Name,			// Interned name of an actor or a tag, followed by its UTF-8 characters
+	Damage,
+	Heal,
+	HealShield,
+	DeathStarted,
+	DeathFinished,
+	DamageInput,		// Base magnitude computed by UDamageExecution before its modifiers
+	HealInput,			// Base magnitude computed by UHealExecution before its modifiers
+	HealShieldInput,	// Base magnitude computed by UHealShieldExecution before its modifiers
+	MAX
+};
+
+
+/**
+ * Flags of the records in a combat log
+ */
+enum class EHealthCombatLogFlags : uint8
+{
+	None		= 0,
+	OutOfHealth		= 1 << 0,	// The event made the target run out of health
+	FromExecution	= 1 << 1,	// Output of the execution whose base magnitude was recorded by the preceding input record of the target
+	Rejected		= 1 << 2,	// The target rejected the execution output, e.g. by damage immunity or while downed, and it was not applied
+};
+ENUM_CLASS_FLAGS(EHealthCombatLogFlags);
+
+
+/**
+ * Fixed size record of a combat log file
+ *
+ * Tips:
+ *	Actors and tags are referenced by ids interned per file. The first reference to an id is preceded by a Name record
+ *	whose TargetId is the id and NameLength the byte length of the UTF-8 name that follows, padded to 8 bytes.
+ */
+struct FHealthCombatLogRecord
+{
+public:
+	double Time{ 0.0 };
+	uint32 Frame{ 0 };
+	EHealthCombatLogEventType Type{ EHealthCombatLogEventType::MAX };
+	EHealthCombatLogFlags Flags{ EHealthCombatLogFlags::None };
+	uint16 NameLength{ 0 };
+	uint32 TargetId{ 0 };
+	uint32 InstigatorId{ 0 };
+	uint32 CauserId{ 0 };
+	uint32 TagId{ 0 };
+	float Magnitude{ 0.0f };
+	float TotalHealthAfter{ 0.0f };
+
+};
+
+static_assert(sizeof(FHealthCombatLogRecord) == 40, "FHealthCombatLogRecord is part of the combat log file format");
+
+
+/**
+ * Header at the beginning of a combat log file
+ */
+struct FHealthCombatLogFileHeader
+{
+public:
+	static constexpr uint32 ExpectedMagic{ 0x4C484147 }; // "GAHL"
+	static constexpr uint32 CurrentVersion{ 3 };
+
+	uint32 Magic{ ExpectedMagic };
+	uint32 Version{ CurrentVersion };
+	int64 StartUnixTime{ 0 };
+
+};
+
+
+/**
+ * Binary combat log of the damage, heal and death events on the server
+ *
+ * Tips:
+ *	Enabled by "GAHA.CombatLog.Enable 1". Records are appended to a per frame buffer on the game thread and written
+ *	to <ProfilingDir>/GAHA/CombatLog by a background thread. Frames are dropped instead of queued once
+ *	"GAHA.CombatLog.MaxQueuedBytes" are waiting to be written.
+ *	A new file is started for every game world that initializes its actors, or by "GAHA.CombatLog.Rotate".
+ *	Files are read with FHealthCombatLogReader.
+ */
+namespace GAHACombatLog
+{
+	extern GAHADDON_API bool bEnabled;
+
+	FORCEINLINE bool IsEnabled() { return bEnabled; }
+
+	/**
+	 * Append an event to the current frame
+	 */
+	GAHADDON_API void RecordEvent(EHealthCombatLogEventType Type, const AActor* Target, const AActor* Instigator, const AActor* Causer, const FGameplayTag& Tag, float Magnitude, float TotalHealthAfter, EHealthCombatLogFlags Flags = EHealthCombatLogFlags::None);
+
+	/**
+	 * Append the base magnitude computed by an execution, so that replays can run the modifiers again.
+	 * When the execution has an output, the next modifier executed on the target is its output.
+	 */
+	GAHADDON_API void RecordExecutionInput(EHealthCombatLogEventType Type, const FGameplayEffectCustomExecutionParameters& ExecutionParams, float BaseMagnitude, bool bHasOutput);
+
+	/**
+	 * Returns whether the modifier being executed on the target is the output of the last recorded execution input.
+	 * Must be called before every modifier executed on a health attribute set.
+	 */
+	GAHADDON_API bool ConsumeExecutionOutput(const AActor* Target);
+
+	/**
+	 * Finish the current file and start a new one named after the match
+	 */
+	GAHADDON_API void Rotate(const FString& MatchName);
+
+	/**
+	 * Returns the number of records dropped because the writer could not keep up
+	 */
+	GAHADDON_API int64 GetNumDroppedRecords();
+
+	void Startup();
+	void Shutdown();
+}
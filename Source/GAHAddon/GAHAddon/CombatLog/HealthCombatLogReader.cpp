@@ -0,0 +1,111 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthCombatLogReader.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+
+
+bool FHealthCombatLogReader::Open(const FString& FilePath)
+{
+	Data.Reset();
+	Names.Reset();
+	Offset = 0;
+
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath) || (Data.Num() < sizeof(FHealthCombatLogFileHeader)))
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, Data.GetData(), sizeof(FHealthCombatLogFileHeader));
+	Offset = sizeof(FHealthCombatLogFileHeader);
+
+	return (Header.Magic == FHealthCombatLogFileHeader::ExpectedMagic) && (Header.Version == FHealthCombatLogFileHeader::CurrentVersion);
+}
+
+bool FHealthCombatLogReader::Next(FHealthCombatLogRecord& OutRecord)
+{
+	while (Offset + static_cast<int64>(sizeof(FHealthCombatLogRecord)) <= Data.Num())
+	{
+		FMemory::Memcpy(&OutRecord, Data.GetData() + Offset, sizeof(FHealthCombatLogRecord));
+		Offset += sizeof(FHealthCombatLogRecord);
+
+		if (OutRecord.Type != EHealthCombatLogEventType::Name)
+		{
+			return (OutRecord.Type < EHealthCombatLogEventType::MAX);
+		}
+
+		const auto PaddedLength{ static_cast<int64>(Align(OutRecord.NameLength, 8)) };
+		if (Offset + PaddedLength > Data.Num())
+		{
+			return false;
+		}
+
+		const auto* NameChars{ reinterpret_cast<const UTF8CHAR*>(Data.GetData() + Offset) };
+		Names.Add(OutRecord.TargetId, FString(FUTF8ToTCHAR(NameChars, OutRecord.NameLength)));
+
+		Offset += PaddedLength;
+	}
+
+	return false;
+}
+
+const FString& FHealthCombatLogReader::GetName(uint32 Id) const
+{
+	static const FString EmptyName;
+
+	const auto* Name{ Names.Find(Id) };
+	return Name ? *Name : EmptyName;
+}
+
+
+static const TCHAR* GetEventTypeName(EHealthCombatLogEventType Type)
+{
+	switch (Type)
+	{
+	case EHealthCombatLogEventType::Damage:			return TEXT("Damage");
+	case EHealthCombatLogEventType::Heal:			return TEXT("Heal");
+	case EHealthCombatLogEventType::HealShield:		return TEXT("HealShield");
+	case EHealthCombatLogEventType::DeathStarted:	return TEXT("DeathStarted");
+	case EHealthCombatLogEventType::DeathFinished:	return TEXT("DeathFinished");
+	case EHealthCombatLogEventType::DamageInput:	return TEXT("DamageInput");
+	case EHealthCombatLogEventType::HealInput:		return TEXT("HealInput");
+	case EHealthCombatLogEventType::HealShieldInput:	return TEXT("HealShieldInput");
+	default:										return TEXT("Unknown");
+	}
+}
+
+static FAutoConsoleCommandWithArgsAndOutputDevice CombatLogDumpCommand(
+	TEXT("GAHA.CombatLog.Dump"),
+	TEXT("Print the records of a combat log file. Usage: GAHA.CombatLog.Dump <Path> [MaxRecords=100]"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateLambda(
+		[](const TArray<FString>& Args, FOutputDevice& Ar)
+		{
+			FHealthCombatLogReader Reader;
+
+			if (!Args.IsValidIndex(0) || !Reader.Open(Args[0]))
+			{
+				Ar.Logf(TEXT("GAHA.CombatLog.Dump: Failed to open the combat log."));
+				return;
+			}
+
+			auto MaxRecords{ 100 };
+			if (Args.IsValidIndex(1))
+			{
+				LexFromString(MaxRecords, *Args[1]);
+			}
+
+			FHealthCombatLogRecord Record;
+			auto NumRecords{ 0 };
+
+			while ((NumRecords < MaxRecords) && Reader.Next(Record))
+			{
+				Ar.Logf(TEXT("%10.3f %8u %-13s %-24s <- %-24s %-24s %-32s %8.2f -> %8.2f%s%s"),
+					Record.Time, Record.Frame, GetEventTypeName(Record.Type),
+					*Reader.GetName(Record.TargetId), *Reader.GetName(Record.InstigatorId), *Reader.GetName(Record.CauserId), *Reader.GetName(Record.TagId),
+					Record.Magnitude, Record.TotalHealthAfter, EnumHasAnyFlags(Record.Flags, EHealthCombatLogFlags::OutOfHealth) ? TEXT(" (out of health)") : TEXT(""),
+					EnumHasAnyFlags(Record.Flags, EHealthCombatLogFlags::Rejected) ? TEXT(" (rejected)") : TEXT(""));
+
+				++NumRecords;
+			}
+		}));
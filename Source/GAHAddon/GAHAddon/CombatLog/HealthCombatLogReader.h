@@ -0,0 +1,43 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "HealthCombatLog.h"
+
+
+/**
+ * Sequential reader of a combat log file written by GAHACombatLog
+ *
+ * Tips:
+ *	Name records are resolved while reading, so GetName can be used for the ids of every record returned by Next.
+ */
+class GAHADDON_API FHealthCombatLogReader
+{
+public:
+	FHealthCombatLogReader() {}
+
+	/**
+	 * Load the whole file. Returns false if it is not a combat log of a supported version.
+	 */
+	bool Open(const FString& FilePath);
+
+	/**
+	 * Read the next event record. Returns false at the end of the file or if it is truncated.
+	 */
+	bool Next(FHealthCombatLogRecord& OutRecord);
+
+	/**
+	 * Returns the actor or tag name of the id, or an empty string if unknown
+	 */
+	const FString& GetName(uint32 Id) const;
+
+	const FHealthCombatLogFileHeader& GetHeader() const { return Header; }
+
+private:
+	TArray<uint8> Data;
+	int64 Offset{ 0 };
+
+	FHealthCombatLogFileHeader Header;
+	TMap<uint32, FString> Names;
+
+};
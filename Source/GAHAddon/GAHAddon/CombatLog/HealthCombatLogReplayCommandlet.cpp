@@ -0,0 +1,428 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthCombatLogReplayCommandlet.h"
+
+#include "CombatLog/HealthCombatLogReader.h"
+#include "Attribute/HealthAttributeMath.h"
+#include "Execution/DamageExecution.h"
+#include "Execution/HealExecution.h"
+#include "Execution/HealthExecutionModifier.h"
+#include "HealthData.h"
+#include "GAHAddonLogs.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthCombatLogReplayCommandlet)
+
+
+namespace GAHACombatLogReplay
+{
+	struct FConfig
+	{
+		FHealthAttributeValues InitialValues;
+
+		const UDamageExecution* DamageExecution{ nullptr };
+		const UHealExecution* HealExecution{ nullptr };
+		const UHealShieldExecution* HealShieldExecution{ nullptr };
+	};
+
+	struct FTargetResult
+	{
+		FString Name;
+		double OriginalDeathTime{ -1.0 };
+		double SimulatedDeathTime{ -1.0 };
+		double OriginalTimeToKill{ -1.0 };
+		double SimulatedTimeToKill{ -1.0 };
+	};
+
+	struct FMatchResult
+	{
+		FString FilePath;
+		bool bLoaded{ false };
+		int64 NumRecords{ 0 };
+		double Duration{ 0.0 };
+		int32 OriginalDeaths{ 0 };
+		int32 SimulatedDeaths{ 0 };
+		TArray<FTargetResult> ChangedTargets;
+	};
+
+	struct FTargetState
+	{
+		FHealthAttributeValues Values;
+		bool bOutOfHealth{ false };
+
+		double FirstDamageTime{ -1.0 };
+		double OriginalFirstDamageTime{ -1.0 };
+		double OriginalDeathTime{ -1.0 };
+		double SimulatedDeathTime{ -1.0 };
+
+		//
+		// Execution input waiting for the record that tells whether its output was applied
+		//
+		FHealthCombatLogRecord PendingInput;
+	};
+
+	static void ApplyToTarget(FTargetState& State, EHealthCombatLogEventType Type, float Magnitude, double Time)
+	{
+		if (State.SimulatedDeathTime >= 0.0)
+		{
+			return;
+		}
+
+		switch (Type)
+		{
+		case EHealthCombatLogEventType::Damage:
+			if (State.FirstDamageTime < 0.0)
+			{
+				State.FirstDamageTime = Time;
+			}
+
+			FHealthAttributeMath::ApplyDamage(State.Values, Magnitude);
+			break;
+
+		case EHealthCombatLogEventType::Heal:
+			FHealthAttributeMath::ApplyHealing(State.Values, Magnitude);
+			break;
+
+		case EHealthCombatLogEventType::HealShield:
+			FHealthAttributeMath::ApplyHealingShield(State.Values, Magnitude);
+			break;
+
+		default:
+			return;
+		}
+
+		// Same out of health transition as UHealthAttributeSet
+
+		FHealthAttributeMath::ResetOutOfHealth(State.Values.Health, State.bOutOfHealth);
+
+		if ((Type == EHealthCombatLogEventType::Damage) && FHealthAttributeMath::UpdateOutOfHealth(State.Values.Health, State.bOutOfHealth))
+		{
+			State.SimulatedDeathTime = Time;
+		}
+	}
+
+	static FMatchResult ReplayMatch(const FString& FilePath, const FConfig& Config)
+	{
+		FMatchResult Result;
+		Result.FilePath = FilePath;
+
+		FHealthCombatLogReader Reader;
+		if (!Reader.Open(FilePath))
+		{
+			return Result;
+		}
+
+		Result.bLoaded = true;
+
+		TMap<uint32, FTargetState> Targets;
+		TMap<uint32, FGameplayTag> Tags;
+		FHealthCombatLogRecord Record;
+
+		const auto MakeSimulationParams
+		{
+			[&Reader, &Tags](const FHealthCombatLogRecord& InputRecord, const FTargetState& State)
+			{
+				auto* Tag{ Tags.Find(InputRecord.TagId) };
+				if (!Tag)
+				{
+					Tag = &Tags.Add(InputRecord.TagId, FGameplayTag::RequestGameplayTag(FName(*Reader.GetName(InputRecord.TagId)), false));
+				}
+
+				FHealthExecutionSimulationParams SimulationParams;
+				SimulationParams.EffectTag = *Tag;
+				SimulationParams.TargetValues = State.Values;
+
+				return SimulationParams;
+			}
+		};
+
+		const auto ApplyInput
+		{
+			[&Config, &MakeSimulationParams](FTargetState& State)
+			{
+				const auto& Input{ State.PendingInput };
+
+				switch (Input.Type)
+				{
+				case EHealthCombatLogEventType::DamageInput:
+					{
+						const auto Damage{ Config.DamageExecution->Simulate(Input.Magnitude, MakeSimulationParams(Input, State)) };
+
+						ApplyToTarget(State, EHealthCombatLogEventType::Damage, FHealthAttributeMath::ApplyDamageResistance(Damage, State.Values.DamageResistance), Input.Time);
+					}
+					break;
+
+				case EHealthCombatLogEventType::HealInput:
+					ApplyToTarget(State, EHealthCombatLogEventType::Heal, Config.HealExecution->Simulate(Input.Magnitude, MakeSimulationParams(Input, State)), Input.Time);
+					break;
+
+				case EHealthCombatLogEventType::HealShieldInput:
+					ApplyToTarget(State, EHealthCombatLogEventType::HealShield, Config.HealShieldExecution->Simulate(Input.Magnitude, MakeSimulationParams(Input, State)), Input.Time);
+					break;
+
+				default:
+					break;
+				}
+
+				State.PendingInput = FHealthCombatLogRecord();
+			}
+		};
+
+		auto FirstTime{ -1.0 };
+		auto LastTime{ 0.0 };
+
+		while (Reader.Next(Record))
+		{
+			++Result.NumRecords;
+
+			FirstTime = (FirstTime < 0.0) ? Record.Time : FirstTime;
+			LastTime = Record.Time;
+
+			auto* State{ Targets.Find(Record.TargetId) };
+			if (!State)
+			{
+				State = &Targets.Add(Record.TargetId);
+				State->Values = Config.InitialValues;
+			}
+
+			// An execution output follows its input directly, inputs without one had no output in the recording
+			// and are simulated in case the replayed configuration gives them one
+
+			const auto bFromExecution{ EnumHasAnyFlags(Record.Flags, EHealthCombatLogFlags::FromExecution) };
+			const auto bRejected{ EnumHasAnyFlags(Record.Flags, EHealthCombatLogFlags::Rejected) };
+
+			if (!bFromExecution)
+			{
+				ApplyInput(*State);
+			}
+
+			switch (Record.Type)
+			{
+			case EHealthCombatLogEventType::DamageInput:
+			case EHealthCombatLogEventType::HealInput:
+			case EHealthCombatLogEventType::HealShieldInput:
+				State->PendingInput = Record;
+				break;
+
+			case EHealthCombatLogEventType::Damage:
+			case EHealthCombatLogEventType::Heal:
+			case EHealthCombatLogEventType::HealShield:
+				if (bFromExecution)
+				{
+					// Outputs of executions are simulated from their input, unless the target rejected them
+
+					if (bRejected)
+					{
+						State->PendingInput = FHealthCombatLogRecord();
+					}
+					else
+					{
+						ApplyInput(*State);
+					}
+				}
+				else
+				{
+					ApplyToTarget(*State, Record.Type, Record.Magnitude, Record.Time);
+				}
+
+				if ((Record.Type == EHealthCombatLogEventType::Damage) && !bRejected)
+				{
+					if (State->OriginalFirstDamageTime < 0.0)
+					{
+						State->OriginalFirstDamageTime = Record.Time;
+					}
+
+					// The recorded out of health transition is what the runtime dispatches the death from
+
+					if ((State->OriginalDeathTime < 0.0) && EnumHasAnyFlags(Record.Flags, EHealthCombatLogFlags::OutOfHealth))
+					{
+						State->OriginalDeathTime = Record.Time;
+					}
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		for (auto& [TargetId, State] : Targets)
+		{
+			ApplyInput(State);
+		}
+
+		Result.Duration = (FirstTime >= 0.0) ? (LastTime - FirstTime) : 0.0;
+
+		for (const auto& [TargetId, State] : Targets)
+		{
+			const auto bOriginalDeath{ State.OriginalDeathTime >= 0.0 };
+			const auto bSimulatedDeath{ State.SimulatedDeathTime >= 0.0 };
+
+			Result.OriginalDeaths += bOriginalDeath ? 1 : 0;
+			Result.SimulatedDeaths += bSimulatedDeath ? 1 : 0;
+
+			if ((bOriginalDeath != bSimulatedDeath) || !FMath::IsNearlyEqual(State.OriginalDeathTime, State.SimulatedDeathTime, 1.0e-3))
+			{
+				auto& Changed{ Result.ChangedTargets.AddDefaulted_GetRef() };
+				Changed.Name = Reader.GetName(TargetId);
+				Changed.OriginalDeathTime = State.OriginalDeathTime;
+				Changed.SimulatedDeathTime = State.SimulatedDeathTime;
+				Changed.OriginalTimeToKill = bOriginalDeath && (State.OriginalFirstDamageTime >= 0.0) ? (State.OriginalDeathTime - State.OriginalFirstDamageTime) : -1.0;
+				Changed.SimulatedTimeToKill = bSimulatedDeath && (State.FirstDamageTime >= 0.0) ? (State.SimulatedDeathTime - State.FirstDamageTime) : -1.0;
+			}
+		}
+
+		return Result;
+	}
+
+	template<typename T>
+	static const T* LoadExecution(const FString& Params, const TCHAR* Switch)
+	{
+		FString ClassPath;
+		if (FParse::Value(*Params, Switch, ClassPath))
+		{
+			if (auto* ExecutionClass{ LoadClass<T>(nullptr, *ClassPath) })
+			{
+				return GetDefault<T>(ExecutionClass);
+			}
+
+			UE_LOG(LogGAHA, Warning, TEXT("HealthCombatLogReplay: Failed to load %s, using %s."), *ClassPath, *T::StaticClass()->GetName());
+		}
+
+		return GetDefault<T>();
+	}
+}
+
+
+UHealthCombatLogReplayCommandlet::UHealthCombatLogReplayCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UHealthCombatLogReplayCommandlet::Main(const FString& Params)
+{
+	using namespace GAHACombatLogReplay;
+
+	FString LogsPath;
+	if (!FParse::Value(*Params, TEXT("Logs="), LogsPath))
+	{
+		UE_LOG(LogGAHA, Error, TEXT("HealthCombatLogReplay: -Logs=<File|Directory> is required."));
+		return 1;
+	}
+
+	TArray<FString> FilePaths;
+
+	if (IFileManager::Get().DirectoryExists(*LogsPath))
+	{
+		IFileManager::Get().FindFiles(FilePaths, *(LogsPath / TEXT("*.gahalog")), true, false);
+
+		for (auto& FilePath : FilePaths)
+		{
+			FilePath = LogsPath / FilePath;
+		}
+	}
+	else
+	{
+		FilePaths.Add(LogsPath);
+	}
+
+	// Configuration to replay against
+
+	FConfig Config;
+
+	FString HealthDataPath;
+	if (FParse::Value(*Params, TEXT("HealthData="), HealthDataPath))
+	{
+		if (const auto* HealthData{ LoadObject<UHealthData>(nullptr, *HealthDataPath) })
+		{
+			Config.InitialValues.Health = HealthData->Health;
+			Config.InitialValues.MinHealth = HealthData->MinHealth;
+			Config.InitialValues.MaxHealth = HealthData->MaxHealth;
+			Config.InitialValues.ExtraHealth = HealthData->ExtraHealth;
+			Config.InitialValues.Shield = HealthData->Shield;
+			Config.InitialValues.MaxShield = HealthData->MaxShield;
+		}
+		else
+		{
+			UE_LOG(LogGAHA, Error, TEXT("HealthCombatLogReplay: Failed to load health data %s."), *HealthDataPath);
+			return 1;
+		}
+	}
+
+	if (FParse::Value(*Params, TEXT("DamageResistance="), Config.InitialValues.DamageResistance))
+	{
+		UE_LOG(LogGAHA, Display, TEXT("HealthCombatLogReplay: -DamageResistance only applies to damage simulated from execution inputs, other damage is replayed as recorded."));
+	}
+
+	Config.DamageExecution = LoadExecution<UDamageExecution>(Params, TEXT("DamageExecution="));
+	Config.HealExecution = LoadExecution<UHealExecution>(Params, TEXT("HealExecution="));
+	Config.HealShieldExecution = LoadExecution<UHealShieldExecution>(Params, TEXT("HealShieldExecution="));
+
+	// Replay every match on the worker threads
+
+	TArray<FMatchResult> Results;
+	Results.SetNum(FilePaths.Num());
+
+	const auto StartTime{ FPlatformTime::Seconds() };
+
+	ParallelFor(FilePaths.Num(), [&](int32 Index)
+	{
+		Results[Index] = ReplayMatch(FilePaths[Index], Config);
+	});
+
+	const auto ElapsedSeconds{ FPlatformTime::Seconds() - StartTime };
+
+	// Report
+
+	FString OutputPath{ FPaths::ProfilingDir() / TEXT("GAHA") / TEXT("CombatLogReplay.csv") };
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString Csv{ TEXT("Match,Target,OriginalDeathTime,SimulatedDeathTime,OriginalTimeToKill,SimulatedTimeToKill" LINE_TERMINATOR) };
+
+	int64 TotalRecords{ 0 };
+	auto TotalDuration{ 0.0 };
+
+	for (const auto& Result : Results)
+	{
+		if (!Result.bLoaded)
+		{
+			UE_LOG(LogGAHA, Warning, TEXT("HealthCombatLogReplay: Failed to read %s."), *Result.FilePath);
+			continue;
+		}
+
+		TotalRecords += Result.NumRecords;
+		TotalDuration += Result.Duration;
+
+		const auto MatchName{ FPaths::GetBaseFilename(Result.FilePath) };
+
+		UE_LOG(LogGAHA, Display, TEXT("HealthCombatLogReplay: %s: %d deaths recorded, %d simulated, %d targets changed."),
+			*MatchName, Result.OriginalDeaths, Result.SimulatedDeaths, Result.ChangedTargets.Num());
+
+		for (const auto& Changed : Result.ChangedTargets)
+		{
+			Csv += FString::Printf(TEXT("%s,%s,%.3f,%.3f,%.3f,%.3f" LINE_TERMINATOR), *MatchName, *Changed.Name,
+				Changed.OriginalDeathTime, Changed.SimulatedDeathTime, Changed.OriginalTimeToKill, Changed.SimulatedTimeToKill);
+		}
+	}
+
+	UE_LOG(LogGAHA, Display, TEXT("HealthCombatLogReplay: Replayed %d matches (%lld records, %.0f s of play) in %.3f s."),
+		Results.Num(), TotalRecords, TotalDuration, ElapsedSeconds);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogGAHA, Error, TEXT("HealthCombatLogReplay: Failed to write %s."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogGAHA, Display, TEXT("HealthCombatLogReplay: Differences written to %s."), *OutputPath);
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "HealthCombatLogReplayCommandlet.generated.h"
+
+
+/**
+ * Commandlet that replays recorded combat logs against the current health configuration
+ *
+ * Tips:
+ *	Usage: -run=HealthCombatLogReplay -Logs=<File|Directory> [-HealthData=<ObjectPath>] [-DamageExecution=<ClassPath>]
+ *	[-HealExecution=<ClassPath>] [-HealShieldExecution=<ClassPath>] [-DamageResistance=<Value>] [-Output=<CsvPath>]
+ *
+ *	Every match is replayed on a worker thread with FHealthAttributeMath, starting every target from the given health data.
+ *	Base magnitudes recorded by the executions are run again through the modifiers of the given execution classes
+ *	(modifiers that only override ModifierExecution are skipped with a warning),
+ *	other damage and healing is applied as recorded. Inputs whose output the target rejected in the recording are skipped.
+ *	Targets whose death differs from the recording are written to the output.
+ *
+ *	-DamageResistance only applies to the damage simulated from execution inputs.
+ *	Other damage records were already reduced by the damage resistance of the recorded target and are applied unchanged.
+ */
+UCLASS()
+class UHealthCombatLogReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UHealthCombatLogReplayCommandlet(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual int32 Main(const FString& Params) override;
+
+};
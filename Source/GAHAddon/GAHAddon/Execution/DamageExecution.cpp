@@ -5,11 +5,16 @@
 #include "Attribute/HealthAttributeSet.h"
 #include "Attribute/CombatAttributeSet.h"
 #include "HealthExecutionModifier.h"
+#include "Benchmark/HealthBenchmark.h"
+#include "CombatLog/HealthCombatLog.h"
+#include "GAHAddonStats.h"
 
 #include "GameplayEffectTypes.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(DamageExecution)
 
+DECLARE_CYCLE_STAT(TEXT("Damage Execution"), STAT_GAHA_DamageExecution, STATGROUP_GAHA);
+
 
 #pragma region DamageStatics
 
@@ -44,6 +49,8 @@ void UDamageExecution::Execute_Implementation(
 	const FGameplayEffectCustomExecutionParameters& ExecutionParams,
 	FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Execution, STAT_GAHA_DamageExecution);
+
 #if WITH_SERVER_CODE
 
 	const auto& Spec{ ExecutionParams.GetOwningSpec() };
@@ -54,15 +61,16 @@ void UDamageExecution::Execute_Implementation(
 	EvaluateParameters.SourceTags = SourceTags;
 	EvaluateParameters.TargetTags = TargetTags;
 
-	auto Damage{ 0.0f };
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().BaseDamageDef, EvaluateParameters, Damage);
+	auto BaseDamage{ 0.0f };
+	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStatics().BaseDamageDef, EvaluateParameters, BaseDamage);
+
+	// Same modifier loop as the simulations
+
+	const auto Damage{ Simulate(BaseDamage, UHealthExecutionModifier::MakeSimulationParams(ExecutionParams)) };
 
-	for (const auto& Modifier : Modifiers)
+	if (GAHACombatLog::IsEnabled())
 	{
-		if (Modifier)
-		{
-			Damage = Modifier->ModifierExecution(Damage, ExecutionParams);
-		}
+		GAHACombatLog::RecordExecutionInput(EHealthCombatLogEventType::DamageInput, ExecutionParams, BaseDamage, Damage > 0.0f);
 	}
 
 	if (Damage > 0.0f)
@@ -73,4 +81,11 @@ void UDamageExecution::Execute_Implementation(
 #endif // #if WITH_SERVER_CODE
 }
 
+float UDamageExecution::Simulate(float Base, const FHealthExecutionSimulationParams& SimulationParams) const
+{
+	const auto Damage{ UHealthExecutionModifier::SimulateModifiers(Modifiers, Base, SimulationParams) };
+
+	return (Damage > 0.0f) ? Damage : 0.0f;
+}
+
 #pragma endregion
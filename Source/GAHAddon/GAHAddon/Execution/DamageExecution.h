@@ -7,6 +7,7 @@
 #include "DamageExecution.generated.h"
 
 class UHealthExecutionModifier;
+struct FHealthExecutionSimulationParams;
 
 
 /**
@@ -31,4 +32,10 @@ protected:
 		const FGameplayEffectCustomExecutionParameters& ExecutionParams, 
 		FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
 
+public:
+	/**
+	 * Returns the damage this execution would output for the base value, running the simulated version of the modifiers
+	 */
+	float Simulate(float Base, const FHealthExecutionSimulationParams& SimulationParams) const;
+
 };
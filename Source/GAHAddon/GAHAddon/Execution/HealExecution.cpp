@@ -5,11 +5,17 @@
 #include "Attribute/HealthAttributeSet.h"
 #include "Attribute/CombatAttributeSet.h"
 #include "HealthExecutionModifier.h"
+#include "Benchmark/HealthBenchmark.h"
+#include "CombatLog/HealthCombatLog.h"
+#include "GAHAddonStats.h"
 
 #include "GameplayEffectTypes.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HealExecution)
 
+DECLARE_CYCLE_STAT(TEXT("Heal Execution"), STAT_GAHA_HealExecution, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Heal Shield Execution"), STAT_GAHA_HealShieldExecution, STATGROUP_GAHA);
+
 
 #pragma region HealStatics
 
@@ -64,6 +70,8 @@ UHealExecution::UHealExecution()
 
 void UHealExecution::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Execution, STAT_GAHA_HealExecution);
+
 #if WITH_SERVER_CODE
 
 	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
@@ -75,19 +83,18 @@ void UHealExecution::Execute_Implementation(const FGameplayEffectCustomExecution
 	EvaluateParameters.SourceTags = SourceTags;
 	EvaluateParameters.TargetTags = TargetTags;
 
-	auto Heal{ 0.0f };
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(HealStatics().BaseHealDef, EvaluateParameters, Heal);
+	auto BaseHeal{ 0.0f };
+	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(HealStatics().BaseHealDef, EvaluateParameters, BaseHeal);
+
+	// Same modifier loop as the simulations
+
+	const auto Heal{ Simulate(BaseHeal, UHealthExecutionModifier::MakeSimulationParams(ExecutionParams)) };
 
-	for (const auto& Modifier : Modifiers)
+	if (GAHACombatLog::IsEnabled())
 	{
-		if (Modifier)
-		{
-			Heal = Modifier->ModifierExecution(Heal, ExecutionParams);
-		}
+		GAHACombatLog::RecordExecutionInput(EHealthCombatLogEventType::HealInput, ExecutionParams, BaseHeal, Heal > 0.0f);
 	}
 
-	Heal = FMath::Max(0.0f, Heal);
-
 	if (Heal > 0.0f)
 	{
 		OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(UHealthAttributeSet::GetHealingAttribute(), EGameplayModOp::Additive, Heal));
@@ -96,6 +103,11 @@ void UHealExecution::Execute_Implementation(const FGameplayEffectCustomExecution
 #endif // #if WITH_SERVER_CODE
 }
 
+float UHealExecution::Simulate(float Base, const FHealthExecutionSimulationParams& SimulationParams) const
+{
+	return FMath::Max(0.0f, UHealthExecutionModifier::SimulateModifiers(Modifiers, Base, SimulationParams));
+}
+
 #pragma endregion
 
 
@@ -108,6 +120,8 @@ UHealShieldExecution::UHealShieldExecution()
 
 void UHealShieldExecution::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Execution, STAT_GAHA_HealShieldExecution);
+
 #if WITH_SERVER_CODE
 
 	const FGameplayEffectSpec& Spec = ExecutionParams.GetOwningSpec();
@@ -119,19 +133,18 @@ void UHealShieldExecution::Execute_Implementation(const FGameplayEffectCustomExe
 	EvaluateParameters.SourceTags = SourceTags;
 	EvaluateParameters.TargetTags = TargetTags;
 
-	auto Heal{ 0.0f };
-	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(HealShieldStatics().BaseHealDef, EvaluateParameters, Heal);
+	auto BaseHeal{ 0.0f };
+	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(HealShieldStatics().BaseHealDef, EvaluateParameters, BaseHeal);
+
+	// Same modifier loop as the simulations
 
-	for (const auto& Modifier : Modifiers)
+	const auto Heal{ Simulate(BaseHeal, UHealthExecutionModifier::MakeSimulationParams(ExecutionParams)) };
+
+	if (GAHACombatLog::IsEnabled())
 	{
-		if (Modifier)
-		{
-			Heal = Modifier->ModifierExecution(Heal, ExecutionParams);
-		}
+		GAHACombatLog::RecordExecutionInput(EHealthCombatLogEventType::HealShieldInput, ExecutionParams, BaseHeal, Heal > 0.0f);
 	}
 
-	Heal = FMath::Max(0.0f, Heal);
-
 	if (Heal > 0.0f)
 	{
 		OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(UHealthAttributeSet::GetHealingShieldAttribute(), EGameplayModOp::Additive, Heal));
@@ -140,4 +153,9 @@ void UHealShieldExecution::Execute_Implementation(const FGameplayEffectCustomExe
 #endif // #if WITH_SERVER_CODE
 }
 
+float UHealShieldExecution::Simulate(float Base, const FHealthExecutionSimulationParams& SimulationParams) const
+{
+	return FMath::Max(0.0f, UHealthExecutionModifier::SimulateModifiers(Modifiers, Base, SimulationParams));
+}
+
 #pragma endregion
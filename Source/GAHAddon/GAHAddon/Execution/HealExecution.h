@@ -6,6 +6,8 @@
 
 #include "HealExecution.generated.h"
 
+struct FHealthExecutionSimulationParams;
+
 
 /**
  * Gameplay Effect Exection for HP Healing
@@ -27,6 +29,12 @@ protected:
 protected:
 	virtual void Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
 
+public:
+	/**
+	 * Returns the healing this execution would output for the base value, running the simulated version of the modifiers
+	 */
+	float Simulate(float Base, const FHealthExecutionSimulationParams& SimulationParams) const;
+
 };
 
 
@@ -50,4 +58,10 @@ protected:
 protected:
 	virtual void Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
 
+public:
+	/**
+	 * Returns the shield healing this execution would output for the base value, running the simulated version of the modifiers
+	 */
+	float Simulate(float Base, const FHealthExecutionSimulationParams& SimulationParams) const;
+
 };
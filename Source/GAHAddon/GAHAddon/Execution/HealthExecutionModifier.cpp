@@ -2,6 +2,13 @@
 
 #include "HealthExecutionModifier.h"
 
+#include "Attribute/HealthAttributeSet.h"
+#include "GameplayTag/GAHATags_Damage.h"
+#include "GAHAddonLogs.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayEffectExecutionCalculation.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HealthExecutionModifier)
 
 
@@ -9,3 +16,52 @@ UHealthExecutionModifier::UHealthExecutionModifier(const FObjectInitializer& Obj
 	: Super(ObjectInitializer)
 {
 }
+
+
+float UHealthExecutionModifier::ModifierSimulation(float Base, const FHealthExecutionSimulationParams& SimulationParams) const
+{
+	if (SimulationParams.ExecutionParams)
+	{
+		return ModifierExecution(Base, *SimulationParams.ExecutionParams);
+	}
+
+	// Simulations run on worker threads
+
+	if (!bWarnedNotSimulated.exchange(true))
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("%s does not override ModifierSimulation and is skipped by simulations, results may differ from the runtime."), *GetPathNameSafe(this));
+	}
+
+	return Base;
+}
+
+
+float UHealthExecutionModifier::SimulateModifiers(TConstArrayView<TObjectPtr<UHealthExecutionModifier>> Modifiers, float Base, const FHealthExecutionSimulationParams& SimulationParams)
+{
+	for (const auto& Modifier : Modifiers)
+	{
+		if (Modifier)
+		{
+			Base = Modifier->ModifierSimulation(Base, SimulationParams);
+		}
+	}
+
+	return Base;
+}
+
+FHealthExecutionSimulationParams UHealthExecutionModifier::MakeSimulationParams(const FGameplayEffectCustomExecutionParameters& ExecutionParams)
+{
+	FHealthExecutionSimulationParams SimulationParams;
+	SimulationParams.EffectTag = GetDamageTypeTag(ExecutionParams.GetOwningSpec());
+	SimulationParams.ExecutionParams = &ExecutionParams;
+
+	const auto* TargetASC{ ExecutionParams.GetTargetAbilitySystemComponent() };
+	const auto* AttributeSet{ TargetASC ? TargetASC->GetSet<UHealthAttributeSet>() : nullptr };
+
+	if (AttributeSet)
+	{
+		SimulationParams.TargetValues = AttributeSet->GetAttributeValues();
+	}
+
+	return SimulationParams;
+}
@@ -2,11 +2,41 @@
 
 #pragma once
 
+#include "Attribute/HealthAttributeMath.h"
+
+#include "GameplayTagContainer.h"
+
+#include <atomic>
+
 #include "HealthExecutionModifier.generated.h"
 
 struct FGameplayEffectCustomExecutionParameters;
 
 
+/**
+ * Inputs available to modifiers, built from the ability system at runtime or from recorded values by simulations, e.g. a combat log replay
+ */
+struct FHealthExecutionSimulationParams
+{
+public:
+	//
+	// Damage.Type tag of the effect, see GetDamageTypeTag
+	//
+	FGameplayTag EffectTag;
+
+	//
+	// Simulated attribute values of the target before the execution
+	//
+	FHealthAttributeValues TargetValues;
+
+	//
+	// Parameters of the execution when run by an ability system, null when simulated
+	//
+	const FGameplayEffectCustomExecutionParameters* ExecutionParams{ nullptr };
+
+};
+
+
 /**
  * Base class for additional computational processing that can be used in HealExecution or DamageExecution
  */
@@ -19,8 +49,32 @@ public:
 
 public:
 	/**
-	 * Base class that defines and executes the method of automatic team assignment
+	 * Modify the value using the ability system, only called at runtime through the default ModifierSimulation
 	 */
 	virtual float ModifierExecution(float Base, const FGameplayEffectCustomExecutionParameters& ExecutionParams) const { return Base; }
 
+	/**
+	 * Modify the value, used both at runtime and by simulations.
+	 * Modifiers should override this instead of ModifierExecution to be reproduced by replays and simulations,
+	 * otherwise simulations pass the value through and warn once.
+	 */
+	virtual float ModifierSimulation(float Base, const FHealthExecutionSimulationParams& SimulationParams) const;
+
+private:
+	//
+	// Whether a simulation already warned that this modifier only implements ModifierExecution
+	//
+	mutable std::atomic<bool> bWarnedNotSimulated{ false };
+
+public:
+	/**
+	 * Run the modifiers in order, shared by the executions and the simulations
+	 */
+	static float SimulateModifiers(TConstArrayView<TObjectPtr<UHealthExecutionModifier>> Modifiers, float Base, const FHealthExecutionSimulationParams& SimulationParams);
+
+	/**
+	 * Returns the parameters of an execution run by an ability system
+	 */
+	static FHealthExecutionSimulationParams MakeSimulationParams(const FGameplayEffectCustomExecutionParameters& ExecutionParams);
+
 };
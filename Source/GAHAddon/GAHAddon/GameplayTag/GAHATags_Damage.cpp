@@ -2,6 +2,8 @@
 
 #include "GAHATags_Damage.h"
 
+#include "GameplayEffect.h"
+
 
 ////////////////////////////////////
 // Damage.Type
@@ -12,3 +14,31 @@ UE_DEFINE_GAMEPLAY_TAG(TAG_Damage_Type_FellOutOfWorld	, "Damage.Type.FellOutOfWo
 UE_DEFINE_GAMEPLAY_TAG(TAG_Damage_Type_Environment		, "Damage.Type.Environment");
 UE_DEFINE_GAMEPLAY_TAG(TAG_Damage_Type_Weapon			, "Damage.Type.Weapon");
 UE_DEFINE_GAMEPLAY_TAG(TAG_Damage_Type_Ability			, "Damage.Type.Ability");
+
+FGameplayTag GetDamageTypeTag(const FGameplayEffectSpec& Spec)
+{
+	static const auto DamageTypeRoot{ TAG_Damage_Type_Unknown.GetTag().RequestDirectParent() };
+
+	// Dynamic tags first, then the tags of the effect definition, without merging them into a new container
+
+	for (const auto& Tag : Spec.GetDynamicAssetTags())
+	{
+		if (Tag.MatchesTag(DamageTypeRoot))
+		{
+			return Tag;
+		}
+	}
+
+	if (Spec.Def)
+	{
+		for (const auto& Tag : Spec.Def->GetAssetTags())
+		{
+			if (Tag.MatchesTag(DamageTypeRoot))
+			{
+				return Tag;
+			}
+		}
+	}
+
+	return TAG_Damage_Type_Unknown;
+}
@@ -4,6 +4,8 @@
 
 #include "NativeGameplayTags.h"
 
+struct FGameplayEffectSpec;
+
 
 ////////////////////////////////////
 // Damage.Type
@@ -14,3 +16,8 @@ GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Damage_Type_FellOutOfWorld);
 GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Damage_Type_Environment);
 GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Damage_Type_Weapon);
 GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Damage_Type_Ability);
+
+/**
+ * Returns the first Damage.Type tag in the asset tags of the effect, or Damage.Type.Unknown
+ */
+GAHADDON_API FGameplayTag GetDamageTypeTag(const FGameplayEffectSpec& Spec);
@@ -8,4 +8,6 @@
 
 UE_DEFINE_GAMEPLAY_TAG(TAG_Status_Death			, "Status.Death");
 UE_DEFINE_GAMEPLAY_TAG(TAG_Status_Death_Dying	, "Status.Death.Dying");
+UE_DEFINE_GAMEPLAY_TAG(TAG_Status_Death_Pending	, "Status.Death.Pending");
 UE_DEFINE_GAMEPLAY_TAG(TAG_Status_Death_Dead	, "Status.Death.Dead");
+UE_DEFINE_GAMEPLAY_TAG(TAG_Status_Downed		, "Status.Downed");
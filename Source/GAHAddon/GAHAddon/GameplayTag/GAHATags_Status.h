@@ -9,4 +9,6 @@
 
 GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Status_Death);
 GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Status_Death_Dying);
+GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Status_Death_Pending);
 GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Status_Death_Dead);
+GAHADDON_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_Status_Downed);
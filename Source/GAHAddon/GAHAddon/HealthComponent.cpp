@@ -4,12 +4,26 @@
 
 #include "Attribute/HealthAttributeSet.h"
 #include "Attribute/CombatAttributeSet.h"
+#include "Ability/GameplayAbility_Death.h"
 #include "HealthData.h"
+#include "Subsystem/HealthDataPreloadSubsystem.h"
+#include "Subsystem/HealthComponentRegistrySubsystem.h"
+#include "Subsystem/HealthDeathQueueSubsystem.h"
+#include "Subsystem/HealthDownedSchedulerSubsystem.h"
 #include "Message/HealthMessageTypes.h"
 #include "GameplayTag/GAHATags_Message.h"
 #include "GameplayTag/GAHATags_Status.h"
 #include "GameplayTag/GAHATags_Event.h"
+#include "GameplayTag/GAHATags_Ability.h"
+#include "GameplayTag/GAHATags_Flag.h"
+#include "Replication/HealthPushModel.h"
+#include "Replication/HealthNetPrioritySubsystem.h"
+#include "Benchmark/HealthBenchmark.h"
 #include "GAHAddonLogs.h"
+#include "Telemetry/HealthTelemetry.h"
+#include "CombatLog/HealthCombatLog.h"
+#include "HitConfirm/HealthHitConfirmComponent.h"
+#include "GAHAddonStats.h"
 
 #include "GAEAbilitySystemComponent.h"
 
@@ -17,14 +31,33 @@
 #include "InitState/InitStateTags.h"
 
 #include "Net/UnrealNetwork.h"
-#include "Net/Core/PushModel/PushModel.h"
 #include "Components/GameFrameworkComponentManager.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameplayEffect.h"
 #include "GameplayEffectExtension.h"
 #include "AbilitySystemGlobals.h"
+#include "Engine/AssetManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HealthComponent)
 
+DECLARE_CYCLE_STAT(TEXT("Death Started"), STAT_GAHA_HandleStartDeath, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Death Finished"), STAT_GAHA_HandleFinishDeath, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Revive"), STAT_GAHA_HandleRevive, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Downed"), STAT_GAHA_HandleStartDowned, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Health Changed"), STAT_GAHA_HandleHealthChanged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Max Health Changed"), STAT_GAHA_HandleMaxHealthChanged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Min Health Changed"), STAT_GAHA_HandleMinHealthChanged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Extra Health Changed"), STAT_GAHA_HandleExtraHealthChanged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Shield Changed"), STAT_GAHA_HandleShieldChanged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Max Shield Changed"), STAT_GAHA_HandleMaxShieldChanged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Out Of Health"), STAT_GAHA_HandleOutOfHealth, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Process Out Of Health"), STAT_GAHA_ProcessOutOfHealth, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Native Death"), STAT_GAHA_HandleNativeDeath, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("On Damaged"), STAT_GAHA_HandleOnDamaged, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("On Healed"), STAT_GAHA_HandleOnHealed, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Notify Damage"), STAT_GAHA_HandleNotifyDamage, STATGROUP_GAHA);
+DECLARE_CYCLE_STAT(TEXT("Notify Heal"), STAT_GAHA_HandleNotifyHeal, STATGROUP_GAHA);
+
 
 static AActor* GetInstigatorFromAttrChangeData(const FOnAttributeChangeData& ChangeData)
 {
@@ -37,6 +70,29 @@ static AActor* GetInstigatorFromAttrChangeData(const FOnAttributeChangeData& Cha
 	return nullptr;
 }
 
+static FHealthOutOfHealthInfo MakeOutOfHealthInfo(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec& DamageEffectSpec, float DamageMagnitude)
+{
+	FHealthOutOfHealthInfo Info;
+	Info.Instigator = DamageInstigator;
+	Info.Causer = DamageCauser;
+	Info.EffectContext = DamageEffectSpec.GetEffectContext();
+	Info.SourceTags = *DamageEffectSpec.CapturedSourceTags.GetAggregatedTags();
+	Info.TargetTags = *DamageEffectSpec.CapturedTargetTags.GetAggregatedTags();
+	Info.DamageMagnitude = DamageMagnitude;
+
+	return Info;
+}
+
+static double GetServerWorldTime(const UWorld* World)
+{
+	if (const auto* GameState{ World ? World->GetGameState() : nullptr })
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+
+	return (World ? World->GetTimeSeconds() : 0.0);
+}
+
 
 const FName UHealthComponent::NAME_ActorFeatureName("Health");
 
@@ -53,20 +109,61 @@ void UHealthComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UHealthComponent, DeathState);
-
 	FDoRepLifetimeParams Params;
 	Params.bIsPushBased = true;
 	Params.Condition = COND_None;
 
 	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthComponent, HealthData, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthComponent, DeathState, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthComponent, ReviveCount, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UHealthComponent, DownedState, Params);
+}
+
+void UHealthComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+#if GAHA_WITH_PUSH_MODEL_AUDIT
+	if (GAHAPushModelAudit::IsEnabled())
+	{
+		GAHAPushModelAudit::AuditObject(this, UHealthComponent::StaticClass());
+		GAHAPushModelAudit::AuditObject(HealthSet, UHealthAttributeSet::StaticClass());
+		GAHAPushModelAudit::AuditObject(CombatSet, UCombatAttributeSet::StaticClass());
+	}
+#endif
 }
 
 
+void UHealthComponent::BeginPlay()
+{
+	// Start loading the assets referenced by the health data set in advance, since initialization waits for them
+
+	RequestHealthDataAssets();
+
+	Super::BeginPlay();
+
+	if (auto* Registry{ UWorld::GetSubsystem<UHealthComponentRegistrySubsystem>(GetWorld()) })
+	{
+		Registry->RegisterHealthComponent(this);
+	}
+}
+
 void UHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (auto* Registry{ UWorld::GetSubsystem<UHealthComponentRegistrySubsystem>(GetWorld()) })
+	{
+		Registry->UnregisterHealthComponent(this);
+	}
+
 	UninitializeFromAbilitySystem();
 
+	if (auto* PrioritySubsystem{ UWorld::GetSubsystem<UHealthNetPrioritySubsystem>(GetWorld()) })
+	{
+		PrioritySubsystem->RemoveHealthComponent(this);
+	}
+
+	ReleaseHealthDataAssets();
+
 	if (const auto* World{ GetWorld() })
 	{
 		if (DamageNotifyTimer.IsValid())
@@ -78,6 +175,16 @@ void UHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 		{
 			World->GetTimerManager().ClearTimer(HealNotifyTimer);
 		}
+
+		if (NetDormancyTimer.IsValid())
+		{
+			World->GetTimerManager().ClearTimer(NetDormancyTimer);
+		}
+
+		if (NativeDeathTimer.IsValid())
+		{
+			World->GetTimerManager().ClearTimer(NativeDeathTimer);
+		}
 	}
 
 	Super::EndPlay(EndPlayReason);
@@ -115,8 +222,16 @@ void UHealthComponent::InitializeWithAbilitySystem()
 		return;
 	}
 
-	CombatSet = Cast<UCombatAttributeSet>(AbilitySystemComponent->InitStats(UCombatAttributeSet::StaticClass(), nullptr));
-	if (!CombatSet)
+	if (bCreateCombatSet)
+	{
+		CombatSet = Cast<UCombatAttributeSet>(AbilitySystemComponent->InitStats(UCombatAttributeSet::StaticClass(), nullptr));
+	}
+	else
+	{
+		CombatSet = AbilitySystemComponent->GetSet<UCombatAttributeSet>();
+	}
+
+	if (!CombatSet && bCreateCombatSet)
 	{
 		UE_LOG(LogGAHA, Error, TEXT("HealthComponent: Cannot initialize health component for owner [%s] with NULL combat set on the ability system."), *GetNameSafe(Owner));
 		return;
@@ -134,14 +249,29 @@ void UHealthComponent::InitializeWithAbilitySystem()
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(UHealthAttributeSet::GetShieldAttribute()).AddUObject(this, &ThisClass::HandleShieldChanged);
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(UHealthAttributeSet::GetMaxShieldAttribute()).AddUObject(this, &ThisClass::HandleMaxShieldChanged);
 	HealthSet->OnOutOfHealth.AddUObject(this, &ThisClass::HandleOutOfHealth);
+	HealthSet->OnDamagedOutOfHealth.AddUObject(this, &ThisClass::HandleDamagedOutOfHealth);
+	AbilitySystemComponent->OnAbilityEnded.AddUObject(this, &ThisClass::HandleAbilityEnded);
 
 	ApplyHealthData();
+
+	// Let the initial state replicate before the owner goes dormant
+
+	RegisterNetDormancyActors();
+	RequestNetUpdate(false);
 }
 
 void UHealthComponent::UninitializeFromAbilitySystem()
 {
 	ClearGameplayTags();
 
+#if GAHA_WITH_PUSH_MODEL_AUDIT
+	GAHAPushModelAudit::ForgetObject(this);
+	GAHAPushModelAudit::ForgetObject(HealthSet);
+	GAHAPushModelAudit::ForgetObject(CombatSet);
+#endif
+
+	UnregisterNetDormancyActors();
+
 	if (AbilitySystemComponent)
 	{
 		RemoveDeathAbilityFromSystem();
@@ -152,6 +282,7 @@ void UHealthComponent::UninitializeFromAbilitySystem()
 		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(UHealthAttributeSet::GetExtraHealthAttribute()).RemoveAll(this);
 		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(UHealthAttributeSet::GetShieldAttribute()).RemoveAll(this);
 		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(UHealthAttributeSet::GetMaxShieldAttribute()).RemoveAll(this);
+		AbilitySystemComponent->OnAbilityEnded.RemoveAll(this);
 	}
 
 	AbilitySystemComponent = nullptr;
@@ -161,10 +292,13 @@ void UHealthComponent::UninitializeFromAbilitySystem()
 
 void UHealthComponent::ClearGameplayTags()
 {
+	ClearDeathPending();
+
 	if (AbilitySystemComponent)
 	{
 		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Dying, 0);
 		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Dead, 0);
+		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Downed, 0);
 	}
 }
 
@@ -186,7 +320,7 @@ void UHealthComponent::OnActorInitStateChanged(const FActorInitStateChangedParam
 
 bool UHealthComponent::CanChangeInitStateToDataInitialized(UGameFrameworkComponentManager* Manager) const
 {
-	if (!HealthData)
+	if (!HealthData || !bHealthDataAssetsLoaded)
 	{
 		return false;
 	}
@@ -210,6 +344,107 @@ void UHealthComponent::OnRep_HealthData()
 	HandleHealthDataUpdated();
 }
 
+bool UHealthComponent::RequestHealthDataAssets()
+{
+	ReleaseHealthDataAssets();
+
+	if (!HealthData)
+	{
+		return true;
+	}
+
+	const auto OnLoaded{ FStreamableDelegate::CreateUObject(this, &ThisClass::HandleHealthDataAssetsLoaded) };
+
+	if (auto* PreloadSubsystem{ UHealthDataPreloadSubsystem::Get(this) })
+	{
+		HealthDataAssetsHandle = PreloadSubsystem->RequestHealthDataAssets(HealthData, OnLoaded);
+	}
+	else if (UAssetManager::IsInitialized())
+	{
+		HealthDataAssetsHandle = UHealthDataPreloadSubsystem::LoadHealthDataAssets(UAssetManager::GetStreamableManager(), HealthData, OnLoaded);
+	}
+
+	if (HealthDataAssetsHandle.IsValid() && HealthDataAssetsHandle->IsLoadingInProgress())
+	{
+		bHealthDataAssetsPending = true;
+		return false;
+	}
+
+	if (!HealthData->AreAssetsLoaded())
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UHealthComponent::RequestHealthDataAssets: Could not request assets of HealthData(%s) for owner [%s], loading them synchronously."), *GetNameSafe(HealthData), *GetNameSafe(GetOwner()));
+
+		TArray<FSoftObjectPath> AssetPaths;
+		HealthData->GetAssetsToLoad(AssetPaths);
+
+		for (const auto& AssetPath : AssetPaths)
+		{
+			AssetPath.TryLoad();
+		}
+	}
+
+	HandleHealthDataAssetsLoadFinished();
+
+	return true;
+}
+
+void UHealthComponent::ReleaseHealthDataAssets()
+{
+	bHealthDataAssetsPending = false;
+	bHealthDataAssetsLoaded = false;
+
+	if (HealthDataAssetsHandle.IsValid())
+	{
+		if (HealthDataAssetsHandle->IsLoadingInProgress())
+		{
+			HealthDataAssetsHandle->CancelHandle();
+		}
+		else
+		{
+			HealthDataAssetsHandle->ReleaseHandle();
+		}
+
+		HealthDataAssetsHandle.Reset();
+	}
+}
+
+void UHealthComponent::HandleHealthDataAssetsLoaded()
+{
+	// The handle is kept, it holds the assets until the health data is replaced or the component ends play
+
+	if (!bHealthDataAssetsPending)
+	{
+		return;
+	}
+
+	bHealthDataAssetsPending = false;
+
+	// Also called when some of the assets failed to load, so the initialization continues without them
+
+	HandleHealthDataAssetsLoadFinished();
+	HandleHealthDataReady();
+}
+
+void UHealthComponent::HandleHealthDataAssetsLoadFinished()
+{
+	bHealthDataAssetsLoaded = true;
+
+	if (HealthData && !HealthData->AreAssetsLoaded())
+	{
+		TArray<FSoftObjectPath> AssetPaths;
+		HealthData->GetAssetsToLoad(AssetPaths);
+
+		for (const auto& AssetPath : AssetPaths)
+		{
+			if (!AssetPath.ResolveObject())
+			{
+				UE_LOG(LogGAHA, Error, TEXT("UHealthComponent::HandleHealthDataAssetsLoadFinished: Failed to load %s referenced by HealthData(%s) for owner [%s], it is applied without it."),
+					*AssetPath.ToString(), *GetNameSafe(HealthData), *GetNameSafe(GetOwner()));
+			}
+		}
+	}
+}
+
 void UHealthComponent::ApplyHealthData()
 {
 	check(HealthData);
@@ -234,34 +469,81 @@ void UHealthComponent::ApplyHealthData()
 
 	RemoveDeathAbilityFromSystem();
 
-	if (auto DeathAbilityClass{ HealthData->DeathEventAbilityClass })
+	if (bUseNativeDeath)
 	{
-		auto* AbilityCDO{ DeathAbilityClass.GetDefaultObject() };
-		auto AbilitySpec{ FGameplayAbilitySpec(AbilityCDO, 1) };
-		AbilitySpec.SourceObject = this;
+		// Death is handled by this component, see HandleNativeDeath
+	}
+	else if (auto* DeathAbilityClass{ HealthData->DeathEventAbilityClass.Get() })
+	{
+		// Granted in HandleOutOfHealth instead when requested by the health data
+
+		if (!HealthData->bGrantDeathAbilityOnDeath)
+		{
+			auto* AbilityCDO{ DeathAbilityClass->GetDefaultObject<UGameplayAbility_Death>() };
+			auto AbilitySpec{ FGameplayAbilitySpec(AbilityCDO, 1) };
+			AbilitySpec.SourceObject = this;
 
-		DeathAbilitySpecHandle = AbilitySystemComponent->GiveAbility(AbilitySpec);
+			DeathAbilitySpecHandle = AbilitySystemComponent->GiveAbility(AbilitySpec);
+		}
 	}
 	else
 	{
 		UE_LOG(LogGAHA, Warning, TEXT("UHealthComponent::ApplyHealthData: DeathEventAbilityClass is not set in HealthData(%s). If you want to implement a character death event, you need to set."), *GetNameSafe(HealthData));
 	}
 
+	if (Owner->HasAuthority())
+	{
+		HandleEndDowned(EHealthDownedEndReason::None);
+	}
+
 	ClearGameplayTags();
 
 	// Broadcast delegates
 
-	OnHealthChanged.Broadcast(this, HealthSet->GetHealth(), HealthSet->GetHealth(), nullptr);
-	OnMaxHealthChanged.Broadcast(this, HealthSet->GetMaxHealth(), HealthSet->GetMaxHealth(), nullptr);
-	OnMinHealthChanged.Broadcast(this, HealthSet->GetMinHealth(), HealthSet->GetMinHealth(), nullptr);
+	const auto Health{ HealthSet->GetHealth() };
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnHealthChanged.Broadcast(this, Health, Health, nullptr);
+	OnHealthChangedNative.Broadcast(this, Health, Health, nullptr);
+
+	const auto MaxHealth{ HealthSet->GetMaxHealth() };
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnMaxHealthChanged.Broadcast(this, MaxHealth, MaxHealth, nullptr);
+	OnMaxHealthChangedNative.Broadcast(this, MaxHealth, MaxHealth, nullptr);
+
+	const auto MinHealth{ HealthSet->GetMinHealth() };
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnMinHealthChanged.Broadcast(this, MinHealth, MinHealth, nullptr);
+	OnMinHealthChangedNative.Broadcast(this, MinHealth, MinHealth, nullptr);
+
+	const auto ExtraHealth{ HealthSet->GetExtraHealth() };
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnExtraHealthChanged.Broadcast(this, ExtraHealth, ExtraHealth, nullptr);
+	OnExtraHealthChangedNative.Broadcast(this, ExtraHealth, ExtraHealth, nullptr);
+
+	const auto Shield{ HealthSet->GetShield() };
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnShieldChanged.Broadcast(this, Shield, Shield, nullptr);
+	OnShieldChangedNative.Broadcast(this, Shield, Shield, nullptr);
+
+	const auto MaxShield{ HealthSet->GetMaxShield() };
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnMaxShieldChanged.Broadcast(this, MaxShield, MaxShield, nullptr);
+	OnMaxShieldChangedNative.Broadcast(this, MaxShield, MaxShield, nullptr);
+}
+
+void UHealthComponent::HandleHealthDataUpdated()
+{
+	// Wait for the referenced assets instead of loading them synchronously
 
-	OnExtraHealthChanged.Broadcast(this, HealthSet->GetExtraHealth(), HealthSet->GetExtraHealth(), nullptr);
+	if (!RequestHealthDataAssets())
+	{
+		return;
+	}
 
-	OnShieldChanged.Broadcast(this, HealthSet->GetShield(), HealthSet->GetShield(), nullptr);
-	OnMaxShieldChanged.Broadcast(this, HealthSet->GetMaxShield(), HealthSet->GetMaxShield(), nullptr);
+	HandleHealthDataReady();
 }
 
-void UHealthComponent::HandleHealthDataUpdated()
+void UHealthComponent::HandleHealthDataReady()
 {
 	if (HasReachedInitState(TAG_InitState_DataInitialized))
 	{
@@ -273,6 +555,49 @@ void UHealthComponent::HandleHealthDataUpdated()
 	}
 }
 
+void UHealthComponent::CancelDeathAbility()
+{
+	if (!AbilitySystemComponent)
+	{
+		return;
+	}
+
+	// Collected first since canceling an ability granted only on death removes its spec
+
+	TArray<UGameplayAbility_Death*, TInlineAllocator<1>> ActiveDeathAbilities;
+
+	for (const auto& Spec : AbilitySystemComponent->GetActivatableAbilities())
+	{
+		if (!Spec.IsActive() || !Spec.Ability || !Spec.Ability->IsA<UGameplayAbility_Death>())
+		{
+			continue;
+		}
+
+		for (auto* Instance : Spec.GetAbilityInstances())
+		{
+			if (auto* DeathAbility{ Cast<UGameplayAbility_Death>(Instance) })
+			{
+				ActiveDeathAbilities.Add(DeathAbility);
+			}
+		}
+	}
+
+	for (auto* DeathAbility : ActiveDeathAbilities)
+	{
+		DeathAbility->CancelDeath();
+	}
+}
+
+void UHealthComponent::HandleAbilityEnded(const FAbilityEndedData& EndedData)
+{
+	// GiveAbilityAndActivateOnce removes the spec when the ability ends, so the handle would be stale
+
+	if (DeathAbilitySpecHandle.IsValid() && (EndedData.AbilitySpecHandle == DeathAbilitySpecHandle) && HealthData && HealthData->bGrantDeathAbilityOnDeath)
+	{
+		DeathAbilitySpecHandle = FGameplayAbilitySpecHandle();
+	}
+}
+
 void UHealthComponent::RemoveDeathAbilityFromSystem()
 {
 	if (AbilitySystemComponent)
@@ -293,7 +618,9 @@ void UHealthComponent::SetHealthData(const UHealthData* NewHealthData)
 		{
 			HealthData = NewHealthData;
 
-			MARK_PROPERTY_DIRTY_FROM_NAME(ThisClass, HealthData, this);
+			GAHA_MARK_PROPERTY_DIRTY(ThisClass, HealthData, this);
+
+			RequestNetUpdate(false);
 
 			HandleHealthDataUpdated();
 		}
@@ -303,17 +630,62 @@ void UHealthComponent::SetHealthData(const UHealthData* NewHealthData)
 
 void UHealthComponent::OnRep_DeathState(EDeathState OldDeathState)
 {
+	GAHA_BENCHMARK_REP_NOTIFY(DeathState);
+
 	const auto NewDeathState{ DeathState };
 
 	// Revert the death state for now since we rely on StartDeath and FinishDeath to change it.
 
 	DeathState = OldDeathState;
 
+	// A revive received with this state resets the death state before moving to the new one
+
+	if (ReviveCount != LastHandledReviveCount)
+	{
+		LastHandledReviveCount = ReviveCount;
+
+		HandleRevive();
+	}
+
 	// The server is trying to set us back but we've already predicted past the server state.
 
-	if (OldDeathState > NewDeathState)
+	else if (OldDeathState > NewDeathState)
 	{
 		UE_LOG(LogGAHA, Warning, TEXT("UHealthComponent: Predicted past server death state [%d] -> [%d] for owner [%s]."), (uint8)OldDeathState, (uint8)NewDeathState, *GetNameSafe(GetOwner()));
+
+		GAHA_TELEMETRY_INC(PredictionRollbacks);
+		return;
+	}
+
+	AdvanceDeathState(NewDeathState);
+}
+
+void UHealthComponent::OnRep_ReviveCount()
+{
+	// Already handled by OnRep_DeathState if the death state was received too
+
+	if (ReviveCount == LastHandledReviveCount)
+	{
+		return;
+	}
+
+	LastHandledReviveCount = ReviveCount;
+
+	// The owner was revived and may have died again without the death state changing
+
+	const auto ReplicatedDeathState{ DeathState };
+
+	HandleRevive();
+
+	AdvanceDeathState(ReplicatedDeathState);
+}
+
+void UHealthComponent::AdvanceDeathState(EDeathState NewDeathState)
+{
+	const auto OldDeathState{ DeathState };
+
+	if (OldDeathState == NewDeathState)
+	{
 		return;
 	}
 
@@ -353,13 +725,22 @@ void UHealthComponent::OnRep_DeathState(EDeathState OldDeathState)
 
 void UHealthComponent::HandleStartDeath()
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Death, STAT_GAHA_HandleStartDeath);
+
 	if (DeathState != EDeathState::NotDead)
 	{
 		return;
 	}
 
+	HandleEndDowned(EHealthDownedEndReason::Finished);
+
 	DeathState = EDeathState::DeathStarted;
 
+	INC_DWORD_STAT(STAT_GAHA_Deaths);
+	GAHA_TELEMETRY_INC(DeathTransitions);
+
+	GAHA_MARK_PROPERTY_DIRTY(ThisClass, DeathState, this);
+
 	if (AbilitySystemComponent)
 	{
 		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Dying, 1);
@@ -368,13 +749,22 @@ void UHealthComponent::HandleStartDeath()
 	auto* Owner{ GetOwner() };
 	check(Owner);
 
+	if (GAHACombatLog::IsEnabled() && Owner->HasAuthority())
+	{
+		GAHACombatLog::RecordEvent(EHealthCombatLogEventType::DeathStarted, Owner, nullptr, nullptr, FGameplayTag(), 0.0f, GetTotalHealth());
+	}
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
 	OnDeathStarted.Broadcast(Owner);
+	OnDeathStartedNative.Broadcast(Owner);
 
-	Owner->ForceNetUpdate();
+	RequestNetUpdate(true);
 }
 
 void UHealthComponent::HandleFinishDeath()
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Death, STAT_GAHA_HandleFinishDeath);
+
 	if (DeathState != EDeathState::DeathStarted)
 	{
 		return;
@@ -382,6 +772,10 @@ void UHealthComponent::HandleFinishDeath()
 
 	DeathState = EDeathState::DeathFinished;
 
+	GAHA_TELEMETRY_INC(DeathTransitions);
+
+	GAHA_MARK_PROPERTY_DIRTY(ThisClass, DeathState, this);
+
 	if (AbilitySystemComponent)
 	{
 		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Dead, 1);
@@ -390,111 +784,781 @@ void UHealthComponent::HandleFinishDeath()
 	auto* Owner{ GetOwner() };
 	check(Owner);
 
+	if (GAHACombatLog::IsEnabled() && Owner->HasAuthority())
+	{
+		GAHACombatLog::RecordEvent(EHealthCombatLogEventType::DeathFinished, Owner, nullptr, nullptr, FGameplayTag(), 0.0f, GetTotalHealth());
+	}
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
 	OnDeathFinished.Broadcast(Owner);
+	OnDeathFinishedNative.Broadcast(Owner);
 
-	Owner->ForceNetUpdate();
+	RequestNetUpdate(true);
 }
 
 
-void UHealthComponent::HandleHealthChanged(const FOnAttributeChangeData& ChangeData)
+void UHealthComponent::HandleNativeDeath()
 {
-	OnHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, GetInstigatorFromAttrChangeData(ChangeData));
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Death, STAT_GAHA_HandleNativeDeath);
 
-	if (ChangeData.OldValue > ChangeData.NewValue)
+	if (DeathState != EDeathState::NotDead)
 	{
-		HandleOnDamaged(ChangeData);
+		return;
+	}
+
+	// Cancel all abilities the same way as UGameplayAbility_Death
+
+	if (AbilitySystemComponent)
+	{
+		FGameplayTagContainer AbilityTypesToIgnore;
+		AbilityTypesToIgnore.AddTag(TAG_Ability_Behavior_ActiveIgnoreDeath);
+
+		AbilitySystemComponent->CancelAbilities(nullptr, &AbilityTypesToIgnore);
+	}
+
+	HandleStartDeath();
+
+	auto* World{ GetWorld() };
+
+	if (!World || (NativeDeathFinishDelay <= 0.0f))
+	{
+		HandleFinishDeath();
 	}
 	else
 	{
-		HandleOnHealed(ChangeData);
+		World->GetTimerManager().SetTimer(NativeDeathTimer, this, &ThisClass::HandleNativeDeathTimer, NativeDeathFinishDelay, false);
 	}
 }
 
-void UHealthComponent::HandleMaxHealthChanged(const FOnAttributeChangeData& ChangeData)
+void UHealthComponent::HandleNativeDeathTimer()
 {
-	OnMaxHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, GetInstigatorFromAttrChangeData(ChangeData));
-}
+	NativeDeathTimer.Invalidate();
 
-void UHealthComponent::HandleMinHealthChanged(const FOnAttributeChangeData& ChangeData)
-{
-	OnMinHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, GetInstigatorFromAttrChangeData(ChangeData));
+	HandleFinishDeath();
 }
 
-void UHealthComponent::HandleExtraHealthChanged(const FOnAttributeChangeData& ChangeData)
+
+void UHealthComponent::OnRep_DownedState(const FHealthDownedState& OldDownedState)
 {
-	OnExtraHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, GetInstigatorFromAttrChangeData(ChangeData));
+	const auto NewDownedState{ DownedState };
 
-	if (ChangeData.OldValue > ChangeData.NewValue)
-	{
-		HandleOnDamaged(ChangeData);
-	}
-	else
+	// Revert the downed state for now since we rely on HandleStartDowned, HandleEndDowned and HandleRevive to change it.
+
+	DownedState = OldDownedState;
+
+	if (NewDownedState.bDowned)
 	{
-		HandleOnHealed(ChangeData);
+		HandleStartDowned(NewDownedState);
 	}
-}
 
-void UHealthComponent::HandleShieldChanged(const FOnAttributeChangeData& ChangeData)
-{
-	OnShieldChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, GetInstigatorFromAttrChangeData(ChangeData));
+	// The death state cannot tell a revive from a death that is not processed yet, e.g. a deferred one
 
-	if (ChangeData.OldValue > ChangeData.NewValue)
+	else if (NewDownedState.EndReason == EHealthDownedEndReason::Revived)
 	{
-		HandleOnDamaged(ChangeData);
+		HandleRevive();
 	}
 	else
 	{
-		HandleOnHealed(ChangeData);
+		HandleEndDowned(NewDownedState.EndReason);
 	}
 }
 
-void UHealthComponent::HandleMaxShieldChanged(const FOnAttributeChangeData& ChangeData)
+void UHealthComponent::StartDowned(FHealthOutOfHealthInfo&& Info)
 {
-	OnMaxShieldChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, GetInstigatorFromAttrChangeData(ChangeData));
-}
+	auto* World{ GetWorld() };
+	check(World);
 
+	DownedInfo = MoveTemp(Info);
 
-void UHealthComponent::HandleOutOfHealth(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec& DamageEffectSpec, float DamageMagnitude)
-{
-	// Sends a GameplayEvent to the AbilitySystemComponent of the Actor that owns this component.
-
-	if (AbilitySystemComponent)
+	if (UHealthHitConfirmComponent::IsAnyCollecting())
 	{
-		FGameplayEventData Payload;
-		Payload.EventTag = TAG_Event_OutOfHealth;
-		Payload.Instigator = AbilitySystemComponent->GetAvatarActor();
-		Payload.Target = AbilitySystemComponent->GetAvatarActor();
-		Payload.ContextHandle = DamageEffectSpec.GetEffectContext();
-		Payload.InstigatorTags = *DamageEffectSpec.CapturedSourceTags.GetAggregatedTags();
-		Payload.TargetTags = *DamageEffectSpec.CapturedTargetTags.GetAggregatedTags();
-		Payload.EventMagnitude = DamageMagnitude;
-
-		auto NewScopedWindow{ FScopedPredictionWindow(AbilitySystemComponent, true) };
-		AbilitySystemComponent->HandleGameplayEvent(Payload.EventTag, &Payload);
+		UHealthHitConfirmComponent::RecordOutcome(GetOwner(), DownedInfo.EffectContext, EHealthHitConfirmFlags::Downed);
 	}
 
-	// Send messages to other systems through GameplayMessageSubsystem
+	FHealthDownedState NewDownedState;
+	NewDownedState.bDowned = true;
+	NewDownedState.DownedHealth = DownedMaxHealth;
 
+	if (BleedOutDuration > 0.0f)
 	{
-		FOutOfHealthMessage Message;
-		Message.Instigator = DamageInstigator;
-		Message.Causer = DamageCauser;
-		Message.SourceTags = *DamageEffectSpec.CapturedSourceTags.GetAggregatedTags();
-		Message.TargetTags = *DamageEffectSpec.CapturedTargetTags.GetAggregatedTags();
-		Message.Damage = DamageMagnitude;
+		NewDownedState.BleedOutEndTime = GetServerWorldTime(World) + BleedOutDuration;
+	}
 
-		auto& MessageSystem{ UGameplayMessageSubsystem::Get(GetWorld()) };
-		MessageSystem.BroadcastMessage(TAG_Message_OutOfHealth, Message);
+	HandleStartDowned(NewDownedState);
+
+	if (BleedOutDuration > 0.0f)
+	{
+		if (auto* Scheduler{ UWorld::GetSubsystem<UHealthDownedSchedulerSubsystem>(World) })
+		{
+			BleedOutHandle = Scheduler->ScheduleBleedOut(this, World->GetTimeSeconds() + BleedOutDuration);
+		}
 	}
 }
 
-void UHealthComponent::HandleOnDamaged(const FOnAttributeChangeData& ChangeData)
+void UHealthComponent::HandleStartDowned(const FHealthDownedState& NewDownedState)
 {
-	const auto* World{ GetWorld() };
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_HandleStartDowned);
 
-	if (World && !DamageNotifyTimer.IsValid())
-	{
-		const auto Delta{ ChangeData.NewValue - ChangeData.OldValue };
+	const auto bWasDowned{ DownedState.bDowned };
+
+	DownedState = NewDownedState;
+
+	GAHA_MARK_PROPERTY_DIRTY(ThisClass, DownedState, this);
+
+	// Only the downed health or the bleed-out time changed
+
+	if (bWasDowned)
+	{
+		RequestNetUpdate(false);
+		return;
+	}
+
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Downed, 1);
+	}
+
+	auto* Owner{ GetOwner() };
+	check(Owner);
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnDowned.Broadcast(Owner);
+	OnDownedNative.Broadcast(Owner);
+
+	RequestNetUpdate(true);
+}
+
+void UHealthComponent::HandleEndDowned(EHealthDownedEndReason EndReason)
+{
+	if (!DownedState.bDowned)
+	{
+		return;
+	}
+
+	DownedState = FHealthDownedState();
+	DownedState.EndReason = EndReason;
+	DownedInfo = FHealthOutOfHealthInfo();
+	BleedOutHandle = 0;
+
+	GAHA_MARK_PROPERTY_DIRTY(ThisClass, DownedState, this);
+
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Downed, 0);
+	}
+
+	RequestNetUpdate(false);
+}
+
+void UHealthComponent::HandleDamagedOutOfHealth(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec& DamageEffectSpec, float DamageMagnitude)
+{
+	if (!DownedState.bDowned || !GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	auto NewDownedState{ DownedState };
+	NewDownedState.DownedHealth = FMath::Max(NewDownedState.DownedHealth - DamageMagnitude, 0.0f);
+
+	HandleStartDowned(NewDownedState);
+
+	// Finished off
+
+	if (NewDownedState.DownedHealth <= 0.0f)
+	{
+		HandleEndDowned(EHealthDownedEndReason::Finished);
+
+		DispatchOutOfHealth(MakeOutOfHealthInfo(DamageInstigator, DamageCauser, DamageEffectSpec, DamageMagnitude));
+	}
+}
+
+void UHealthComponent::HandleBleedOut()
+{
+	if (!DownedState.bDowned)
+	{
+		return;
+	}
+
+	auto Info{ MoveTemp(DownedInfo) };
+
+	HandleEndDowned(EHealthDownedEndReason::Finished);
+
+	DispatchOutOfHealth(MoveTemp(Info));
+}
+
+float UHealthComponent::GetBleedOutTimeRemaining() const
+{
+	if (!DownedState.bDowned || (DownedState.BleedOutEndTime <= 0.0))
+	{
+		return 0.0f;
+	}
+
+	return static_cast<float>(FMath::Max(DownedState.BleedOutEndTime - GetServerWorldTime(GetWorld()), 0.0));
+}
+
+
+void UHealthComponent::MarkDeathPending()
+{
+	if (bDeathPending)
+	{
+		return;
+	}
+
+	bDeathPending = true;
+
+	// Keep the owner from acting or taking more damage until the death is processed
+
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Dying, 1);
+		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Pending, 1);
+		AbilitySystemComponent->AddLooseGameplayTag(TAG_Flag_DamageImmunity);
+	}
+}
+
+void UHealthComponent::ClearDeathPending()
+{
+	if (!bDeathPending)
+	{
+		return;
+	}
+
+	bDeathPending = false;
+
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->RemoveLooseGameplayTag(TAG_Flag_DamageImmunity);
+		AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Pending, 0);
+
+		// Set again by HandleStartDeath
+
+		if (DeathState == EDeathState::NotDead)
+		{
+			AbilitySystemComponent->SetLooseGameplayTagCount(TAG_Status_Death_Dying, 0);
+		}
+	}
+}
+
+bool UHealthComponent::ProcessPendingDeath(const FHealthOutOfHealthInfo& Info)
+{
+	if (!bDeathPending)
+	{
+		return false;
+	}
+
+	// Healing is blocked while dying, but effects can still modify Health directly
+
+	if (!FHealthAttributeMath::IsOutOfHealth(GetHealth()))
+	{
+		ClearDeathPending();
+		return false;
+	}
+
+	ProcessOutOfHealth(Info);
+	return true;
+}
+
+
+void UHealthComponent::HandleRevive()
+{
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_HandleRevive);
+
+	if ((DeathState == EDeathState::NotDead) && !bDeathPending && !DownedState.bDowned)
+	{
+		return;
+	}
+
+	HandleEndDowned(EHealthDownedEndReason::Revived);
+
+	DeathState = EDeathState::NotDead;
+
+	GAHA_MARK_PROPERTY_DIRTY(ThisClass, DeathState, this);
+
+	if (const auto* World{ GetWorld() })
+	{
+		if (NativeDeathTimer.IsValid())
+		{
+			World->GetTimerManager().ClearTimer(NativeDeathTimer);
+		}
+	}
+
+	ClearGameplayTags();
+	CancelDeathAbility();
+
+	auto* Owner{ GetOwner() };
+	check(Owner);
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnRevived.Broadcast(Owner);
+	OnRevivedNative.Broadcast(Owner);
+
+	RequestNetUpdate(true);
+}
+
+bool UHealthComponent::Revive(float NewHealth, float NewShield)
+{
+	auto* Owner{ GetOwner() };
+	check(Owner);
+
+	if (!Owner->HasAuthority() || !AbilitySystemComponent || !HealthSet)
+	{
+		return false;
+	}
+
+	const auto bWasDead{ IsDeadOrDying() };
+
+	if (!bWasDead && !IsDowned())
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UHealthComponent::Revive: Owner [%s] is not dead or downed."), *GetNameSafe(Owner));
+		return false;
+	}
+
+	const auto ClampedHealth{ FMath::Clamp(NewHealth, HealthSet->GetMinHealth(), HealthSet->GetMaxHealth()) };
+	if (ClampedHealth <= 0.0f)
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UHealthComponent::Revive: Cannot revive owner [%s] with health %f."), *GetNameSafe(Owner), ClampedHealth);
+		return false;
+	}
+
+	// Leaving the downed state replicates by itself since the death state does not go backwards.
+
+	if (bWasDead)
+	{
+		++ReviveCount;
+		LastHandledReviveCount = ReviveCount;
+
+		GAHA_MARK_PROPERTY_DIRTY(ThisClass, ReviveCount, this);
+	}
+
+	HandleRevive();
+
+	if (bWasDead && DeathAbilitySpecHandle.IsValid() && HealthData && HealthData->bGrantDeathAbilityOnDeath)
+	{
+		RemoveDeathAbilityFromSystem();
+		DeathAbilitySpecHandle = FGameplayAbilitySpecHandle();
+	}
+
+	// Setting health above zero also clears the out of health flag of the health set
+
+	AbilitySystemComponent->SetNumericAttributeBase(UHealthAttributeSet::GetHealthAttribute(), ClampedHealth);
+	AbilitySystemComponent->SetNumericAttributeBase(UHealthAttributeSet::GetShieldAttribute(), FMath::Clamp(NewShield, 0.0f, HealthSet->GetMaxShield()));
+
+	return true;
+}
+
+
+void UHealthComponent::RequestNetUpdate(bool bForceNetUpdate)
+{
+	auto* Owner{ GetOwner() };
+	check(Owner);
+
+	if (!Owner->HasAuthority())
+	{
+		return;
+	}
+
+	if (bUseHealthNetPriority)
+	{
+		if (auto* PrioritySubsystem{ UWorld::GetSubsystem<UHealthNetPrioritySubsystem>(GetWorld()) })
+		{
+			PrioritySubsystem->NotifyHealthStateChanged(this);
+		}
+	}
+
+	if (!NetDormancyActors.IsEmpty())
+	{
+		WakeFromNetDormancy();
+	}
+
+	if (bForceNetUpdate)
+	{
+		TArray<AActor*, TInlineAllocator<2>> ReplicatingActors;
+		GetReplicatingActors(ReplicatingActors);
+
+		for (auto* Actor : ReplicatingActors)
+		{
+			Actor->ForceNetUpdate();
+		}
+	}
+}
+
+void UHealthComponent::RegisterNetDormancyActors()
+{
+	auto* Owner{ GetOwner() };
+	check(Owner);
+
+	if (!bUseNetDormancy || !Owner->HasAuthority() || !NetDormancyActors.IsEmpty())
+	{
+		return;
+	}
+
+	// Only actors configured to be dormant opted in, the others are never put to sleep
+
+	TArray<AActor*, TInlineAllocator<2>> ReplicatingActors;
+	GetReplicatingActors(ReplicatingActors);
+
+	for (auto* Actor : ReplicatingActors)
+	{
+		if (Actor->NetDormancy > DORM_Awake)
+		{
+			auto& DormancyActor{ NetDormancyActors.AddDefaulted_GetRef() };
+			DormancyActor.Actor = Actor;
+			DormancyActor.Dormancy = (Actor->NetDormancy == DORM_Initial) ? DORM_DormantAll : Actor->NetDormancy.GetValue();
+		}
+	}
+
+	// Every replicated change of the ability system must wake them, not only health
+
+	if (!NetDormancyActors.IsEmpty() && AbilitySystemComponent)
+	{
+		const auto Wake{ [this](auto&&...) { WakeFromNetDormancy(); } };
+
+		AbilitySystemComponent->OnGameplayEffectAppliedDelegateToSelf.AddWeakLambda(this, Wake);
+		AbilitySystemComponent->OnPeriodicGameplayEffectExecuteDelegateOnSelf.AddWeakLambda(this, Wake);
+		AbilitySystemComponent->OnAnyGameplayEffectRemovedDelegate().AddWeakLambda(this, Wake);
+		AbilitySystemComponent->RegisterGenericGameplayTagEvent().AddWeakLambda(this, Wake);
+		AbilitySystemComponent->AbilityActivatedCallbacks.AddWeakLambda(this, Wake);
+		AbilitySystemComponent->AbilityEndedCallbacks.AddWeakLambda(this, Wake);
+	}
+}
+
+void UHealthComponent::UnregisterNetDormancyActors()
+{
+	if (NetDormancyActors.IsEmpty())
+	{
+		return;
+	}
+
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->OnGameplayEffectAppliedDelegateToSelf.RemoveAll(this);
+		AbilitySystemComponent->OnPeriodicGameplayEffectExecuteDelegateOnSelf.RemoveAll(this);
+		AbilitySystemComponent->OnAnyGameplayEffectRemovedDelegate().RemoveAll(this);
+		AbilitySystemComponent->RegisterGenericGameplayTagEvent().RemoveAll(this);
+		AbilitySystemComponent->AbilityActivatedCallbacks.RemoveAll(this);
+		AbilitySystemComponent->AbilityEndedCallbacks.RemoveAll(this);
+	}
+
+	if (NetDormancyTimer.IsValid())
+	{
+		if (auto* World{ GetWorld() })
+		{
+			World->GetTimerManager().ClearTimer(NetDormancyTimer);
+		}
+	}
+
+	// Give the actors their own dormancy back, e.g. a player state that outlives this component
+
+	for (const auto& DormancyActor : NetDormancyActors)
+	{
+		if (auto* Actor{ DormancyActor.Actor.Get() })
+		{
+			Actor->SetNetDormancy(DormancyActor.Dormancy);
+		}
+	}
+
+	NetDormancyActors.Reset();
+}
+
+void UHealthComponent::WakeFromNetDormancy()
+{
+	auto* World{ GetWorld() };
+	if (!World)
+	{
+		return;
+	}
+
+	for (const auto& DormancyActor : NetDormancyActors)
+	{
+		auto* Actor{ DormancyActor.Actor.Get() };
+
+		if (Actor && (Actor->NetDormancy > DORM_Awake))
+		{
+			Actor->SetNetDormancy(DORM_Awake);
+		}
+	}
+
+	// Extend the wake period instead of resetting the timer on every change
+
+	NetDormancyWakeEndTime = World->GetTimeSeconds() + NetDormancyWakeDuration;
+
+	if (!NetDormancyTimer.IsValid())
+	{
+		World->GetTimerManager().SetTimer(NetDormancyTimer, this, &ThisClass::HandleNetDormancyTimer, FMath::Max(NetDormancyWakeDuration, UE_KINDA_SMALL_NUMBER), false);
+	}
+}
+
+void UHealthComponent::GetReplicatingActors(TArray<AActor*, TInlineAllocator<2>>& OutActors) const
+{
+	if (auto* Owner{ GetOwner() })
+	{
+		OutActors.Add(Owner);
+	}
+
+	if (AbilitySystemComponent)
+	{
+		if (auto* ASCOwner{ AbilitySystemComponent->GetOwner() })
+		{
+			OutActors.AddUnique(ASCOwner);
+		}
+	}
+}
+
+void UHealthComponent::HandleNetDormancyTimer()
+{
+	NetDormancyTimer.Invalidate();
+
+	auto* World{ GetWorld() };
+	if (!World)
+	{
+		return;
+	}
+
+	// Wait for the remaining time if the wake period was extended
+
+	const auto RemainingTime{ NetDormancyWakeEndTime - World->GetTimeSeconds() };
+	if (RemainingTime > 0.0)
+	{
+		World->GetTimerManager().SetTimer(NetDormancyTimer, this, &ThisClass::HandleNetDormancyTimer, static_cast<float>(RemainingTime), false);
+		return;
+	}
+
+	for (const auto& DormancyActor : NetDormancyActors)
+	{
+		if (auto* Actor{ DormancyActor.Actor.Get() })
+		{
+			Actor->SetNetDormancy(DormancyActor.Dormancy);
+		}
+	}
+}
+
+
+void UHealthComponent::HandleHealthChanged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleHealthChanged);
+
+	auto* Instigator{ GetInstigatorFromAttrChangeData(ChangeData) };
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+	OnHealthChangedNative.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+
+	RequestNetUpdate(false);
+
+	if (ChangeData.OldValue > ChangeData.NewValue)
+	{
+		HandleOnDamaged(ChangeData);
+	}
+	else
+	{
+		HandleOnHealed(ChangeData);
+	}
+}
+
+void UHealthComponent::HandleMaxHealthChanged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleMaxHealthChanged);
+
+	auto* Instigator{ GetInstigatorFromAttrChangeData(ChangeData) };
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnMaxHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+	OnMaxHealthChangedNative.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+
+	RequestNetUpdate(false);
+}
+
+void UHealthComponent::HandleMinHealthChanged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleMinHealthChanged);
+
+	auto* Instigator{ GetInstigatorFromAttrChangeData(ChangeData) };
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnMinHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+	OnMinHealthChangedNative.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+
+	RequestNetUpdate(false);
+}
+
+void UHealthComponent::HandleExtraHealthChanged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleExtraHealthChanged);
+
+	auto* Instigator{ GetInstigatorFromAttrChangeData(ChangeData) };
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnExtraHealthChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+	OnExtraHealthChangedNative.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+
+	RequestNetUpdate(false);
+
+	if (ChangeData.OldValue > ChangeData.NewValue)
+	{
+		HandleOnDamaged(ChangeData);
+	}
+	else
+	{
+		HandleOnHealed(ChangeData);
+	}
+}
+
+void UHealthComponent::HandleShieldChanged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleShieldChanged);
+
+	auto* Instigator{ GetInstigatorFromAttrChangeData(ChangeData) };
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnShieldChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+	OnShieldChangedNative.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+
+	RequestNetUpdate(false);
+
+	if (ChangeData.OldValue > ChangeData.NewValue)
+	{
+		HandleOnDamaged(ChangeData);
+	}
+	else
+	{
+		HandleOnHealed(ChangeData);
+	}
+}
+
+void UHealthComponent::HandleMaxShieldChanged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleMaxShieldChanged);
+
+	auto* Instigator{ GetInstigatorFromAttrChangeData(ChangeData) };
+
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnMaxShieldChanged.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+	OnMaxShieldChangedNative.Broadcast(this, ChangeData.OldValue, ChangeData.NewValue, Instigator);
+
+	RequestNetUpdate(false);
+}
+
+
+void UHealthComponent::HandleOutOfHealth(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec& DamageEffectSpec, float DamageMagnitude)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Death, STAT_GAHA_HandleOutOfHealth);
+	GAHA_TELEMETRY_INC(OutOfHealthEvents);
+
+	auto Info{ MakeOutOfHealthInfo(DamageInstigator, DamageCauser, DamageEffectSpec, DamageMagnitude) };
+
+	// Go down instead of dying the first time
+
+	if (bCanBeDowned && !IsDowned() && !IsDeadOrDying() && GetOwner()->HasAuthority())
+	{
+		StartDowned(MoveTemp(Info));
+		return;
+	}
+
+	DispatchOutOfHealth(MoveTemp(Info));
+}
+
+void UHealthComponent::DispatchOutOfHealth(FHealthOutOfHealthInfo&& Info)
+{
+	// Only mark the owner as dying now and leave the rest to the death queue when requested
+
+	if (bDeferDeathProcessing && !IsDeadOrDying() && GetOwner()->HasAuthority())
+	{
+		if (auto* DeathQueue{ UWorld::GetSubsystem<UHealthDeathQueueSubsystem>(GetWorld()) })
+		{
+			MarkDeathPending();
+			DeathQueue->EnqueueDeath(this, MoveTemp(Info));
+			return;
+		}
+	}
+
+	ProcessOutOfHealth(Info);
+}
+
+void UHealthComponent::ProcessOutOfHealth(const FHealthOutOfHealthInfo& Info)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Death, STAT_GAHA_ProcessOutOfHealth);
+
+	ClearDeathPending();
+
+	// Make sure the owner is awake for the death ability activation
+
+	RequestNetUpdate(false);
+
+	// Confirm the kill to the instigating player, including finishing blows and bleed-outs
+
+	if (UHealthHitConfirmComponent::IsAnyCollecting())
+	{
+		UHealthHitConfirmComponent::RecordOutcome(GetOwner(), Info.EffectContext, EHealthHitConfirmFlags::Killed);
+	}
+
+	// Skip the gameplay event and the ability activation when the death is handled natively
+
+	if (bUseNativeDeath)
+	{
+		if (GetOwner()->HasAuthority())
+		{
+			HandleNativeDeath();
+		}
+	}
+	else if (AbilitySystemComponent)
+	{
+		// Sends a GameplayEvent to the AbilitySystemComponent of the Actor that owns this component.
+
+		FGameplayEventData Payload;
+		Payload.EventTag = TAG_Event_OutOfHealth;
+		Payload.Instigator = AbilitySystemComponent->GetAvatarActor();
+		Payload.Target = AbilitySystemComponent->GetAvatarActor();
+		Payload.ContextHandle = Info.EffectContext;
+		Payload.InstigatorTags = Info.SourceTags;
+		Payload.TargetTags = Info.TargetTags;
+		Payload.EventMagnitude = Info.DamageMagnitude;
+
+		auto NewScopedWindow{ FScopedPredictionWindow(AbilitySystemComponent, true) };
+		AbilitySystemComponent->HandleGameplayEvent(Payload.EventTag, &Payload);
+
+		// Grant the death ability only now if it is not kept granted while alive
+
+		if (HealthData && HealthData->bGrantDeathAbilityOnDeath && GetOwner()->HasAuthority())
+		{
+			if (auto* DeathAbilityClass{ HealthData->DeathEventAbilityClass.Get() })
+			{
+				auto* AbilityCDO{ DeathAbilityClass->GetDefaultObject<UGameplayAbility_Death>() };
+				auto AbilitySpec{ FGameplayAbilitySpec(AbilityCDO, 1) };
+				AbilitySpec.SourceObject = this;
+
+				DeathAbilitySpecHandle = AbilitySystemComponent->GiveAbilityAndActivateOnce(AbilitySpec, &Payload);
+			}
+		}
+	}
+
+	// Send messages to other systems through GameplayMessageSubsystem
+
+	{
+		FOutOfHealthMessage Message;
+		Message.Instigator = Info.Instigator.Get();
+		Message.Causer = Info.Causer.Get();
+		Message.SourceTags = Info.SourceTags;
+		Message.TargetTags = Info.TargetTags;
+		Message.Damage = Info.DamageMagnitude;
+
+		auto& MessageSystem{ UGameplayMessageSubsystem::Get(GetWorld()) };
+		MessageSystem.BroadcastMessage(TAG_Message_OutOfHealth, Message);
+	}
+}
+
+void UHealthComponent::HandleOnDamaged(const FOnAttributeChangeData& ChangeData)
+{
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleOnDamaged);
+
+	const auto* World{ GetWorld() };
+
+	if (DamageNotifyTimer.IsValid())
+	{
+		GAHA_TELEMETRY_INC(CoalescedNotifications);
+	}
+	else if (World)
+	{
+		const auto Delta{ ChangeData.NewValue - ChangeData.OldValue };
 		const auto PrevTotalHealth{ GetTotalHealth() - Delta };
 
 		DamageNotifyTimer = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ThisClass::HandleNotifyDamage, PrevTotalHealth));
@@ -503,9 +1567,15 @@ void UHealthComponent::HandleOnDamaged(const FOnAttributeChangeData& ChangeData)
 
 void UHealthComponent::HandleOnHealed(const FOnAttributeChangeData& ChangeData)
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleOnHealed);
+
 	const auto* World{ GetWorld() };
 
-	if (World && !HealNotifyTimer.IsValid())
+	if (HealNotifyTimer.IsValid())
+	{
+		GAHA_TELEMETRY_INC(CoalescedNotifications);
+	}
+	else if (World)
 	{
 		const auto Delta{ ChangeData.NewValue - ChangeData.OldValue };
 		const auto PrevTotalHealth{ GetTotalHealth() + Delta };
@@ -516,8 +1586,15 @@ void UHealthComponent::HandleOnHealed(const FOnAttributeChangeData& ChangeData)
 
 void UHealthComponent::HandleNotifyDamage(float PrevTotalHealth)
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleNotifyDamage);
+
 	DamageNotifyTimer.Invalidate();
 
+	if (const auto* World{ GetWorld() })
+	{
+		LastDamageTime = World->GetTimeSeconds();
+	}
+
 	const auto DamageMagnitude{ PrevTotalHealth - GetTotalHealth() };
 
 	// Sends a GameplayEvent to the AbilitySystemComponent of the Actor that owns this component.
@@ -537,11 +1614,15 @@ void UHealthComponent::HandleNotifyDamage(float PrevTotalHealth)
 		AbilitySystemComponent->HandleGameplayEvent(Payload.EventTag, &Payload);
 	}
 
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
 	OnDamage.Broadcast(this, DamageMagnitude);
+	OnDamageNative.Broadcast(this, DamageMagnitude);
 }
 
 void UHealthComponent::HandleNotifyHeal(float PrevTotalHealth)
 {
+	GAHA_SCOPE_PHASE_CYCLE_COUNTER(Notification, STAT_GAHA_HandleNotifyHeal);
+
 	HealNotifyTimer.Invalidate();
 
 	const auto HealMagnitude{ GetTotalHealth() - PrevTotalHealth };
@@ -563,7 +1644,9 @@ void UHealthComponent::HandleNotifyHeal(float PrevTotalHealth)
 		AbilitySystemComponent->HandleGameplayEvent(Payload.EventTag, &Payload);
 	}
 
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
 	OnHeal.Broadcast(this, HealMagnitude);
+	OnHealNative.Broadcast(this, HealMagnitude);
 }
 
 
@@ -5,6 +5,7 @@
 #include "Component/GFCActorComponent.h"
 
 #include "GameplayAbilitySpec.h"
+#include "GameplayEffectTypes.h"
 
 #include "HealthComponent.generated.h"
 
@@ -12,8 +13,10 @@ class UAbilitySystemComponent;
 class UHealthAttributeSet;
 class UCombatAttributeSet;
 class UHealthData;
+struct FStreamableHandle;
 struct FGameplayEffectSpec;
 struct FOnAttributeChangeData;
+struct FAbilityEndedData;
 
 
 /**
@@ -32,6 +35,14 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTotalHealthChangeDelegate, UHealth
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnHealthAttributeChangedDelegate, UHealthComponent*, HealthComponent, float, OldValue, float, NewValue, AActor*, Instigator);
 
 
+/**
+ * Native versions of the above delegates, for C++ listeners that do not need to go through reflection
+ */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnDeathNativeDelegate, AActor* /*OwningActor*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FTotalHealthChangeNativeDelegate, UHealthComponent* /*HealthComponent*/, float /*Value*/);
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnHealthAttributeChangedNativeDelegate, UHealthComponent* /*HealthComponent*/, float /*OldValue*/, float /*NewValue*/, AActor* /*Instigator*/);
+
+
 /**
  * Indicates that the actor is dead or in a death state
  */
@@ -44,6 +55,70 @@ enum class EDeathState : uint8
 };
 
 
+/**
+ * Why an actor left the downed state
+ */
+UENUM(BlueprintType)
+enum class EHealthDownedEndReason : uint8
+{
+	None = 0,
+	Revived,	// Revived by UHealthComponent::Revive
+	Finished,	// Finished off or bled out, the death follows
+};
+
+
+/**
+ * Replicated state of an actor that is downed instead of dying when it runs out of health
+ */
+USTRUCT(BlueprintType)
+struct FHealthDownedState
+{
+	GENERATED_BODY()
+public:
+	FHealthDownedState() {}
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	bool bDowned{ false };
+
+	//
+	// Remaining health of the downed pool, the actor dies when it reaches zero
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float DownedHealth{ 0.0f };
+
+	//
+	// Server world time at which the actor bleeds out, or zero if it does not
+	//
+	UPROPERTY(BlueprintReadOnly)
+	double BleedOutEndTime{ 0.0 };
+
+	//
+	// Why the actor left its last downed state, so that clients do not have to guess it from the death state
+	//
+	UPROPERTY(BlueprintReadOnly)
+	EHealthDownedEndReason EndReason{ EHealthDownedEndReason::None };
+
+};
+
+
+/**
+ * Information about the owner running out of health, kept until its death is processed
+ */
+struct FHealthOutOfHealthInfo
+{
+	TWeakObjectPtr<AActor> Instigator;
+	TWeakObjectPtr<AActor> Causer;
+
+	FGameplayEffectContextHandle EffectContext;
+
+	FGameplayTagContainer SourceTags;
+	FGameplayTagContainer TargetTags;
+
+	float DamageMagnitude{ 0.0f };
+};
+
+
 /**
  * Components that manage actor health, shield, death state and more.
  */
@@ -55,6 +130,7 @@ public:
 	UHealthComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
 
 	//
 	// Function name used to add this component
@@ -74,7 +150,18 @@ protected:
 	UPROPERTY(Transient)
 	FGameplayAbilitySpecHandle DeathAbilitySpecHandle;
 
+	//
+	// If disabled, no combat set is created on the ability system, e.g. for actors that only receive damage or healing.
+	// 
+	// Tips:
+	//	A combat set already added to the ability system is still used.
+	//	Without one, damage and healing applied by the owner through UDamageExecution or UHealExecution have no base amount.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Memory")
+	bool bCreateCombatSet{ true };
+
 protected:
+	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	void InitializeWithAbilitySystem();
@@ -97,10 +184,57 @@ protected:
 	UPROPERTY(EditAnywhere, ReplicatedUsing = "OnRep_HealthData")
 	TObjectPtr<const UHealthData> HealthData{ nullptr };
 
+	//
+	// Handle that loads the assets referenced by the current health data and keeps them loaded while it is used,
+	// e.g. a death ability class that is granted only on death
+	//
+	TSharedPtr<FStreamableHandle> HealthDataAssetsHandle;
+
+	//
+	// Whether the health data waits for HealthDataAssetsHandle to finish loading
+	//
+	bool bHealthDataAssetsPending{ false };
+
+	//
+	// Whether loading the assets of the current health data has been attempted and finished, whether or not they could be loaded
+	//
+	bool bHealthDataAssetsLoaded{ false };
+
 protected:
 	UFUNCTION()
 	virtual void OnRep_HealthData();
 
+	/**
+	 * Asynchronously load the assets referenced by the current health data.
+	 * Returns true if the assets are already loaded.
+	 * 
+	 * Tips:
+	 *	Loads through UHealthDataPreloadSubsystem, or the streamable manager of the asset manager without a game instance.
+	 *	Falls back to a synchronous load if the assets cannot be requested, so that the initialization is never stuck.
+	 *	Assets that fail to load are reported as errors and the health data is applied without them.
+	 */
+	virtual bool RequestHealthDataAssets();
+
+	/**
+	 * Release the assets held for the previous health data
+	 */
+	virtual void ReleaseHealthDataAssets();
+
+	/**
+	 * Calls when the assets referenced by the current health data have been loaded
+	 */
+	virtual void HandleHealthDataAssetsLoaded();
+
+	/**
+	 * Mark the assets of the current health data as loaded and report the ones that could not be loaded
+	 */
+	void HandleHealthDataAssetsLoadFinished();
+
+	/**
+	 * Apply the health data whose assets are loaded, or continue the initialization if it is not applied yet
+	 */
+	virtual void HandleHealthDataReady();
+
 	/**
 	 * Apply the current health data
 	 */
@@ -116,6 +250,16 @@ protected:
 	 */
 	virtual void RemoveDeathAbilityFromSystem();
 
+	/**
+	 * End the active death abilities without finishing the death
+	 */
+	virtual void CancelDeathAbility();
+
+	/**
+	 * Forgets the death ability granted on death once it ends, since the ability system removes its spec
+	 */
+	virtual void HandleAbilityEnded(const FAbilityEndedData& EndedData);
+
 public:
 	/**
 	 * Set the current health data
@@ -131,10 +275,41 @@ protected:
 	UPROPERTY(ReplicatedUsing = OnRep_DeathState)
 	EDeathState DeathState{ EDeathState::NotDead };
 
+	//
+	// Number of times the owner has been revived, lets clients accept a death state going backwards.
+	// 
+	// Tips:
+	//	Declared after DeathState so that its notify is called after OnRep_DeathState when both are received together.
+	//
+	UPROPERTY(ReplicatedUsing = OnRep_ReviveCount)
+	uint8 ReviveCount{ 0 };
+
+	//
+	// Revive count whose revive has already been applied locally
+	//
+	uint8 LastHandledReviveCount{ 0 };
+
+	//
+	// Current downed state, declared after DeathState so that a death is applied before the downed state ends
+	//
+	UPROPERTY(ReplicatedUsing = OnRep_DownedState)
+	FHealthDownedState DownedState;
+
 protected:
 	UFUNCTION()
 	virtual void OnRep_DeathState(EDeathState OldDeathState);
 
+	UFUNCTION()
+	virtual void OnRep_ReviveCount();
+
+	UFUNCTION()
+	virtual void OnRep_DownedState(const FHealthDownedState& OldDownedState);
+
+	/**
+	 * Moves the local death state forward to the given state through HandleStartDeath and HandleFinishDeath
+	 */
+	void AdvanceDeathState(EDeathState NewDeathState);
+
 public:
 	/**
 	 * Executed when the death process is started
@@ -146,6 +321,23 @@ public:
 	 */
 	virtual void HandleFinishDeath();
 
+	/**
+	 * Executed when the owner is revived, resets the death state and death tags
+	 */
+	virtual void HandleRevive();
+
+	/**
+	 * Revives the dead, dying or downed owner in place with the given health and shield.
+	 * Returns false if the owner is not dead or downed, or the health is not above zero.
+	 * 
+	 * Tips:
+	 *	Values are clamped to the current min and max health and max shield, extra health is kept as is.
+	 *	The active death ability is ended without finishing the death, and removed if it is granted only on death,
+	 *	so the owner can die again through it.
+	 */
+	UFUNCTION(BlueprintAuthorityOnly, BlueprintCallable, Category = "Health")
+	bool Revive(float NewHealth, float NewShield);
+
 public:
 	/**
 	 * Returns current death state
@@ -157,7 +349,231 @@ public:
 	 * Returns is dead or dying
 	 */
 	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Health", Meta = (ExpandBoolAsExecs = "ReturnValue"))
-	bool IsDeadOrDying() const { return (DeathState > EDeathState::NotDead); }
+	bool IsDeadOrDying() const { return (DeathState > EDeathState::NotDead) || bDeathPending; }
+
+
+protected:
+	//
+	// If enabled, running out of health is handled directly by this component instead of the death ability.
+	// 
+	// Tips:
+	//	Intended for actors without custom death logic, e.g. NPCs that die in large numbers.
+	//	Abilities are canceled, the death is started and finished after NativeDeathFinishDelay seconds on the server,
+	//	without sending the out of health gameplay event or granting the DeathEventAbilityClass of the health data.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Death")
+	bool bUseNativeDeath{ false };
+
+	//
+	// Seconds between the start and the finish of a native death. Finished in the same frame if zero.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Death", Meta = (EditCondition = "bUseNativeDeath", ClampMin = 0.0))
+	float NativeDeathFinishDelay{ 0.0f };
+
+	UPROPERTY(Transient)
+	FTimerHandle NativeDeathTimer;
+
+	//
+	// If enabled, the work following running out of health on the server is queued to UHealthDeathQueueSubsystem.
+	// 
+	// Tips:
+	//	The owner is marked as dying and immune to damage immediately,
+	//	the death event or native death and the out of health message follow within the per frame budget of the queue.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Death")
+	bool bDeferDeathProcessing{ false };
+
+	//
+	// Whether the death is queued and not yet processed
+	//
+	bool bDeathPending{ false };
+
+protected:
+	/**
+	 * Cancels the abilities of the owner and starts the death without going through the death ability
+	 */
+	virtual void HandleNativeDeath();
+
+	void HandleNativeDeathTimer();
+
+	/**
+	 * Marks the owner as dying until the queued death is processed
+	 */
+	void MarkDeathPending();
+	void ClearDeathPending();
+
+public:
+	/**
+	 * Returns whether running out of health is handled without the death ability
+	 */
+	bool UsesNativeDeath() const { return bUseNativeDeath; }
+
+	/**
+	 * Returns whether the death is waiting in UHealthDeathQueueSubsystem
+	 */
+	bool IsDeathPending() const { return bDeathPending; }
+
+	/**
+	 * Processes the queued death, or cancels it if health was raised while it was pending.
+	 * Returns whether the death was processed.
+	 */
+	bool ProcessPendingDeath(const FHealthOutOfHealthInfo& Info);
+
+
+protected:
+	//
+	// If enabled, the owner is downed instead of dying the first time it runs out of health on the server.
+	// 
+	// Tips:
+	//	Damage received while downed is taken from DownedMaxHealth and the owner dies when it is used up or when it bleeds out.
+	//	Revive brings a downed owner back, healing effects are blocked while downed.
+	//	Bleed-out timers of all components run on UHealthDownedSchedulerSubsystem.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Downed")
+	bool bCanBeDowned{ false };
+
+	//
+	// Health of the downed pool
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Downed", Meta = (EditCondition = "bCanBeDowned", ClampMin = 0.0))
+	float DownedMaxHealth{ 100.0f };
+
+	//
+	// Seconds until a downed owner bleeds out. Never bleeds out if zero.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Downed", Meta = (EditCondition = "bCanBeDowned", ClampMin = 0.0))
+	float BleedOutDuration{ 30.0f };
+
+	//
+	// Handle of the bleed-out timer in UHealthDownedSchedulerSubsystem, zero if none
+	//
+	uint32 BleedOutHandle{ 0 };
+
+	//
+	// How the owner was downed, used when it bleeds out
+	//
+	FHealthOutOfHealthInfo DownedInfo;
+
+protected:
+	/**
+	 * Downs the owner and schedules its bleed-out
+	 */
+	virtual void StartDowned(FHealthOutOfHealthInfo&& Info);
+
+	/**
+	 * Executed when the owner is downed or its downed state is updated
+	 */
+	virtual void HandleStartDowned(const FHealthDownedState& NewDownedState);
+
+	/**
+	 * Executed when the owner is no longer downed, either revived or finished
+	 */
+	virtual void HandleEndDowned(EHealthDownedEndReason EndReason);
+
+	/**
+	 * Drains the downed health by the damage that got through ExtraHealth and Shield
+	 */
+	virtual void HandleDamagedOutOfHealth(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec& DamageEffectSpec, float DamageMagnitude);
+
+public:
+	/**
+	 * Executed by UHealthDownedSchedulerSubsystem when the bleed-out timer expires
+	 */
+	virtual void HandleBleedOut();
+
+	uint32 GetBleedOutHandle() const { return BleedOutHandle; }
+
+	/**
+	 * Returns is downed
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Health", Meta = (ExpandBoolAsExecs = "ReturnValue"))
+	bool IsDowned() const { return DownedState.bDowned; }
+
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	FHealthDownedState GetDownedState() const { return DownedState; }
+
+	/**
+	 * Returns the seconds until a downed owner bleeds out, or zero if it does not
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	float GetBleedOutTimeRemaining() const;
+
+
+protected:
+	//
+	// If enabled, owners configured to be net dormant are woken while their health or ability system state changes.
+	// 
+	// Tips:
+	//	Only the owner and the owner of the ability system whose NetDormancy is dormant when the component is initialized
+	//	are managed, other actors keep their dormancy. Changes of health, death state, gameplay effects, tags and abilities
+	//	wake them and they return to their own dormancy after NetDormancyWakeDuration seconds without changes,
+	//	or when the component is uninitialized.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	bool bUseNetDormancy{ false };
+
+	//
+	// Seconds to keep the owner awake after the last change of the health state
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Replication", Meta = (EditCondition = "bUseNetDormancy", ClampMin = 0.0))
+	float NetDormancyWakeDuration{ 1.0f };
+
+	//
+	// World time until which the owner is kept awake
+	//
+	double NetDormancyWakeEndTime{ 0.0 };
+
+	struct FNetDormancyActor
+	{
+		TWeakObjectPtr<AActor> Actor;
+		ENetDormancy Dormancy{ DORM_DormantAll };
+	};
+
+	//
+	// Actors that opted in to net dormancy and the dormancy to restore them to
+	//
+	TArray<FNetDormancyActor, TInlineAllocator<2>> NetDormancyActors;
+
+	UPROPERTY(Transient)
+	FTimerHandle NetDormancyTimer;
+
+	//
+	// If enabled, the replication priority of the owner follows its health state instead of its distance to the viewers.
+	// 
+	// Tips:
+	//	Managed by UHealthNetPrioritySubsystem when replicating with Iris.
+	//	Owners that do not opt in keep the prioritizer of the replication system.
+	//	The priority applies to the whole actor, not only to its health: urgent owners and the owner of their ability system
+	//	replicate everything more often, and idle owners that do not replicate movement replicate everything less often.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Replication")
+	bool bUseHealthNetPriority{ false };
+
+protected:
+	/**
+	 * Request that the current health state be replicated.
+	 * When net dormancy is used, the owner is woken for a while instead of staying awake.
+	 */
+	virtual void RequestNetUpdate(bool bForceNetUpdate);
+
+	/**
+	 * Start or stop managing the dormancy of the replicating actors that opted in to it
+	 */
+	void RegisterNetDormancyActors();
+	void UnregisterNetDormancyActors();
+
+	/**
+	 * Wake the managed actors and extend the wake period
+	 */
+	void WakeFromNetDormancy();
+
+	void HandleNetDormancyTimer();
+
+public:
+	/**
+	 * Returns the actors that replicate the state of this component
+	 */
+	void GetReplicatingActors(TArray<AActor*, TInlineAllocator<2>>& OutActors) const;
 
 	
 public:
@@ -191,6 +607,29 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnDeathDelegate OnDeathFinished;
 
+	UPROPERTY(BlueprintAssignable)
+	FOnDeathDelegate OnRevived;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnDeathDelegate OnDowned;
+
+public:
+	//
+	// Native delegates broadcast at the same time as the dynamic delegates of the same name
+	//
+	FOnHealthAttributeChangedNativeDelegate OnHealthChangedNative;
+	FOnHealthAttributeChangedNativeDelegate OnMaxHealthChangedNative;
+	FOnHealthAttributeChangedNativeDelegate OnMinHealthChangedNative;
+	FOnHealthAttributeChangedNativeDelegate OnExtraHealthChangedNative;
+	FOnHealthAttributeChangedNativeDelegate OnShieldChangedNative;
+	FOnHealthAttributeChangedNativeDelegate OnMaxShieldChangedNative;
+	FTotalHealthChangeNativeDelegate OnDamageNative;
+	FTotalHealthChangeNativeDelegate OnHealNative;
+	FOnDeathNativeDelegate OnDeathStartedNative;
+	FOnDeathNativeDelegate OnDeathFinishedNative;
+	FOnDeathNativeDelegate OnRevivedNative;
+	FOnDeathNativeDelegate OnDownedNative;
+
 protected:
 	UPROPERTY(Transient)
 	FTimerHandle DamageNotifyTimer;
@@ -198,6 +637,11 @@ protected:
 	UPROPERTY(Transient)
 	FTimerHandle HealNotifyTimer;
 
+	//
+	// World time of the last damage notification
+	//
+	double LastDamageTime{ -1.0 };
+
 protected:
 	virtual void HandleHealthChanged(const FOnAttributeChangeData& ChangeData);
 	virtual void HandleMaxHealthChanged(const FOnAttributeChangeData& ChangeData);
@@ -208,11 +652,30 @@ protected:
 
 public:
 	virtual void HandleOutOfHealth(AActor* DamageInstigator, AActor* DamageCauser, const FGameplayEffectSpec& DamageEffectSpec, float DamageMagnitude);
+
+	/**
+	 * Sends the out of health event or starts the native death, and broadcasts the out of health message
+	 */
+	virtual void ProcessOutOfHealth(const FHealthOutOfHealthInfo& Info);
+
+protected:
+	/**
+	 * Queues the death to UHealthDeathQueueSubsystem when deferred, or processes it immediately
+	 */
+	void DispatchOutOfHealth(FHealthOutOfHealthInfo&& Info);
+
+public:
+
 	virtual void HandleOnDamaged(const FOnAttributeChangeData& ChangeData);
 	virtual void HandleOnHealed(const FOnAttributeChangeData& ChangeData);
 
 	virtual void HandleNotifyDamage(float PrevTotalHealth);
 	virtual void HandleNotifyHeal(float PrevTotalHealth);
+
+	/**
+	 * Returns the world time of the last damage notification, or a negative value if never damaged
+	 */
+	double GetLastDamageTime() const { return LastDamageTime; }
 	
 public:
 	UFUNCTION(BlueprintCallable, Category = "Health")
@@ -2,6 +2,8 @@
 
 #include "HealthData.h"
 
+#include "Ability/GameplayAbility_Death.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HealthData)
 
 
@@ -9,3 +11,17 @@ UHealthData::UHealthData(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 }
+
+
+void UHealthData::GetAssetsToLoad(TArray<FSoftObjectPath>& OutAssetPaths) const
+{
+	if (!DeathEventAbilityClass.IsNull())
+	{
+		OutAssetPaths.AddUnique(DeathEventAbilityClass.ToSoftObjectPath());
+	}
+}
+
+bool UHealthData::AreAssetsLoaded() const
+{
+	return (DeathEventAbilityClass.IsNull() || DeathEventAbilityClass.IsValid());
+}
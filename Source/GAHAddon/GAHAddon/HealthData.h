@@ -38,7 +38,35 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	float Shield{ 50.0f };
 
+	//
+	// Death ability granted when this data is applied.
+	// 
+	// Tips:
+	//	Referenced softly so that loading a health profile does not pull in the ability and its dependencies.
+	//	It is streamed in by UHealthDataPreloadSubsystem before the data is applied.
+	//
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	TSubclassOf<UGameplayAbility_Death> DeathEventAbilityClass;
+	TSoftClassPtr<UGameplayAbility_Death> DeathEventAbilityClass;
+
+	//
+	// If enabled, the death ability is granted when the owner runs out of health instead of when this data is applied.
+	// 
+	// Tips:
+	//	Saves an ability spec and an ability instance per actor while it is alive. 
+	//	The ability is activated by the out of health event and removed when it ends.
+	//
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bGrantDeathAbilityOnDeath{ false };
+
+public:
+	/**
+	 * Collects the soft referenced assets that must be loaded before this data can be applied
+	 */
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutAssetPaths) const;
+
+	/**
+	 * Returns whether all soft referenced assets are already loaded
+	 */
+	bool AreAssetsLoaded() const;
 
 };
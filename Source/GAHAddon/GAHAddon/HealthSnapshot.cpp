@@ -0,0 +1,31 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "HealthSnapshot.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthSnapshot)
+
+
+FHealthSnapshot FHealthSnapshot::MakeFromComponent(const UHealthComponent* HealthComponent)
+{
+	FHealthSnapshot Snapshot;
+
+	if (HealthComponent)
+	{
+		Snapshot.Health = HealthComponent->GetHealth();
+		Snapshot.MaxHealth = HealthComponent->GetMaxHealth();
+		Snapshot.MinHealth = HealthComponent->GetMinHealth();
+		Snapshot.ExtraHealth = HealthComponent->GetExtraHealth();
+		Snapshot.Shield = HealthComponent->GetShield();
+		Snapshot.MaxShield = HealthComponent->GetMaxShield();
+		Snapshot.DeathState = HealthComponent->GetDeathState();
+
+		const auto TotalHealth{ Snapshot.Health + Snapshot.ExtraHealth + Snapshot.Shield };
+		const auto TotalMaxHealth{ Snapshot.MaxHealth + Snapshot.ExtraHealth + Snapshot.MaxShield };
+
+		Snapshot.HealthRatio = (Snapshot.MaxHealth > 0.0f) ? (Snapshot.Health / Snapshot.MaxHealth) : 0.0f;
+		Snapshot.ShieldRatio = (Snapshot.MaxShield > 0.0f) ? (Snapshot.Shield / Snapshot.MaxShield) : 0.0f;
+		Snapshot.TotalHealthRatio = (TotalMaxHealth > 0.0f) ? (TotalHealth / TotalMaxHealth) : 0.0f;
+	}
+
+	return Snapshot;
+}
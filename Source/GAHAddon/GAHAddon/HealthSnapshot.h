@@ -0,0 +1,88 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "HealthComponent.h"
+
+#include "HealthSnapshot.generated.h"
+
+
+/**
+ * Fields of the health snapshot, used as a mask of changed values
+ */
+UENUM(BlueprintType, Meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EHealthSnapshotField : uint8
+{
+	None		= 0 UMETA(Hidden),
+	Health		= 1 << 0,
+	MaxHealth	= 1 << 1,
+	MinHealth	= 1 << 2,
+	ExtraHealth	= 1 << 3,
+	Shield		= 1 << 4,
+	MaxShield	= 1 << 5,
+	DeathState	= 1 << 6,
+	All			= 0x7F UMETA(Hidden),
+};
+ENUM_CLASS_FLAGS(EHealthSnapshotField);
+
+
+/**
+ * All values of the health component at a point in time
+ */
+USTRUCT(BlueprintType)
+struct GAHADDON_API FHealthSnapshot
+{
+	GENERATED_BODY()
+public:
+	FHealthSnapshot() {}
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	float Health{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxHealth{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly)
+	float MinHealth{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly)
+	float ExtraHealth{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly)
+	float Shield{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxShield{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly)
+	EDeathState DeathState{ EDeathState::NotDead };
+
+	//
+	// Health / MaxHealth
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float HealthRatio{ 0.0f };
+
+	//
+	// Shield / MaxShield
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float ShieldRatio{ 0.0f };
+
+	//
+	// Total health / Total max health
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float TotalHealthRatio{ 0.0f };
+
+public:
+	static FHealthSnapshot MakeFromComponent(const UHealthComponent* HealthComponent);
+
+};
+
+
+/**
+ * Delegate to notify that the health snapshot has changed
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnHealthSnapshotChangedNativeDelegate, const FHealthSnapshot& /*Snapshot*/, EHealthSnapshotField /*ChangedFields*/);
@@ -0,0 +1,297 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthHitConfirmComponent.h"
+
+#include "Attribute/HealthAttributeSet.h"
+#include "GameplayTag/GAHATags_Damage.h"
+#include "GAHAddonStats.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayEffectExtension.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/CoreNet.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthHitConfirmComponent)
+
+DECLARE_CYCLE_STAT(TEXT("Hit Confirm Record"), STAT_GAHA_HitConfirmRecord, STATGROUP_GAHA);
+
+
+bool FHealthHitConfirmBatch::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint32 NumHits{ static_cast<uint32>(Hits.Num()) };
+	Ar.SerializeIntPacked(NumHits);
+
+	if (Ar.IsLoading())
+	{
+		if (NumHits > static_cast<uint32>(MaxHits))
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
+		}
+
+		Hits.SetNum(NumHits);
+	}
+
+	for (auto& Hit : Hits)
+	{
+		UObject* Target{ Hit.Target };
+		bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), Target);
+
+		auto QuantizedDamage{ static_cast<uint32>(FMath::Clamp<int64>(FMath::RoundToInt64(Hit.Damage * DamageScale), 0, MAX_uint32)) };
+		Ar.SerializeIntPacked(QuantizedDamage);
+
+		auto HitCount{ static_cast<uint32>(Hit.HitCount) };
+		Ar.SerializeIntPacked(HitCount);
+
+		Ar.SerializeBits(&Hit.Flags, 3);
+
+		auto bTagSuccess{ true };
+		Hit.DamageType.NetSerialize(Ar, Map, bTagSuccess);
+		bOutSuccess &= bTagSuccess;
+
+		if (Ar.IsLoading())
+		{
+			Hit.Target = Cast<AActor>(Target);
+			Hit.Damage = QuantizedDamage / DamageScale;
+			Hit.HitCount = static_cast<int32>(HitCount);
+		}
+	}
+
+	return true;
+}
+
+
+static AController* GetInstigatingController(const FGameplayEffectContextHandle& EffectContext)
+{
+	if (const auto* InstigatorASC{ EffectContext.GetInstigatorAbilitySystemComponent() })
+	{
+		if (InstigatorASC->AbilityActorInfo.IsValid())
+		{
+			if (auto* PlayerController{ InstigatorASC->AbilityActorInfo->PlayerController.Get() })
+			{
+				return PlayerController;
+			}
+		}
+	}
+
+	if (auto* Pawn{ Cast<APawn>(EffectContext.GetInstigator()) })
+	{
+		return Pawn->GetController();
+	}
+
+	return Cast<AController>(EffectContext.GetInstigator());
+}
+
+
+TMap<TObjectKey<AController>, TWeakObjectPtr<UHealthHitConfirmComponent>> UHealthHitConfirmComponent::CollectingComponents;
+
+UHealthHitConfirmComponent::UHealthHitConfirmComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UHealthHitConfirmComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Only collect for players on the server
+
+	const auto* PlayerController{ GetController<APlayerController>() };
+
+	if (GetOwner()->HasAuthority() && IsValid(PlayerController))
+	{
+		bCollecting = true;
+		CollectingComponents.Add(PlayerController, this);
+	}
+}
+
+void UHealthHitConfirmComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bCollecting)
+	{
+		bCollecting = false;
+		CollectingComponents.Remove(GetController<AController>());
+	}
+
+	PendingBatch.Hits.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHealthHitConfirmComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (PendingBatch.Hits.IsEmpty())
+	{
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	// Send once per net update of the owner
+
+	const auto* Owner{ GetOwner() };
+	const auto Interval{ (SendInterval > 0.0f) ? SendInterval : (1.0f / FMath::Max(Owner->NetUpdateFrequency, 1.0f)) };
+	const auto CurrentTime{ GetWorld()->GetTimeSeconds() };
+
+	if ((CurrentTime - LastSendTime) >= Interval)
+	{
+		SendPendingBatch();
+	}
+}
+
+
+void UHealthHitConfirmComponent::AddHit(AActor* Target, float Damage, EHealthHitConfirmFlags Flags, const FGameplayTag& DamageType)
+{
+	if (!bCollecting || !Target || (Damage <= 0.0f))
+	{
+		return;
+	}
+
+	auto* Hit{ PendingBatch.Hits.FindByPredicate([Target, &DamageType](const FHealthHitConfirm& Other) { return (Other.Target == Target) && (Other.DamageType == DamageType); }) };
+
+	if (!Hit)
+	{
+		// Send the full batch now instead of growing it beyond what the client accepts
+
+		if (PendingBatch.Hits.Num() >= FHealthHitConfirmBatch::MaxHits)
+		{
+			SendPendingBatch();
+		}
+
+		Hit = &PendingBatch.Hits.AddDefaulted_GetRef();
+		Hit->Target = Target;
+		Hit->DamageType = DamageType;
+	}
+
+	Hit->Damage += Damage;
+	Hit->Flags |= static_cast<uint8>(Flags);
+	++Hit->HitCount;
+
+	SetComponentTickEnabled(true);
+}
+
+void UHealthHitConfirmComponent::AddOutcome(AActor* Target, EHealthHitConfirmFlags Flags)
+{
+	if (!bCollecting || !Target || (Flags == EHealthHitConfirmFlags::None))
+	{
+		return;
+	}
+
+	// Flag the pending hits on the target, whatever their damage type
+
+	auto bFound{ false };
+
+	for (auto& Hit : PendingBatch.Hits)
+	{
+		if (Hit.Target == Target)
+		{
+			Hit.Flags |= static_cast<uint8>(Flags);
+			bFound = true;
+		}
+	}
+
+	if (!bFound)
+	{
+		if (PendingBatch.Hits.Num() >= FHealthHitConfirmBatch::MaxHits)
+		{
+			SendPendingBatch();
+		}
+
+		auto& Hit{ PendingBatch.Hits.AddDefaulted_GetRef() };
+		Hit.Target = Target;
+		Hit.Flags = static_cast<uint8>(Flags);
+	}
+
+	SetComponentTickEnabled(true);
+}
+
+UHealthHitConfirmComponent* UHealthHitConfirmComponent::FindCollectingComponent(const AController* Controller)
+{
+	const auto* Component{ Controller ? CollectingComponents.Find(Controller) : nullptr };
+	return Component ? Component->Get() : nullptr;
+}
+
+void UHealthHitConfirmComponent::RecordDamage(const UHealthAttributeSet* AttributeSet, const FGameplayEffectModCallbackData& Data, EHealthHitConfirmFlags Flags, const FGameplayTag& DamageType)
+{
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_HitConfirmRecord);
+
+	const auto* Owner{ AttributeSet->GetOwningActor() };
+
+	if (!Owner || !Owner->HasAuthority() || (Data.EvaluatedData.Magnitude <= 0.0f))
+	{
+		return;
+	}
+
+	if (auto* HitConfirmComponent{ FindCollectingComponent(GetInstigatingController(Data.EffectSpec.GetEffectContext())) })
+	{
+		HitConfirmComponent->AddHit(Data.Target.GetAvatarActor(), Data.EvaluatedData.Magnitude, Flags, DamageType);
+	}
+}
+
+void UHealthHitConfirmComponent::RecordOutcome(AActor* Target, const FGameplayEffectContextHandle& EffectContext, EHealthHitConfirmFlags Flags)
+{
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_HitConfirmRecord);
+
+	if (!Target || !Target->HasAuthority())
+	{
+		return;
+	}
+
+	if (auto* HitConfirmComponent{ FindCollectingComponent(GetInstigatingController(EffectContext)) })
+	{
+		HitConfirmComponent->AddOutcome(Target, Flags);
+	}
+}
+
+
+void UHealthHitConfirmComponent::SendPendingBatch()
+{
+	if (PendingBatch.Hits.IsEmpty())
+	{
+		return;
+	}
+
+	LastSendTime = GetWorld()->GetTimeSeconds();
+
+	// Listen server players receive their hits directly
+
+	const auto* PlayerController{ GetController<APlayerController>() };
+
+	if (PlayerController && PlayerController->IsLocalController())
+	{
+		BroadcastHitConfirms(PendingBatch);
+	}
+	else
+	{
+		ClientReceiveHitConfirms(PendingBatch);
+	}
+
+	PendingBatch.Hits.Reset();
+}
+
+void UHealthHitConfirmComponent::ClientReceiveHitConfirms_Implementation(const FHealthHitConfirmBatch& Batch)
+{
+	BroadcastHitConfirms(Batch);
+}
+
+void UHealthHitConfirmComponent::BroadcastHitConfirms(const FHealthHitConfirmBatch& Batch)
+{
+	INC_DWORD_STAT(STAT_GAHA_Broadcasts);
+	OnHitConfirmBatchNative.Broadcast(Batch.Hits);
+
+	for (const auto& Hit : Batch.Hits)
+	{
+		OnHitConfirmed.Broadcast(Hit);
+	}
+}
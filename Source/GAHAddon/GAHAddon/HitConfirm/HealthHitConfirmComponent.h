@@ -0,0 +1,194 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Components/ControllerComponent.h"
+
+#include "GameplayTagContainer.h"
+
+#include "HealthHitConfirmComponent.generated.h"
+
+class UHealthAttributeSet;
+struct FGameplayEffectModCallbackData;
+struct FGameplayEffectContextHandle;
+
+
+/**
+ * Result flags of a confirmed hit
+ */
+UENUM(BlueprintType, Meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EHealthHitConfirmFlags : uint8
+{
+	None			= 0			UMETA(Hidden),
+	ShieldBroken	= 1 << 0,
+	Killed			= 1 << 1,
+	Downed			= 1 << 2,
+};
+ENUM_CLASS_FLAGS(EHealthHitConfirmFlags);
+
+
+/**
+ * Damage dealt by the owning player to a target, merged over one batch
+ * 
+ * Tips:
+ *	Targets downed or killed by the owning player without a hit in the batch, e.g. by bleeding out,
+ *	are sent as an entry with no damage and no hits.
+ */
+USTRUCT(BlueprintType)
+struct FHealthHitConfirm
+{
+	GENERATED_BODY()
+public:
+	FHealthHitConfirm() {}
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	TObjectPtr<AActor> Target{ nullptr };
+
+	UPROPERTY(BlueprintReadOnly)
+	float Damage{ 0.0f };
+
+	UPROPERTY(BlueprintReadOnly, Meta = (Bitmask, BitmaskEnum = "/Script/GAHAddon.EHealthHitConfirmFlags"))
+	uint8 Flags{ 0 };
+
+	UPROPERTY(BlueprintReadOnly)
+	FGameplayTag DamageType;
+
+	//
+	// Number of hits merged into this entry
+	//
+	UPROPERTY(BlueprintReadOnly)
+	int32 HitCount{ 0 };
+
+};
+
+
+/**
+ * Hits sent to the owning client in one RPC
+ * 
+ * Tips:
+ *	Serialized compactly: damage is quantized to 1/DamageScale and counts and flags are packed.
+ */
+USTRUCT()
+struct FHealthHitConfirmBatch
+{
+	GENERATED_BODY()
+public:
+	FHealthHitConfirmBatch() {}
+
+	static constexpr int32 MaxHits{ 64 };
+	static constexpr float DamageScale{ 10.0f };
+
+public:
+	UPROPERTY()
+	TArray<FHealthHitConfirm> Hits;
+
+public:
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+};
+
+template<>
+struct TStructOpsTypeTraits<FHealthHitConfirmBatch> : public TStructOpsTypeTraitsBase2<FHealthHitConfirmBatch>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+
+/**
+ * Delegates for confirmed hits on the owning client
+ */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHealthHitConfirmDelegate, const FHealthHitConfirm&, Hit);
+DECLARE_MULTICAST_DELEGATE_OneParam(FHealthHitConfirmBatchNativeDelegate, const TArray<FHealthHitConfirm>& /*Hits*/);
+
+
+/**
+ * Controller component that collects the damage dealt by its player on the server
+ * and sends it to the owning client as one unreliable RPC per net update.
+ * 
+ * Tips:
+ *	Damage is collected from UHealthAttributeSet, hits on the same target with the same damage type are merged.
+ *	Intended to replace per hit client RPCs for hit markers and damage feedback.
+ */
+UCLASS(Meta = (BlueprintSpawnableComponent))
+class GAHADDON_API UHealthHitConfirmComponent : public UControllerComponent
+{
+	GENERATED_BODY()
+public:
+	UHealthHitConfirmComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	//
+	// Minimum seconds between two batches. Uses the net update frequency of the owner if zero.
+	//
+	UPROPERTY(EditDefaultsOnly, Category = "Hit Confirm", Meta = (ClampMin = 0.0))
+	float SendInterval{ 0.0f };
+
+	//
+	// Hits collected since the last batch
+	//
+	FHealthHitConfirmBatch PendingBatch;
+
+	double LastSendTime{ 0.0 };
+
+	bool bCollecting{ false };
+
+	//
+	// Collecting components by their owning controller, so that hits do not search the components of the instigator
+	//
+	static TMap<TObjectKey<AController>, TWeakObjectPtr<UHealthHitConfirmComponent>> CollectingComponents;
+
+public:
+	/**
+	 * Add damage dealt by the owning player, merged with the pending hit on the same target and damage type
+	 */
+	void AddHit(AActor* Target, float Damage, EHealthHitConfirmFlags Flags, const FGameplayTag& DamageType);
+
+	/**
+	 * Add the outcome of the damage dealt by the owning player to the pending hits on the target
+	 */
+	void AddOutcome(AActor* Target, EHealthHitConfirmFlags Flags);
+
+	/**
+	 * Records the damage of the executed effect to the hit confirm component of the instigating player, if any
+	 */
+	static void RecordDamage(const UHealthAttributeSet* AttributeSet, const FGameplayEffectModCallbackData& Data, EHealthHitConfirmFlags Flags, const FGameplayTag& DamageType);
+
+	/**
+	 * Records that the target was downed or killed to the hit confirm component of the player that instigated the effect, if any
+	 */
+	static void RecordOutcome(AActor* Target, const FGameplayEffectContextHandle& EffectContext, EHealthHitConfirmFlags Flags);
+
+	/**
+	 * Returns whether any hit confirm component is collecting on this server
+	 */
+	static bool IsAnyCollecting() { return !CollectingComponents.IsEmpty(); }
+
+	/**
+	 * Returns the collecting hit confirm component of the controller, if any
+	 */
+	static UHealthHitConfirmComponent* FindCollectingComponent(const AController* Controller);
+
+protected:
+	void SendPendingBatch();
+
+	UFUNCTION(Client, Unreliable)
+	void ClientReceiveHitConfirms(const FHealthHitConfirmBatch& Batch);
+
+	void BroadcastHitConfirms(const FHealthHitConfirmBatch& Batch);
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FHealthHitConfirmDelegate OnHitConfirmed;
+
+	FHealthHitConfirmBatchNativeDelegate OnHitConfirmBatchNative;
+
+};
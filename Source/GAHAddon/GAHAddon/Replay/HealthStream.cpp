@@ -0,0 +1,489 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthStream.h"
+
+#include "Attribute/HealthAttributeSet.h"
+#include "GAHAddonLogs.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/ObjectKey.h"
+
+
+#pragma region Stream
+
+static const TCHAR* HealthStreamHeader{ TEXT("GAHAStream 2") };
+
+FString FHealthStream::ToString() const
+{
+	TStringBuilder<4096> Builder;
+
+	Builder.Append(HealthStreamHeader);
+	Builder.Append(LINE_TERMINATOR);
+
+	for (const auto& Values : InitialValues)
+	{
+		Builder.Appendf(TEXT("S %.9g %.9g %.9g %.9g %.9g %.9g %.9g" LINE_TERMINATOR),
+			Values.Health, Values.MinHealth, Values.MaxHealth, Values.ExtraHealth, Values.Shield, Values.MaxShield, Values.DamageResistance);
+	}
+
+	for (const auto& Event : Events)
+	{
+		Builder.Appendf(TEXT("E %u %d %d %.9g %d %.9g %.9g %.9g" LINE_TERMINATOR),
+			Event.Sequence, Event.SetIndex, static_cast<int32>(Event.Kind), Event.Value, Event.bNotifiedOutOfHealth ? 1 : 0, Event.HealthAfter, Event.ExtraHealthAfter, Event.ShieldAfter);
+	}
+
+	return Builder.ToString();
+}
+
+bool FHealthStream::FromString(const FString& InString)
+{
+	InitialValues.Reset();
+	Events.Reset();
+
+	TArray<FString> Lines;
+	InString.ParseIntoArrayLines(Lines);
+
+	if (Lines.IsEmpty() || (Lines[0] != HealthStreamHeader))
+	{
+		return false;
+	}
+
+	TArray<FString> Tokens;
+
+	for (auto LineIndex{ 1 }; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		Lines[LineIndex].ParseIntoArrayWS(Tokens);
+
+		if ((Tokens.Num() == 8) && (Tokens[0] == TEXT("S")))
+		{
+			auto& Values{ InitialValues.AddDefaulted_GetRef() };
+			Values.Health = FCString::Atof(*Tokens[1]);
+			Values.MinHealth = FCString::Atof(*Tokens[2]);
+			Values.MaxHealth = FCString::Atof(*Tokens[3]);
+			Values.ExtraHealth = FCString::Atof(*Tokens[4]);
+			Values.Shield = FCString::Atof(*Tokens[5]);
+			Values.MaxShield = FCString::Atof(*Tokens[6]);
+			Values.DamageResistance = FCString::Atof(*Tokens[7]);
+		}
+		else if ((Tokens.Num() == 9) && (Tokens[0] == TEXT("E")))
+		{
+			auto& Event{ Events.AddDefaulted_GetRef() };
+			LexFromString(Event.Sequence, *Tokens[1]);
+			Event.SetIndex = FCString::Atoi(*Tokens[2]);
+			Event.Kind = static_cast<EHealthStreamEventKind>(FMath::Clamp(FCString::Atoi(*Tokens[3]), 0, static_cast<int32>(EHealthStreamEventKind::MAX)));
+			Event.Value = FCString::Atof(*Tokens[4]);
+			Event.bNotifiedOutOfHealth = FCString::Atoi(*Tokens[5]) != 0;
+			Event.HealthAfter = FCString::Atof(*Tokens[6]);
+			Event.ExtraHealthAfter = FCString::Atof(*Tokens[7]);
+			Event.ShieldAfter = FCString::Atof(*Tokens[8]);
+
+			if (!InitialValues.IsValidIndex(Event.SetIndex) || (Event.Kind == EHealthStreamEventKind::MAX))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FHealthStream::SaveToFile(const FString& FilePath) const
+{
+	return FFileHelper::SaveStringToFile(ToString(), *FilePath);
+}
+
+bool FHealthStream::LoadFromFile(const FString& FilePath)
+{
+	FString FileContents;
+	return FFileHelper::LoadFileToString(FileContents, *FilePath) && FromString(FileContents);
+}
+
+#pragma endregion
+
+
+#pragma region Recorder
+
+namespace GAHAHealthStream
+{
+	bool bRecording{ false };
+
+	static FString RecordingFilter;
+	static FHealthStream RecordingStream;
+	static TMap<TObjectKey<UHealthAttributeSet>, int32> RecordingSetIndices;
+
+	//
+	// Sequence number of the input executing on each recorded set
+	//
+	static TMap<TObjectKey<UHealthAttributeSet>, uint32> RecordingSequences;
+	static uint32 NextSequence{ 0 };
+
+
+	void StartRecording(const FString& ActorFilter)
+	{
+		RecordingFilter = ActorFilter;
+		RecordingStream = FHealthStream();
+		RecordingSetIndices.Reset();
+		RecordingSequences.Reset();
+		NextSequence = 0;
+
+		bRecording = true;
+	}
+
+	void StopRecording(FHealthStream& OutStream)
+	{
+		bRecording = false;
+
+		OutStream = MoveTemp(RecordingStream);
+		RecordingStream = FHealthStream();
+		RecordingSetIndices.Reset();
+		RecordingSequences.Reset();
+	}
+
+	void NotifyPreExecute(const UHealthAttributeSet* AttributeSet)
+	{
+		const auto Key{ TObjectKey<UHealthAttributeSet>(AttributeSet) };
+
+		if (!RecordingSetIndices.Contains(Key))
+		{
+			if (!RecordingFilter.IsEmpty() && !GetNameSafe(AttributeSet->GetOwningActor()).Contains(RecordingFilter))
+			{
+				return;
+			}
+
+			RecordingSetIndices.Add(Key, RecordingStream.InitialValues.Add(AttributeSet->GetAttributeValues()));
+		}
+
+		RecordingSequences.Add(Key, NextSequence++);
+	}
+
+	static EHealthStreamEventKind GetEventKind(const FGameplayAttribute& Attribute)
+	{
+		if (Attribute == UHealthAttributeSet::GetDamageAttribute())				return EHealthStreamEventKind::Damage;
+		if (Attribute == UHealthAttributeSet::GetHealingAttribute())			return EHealthStreamEventKind::Healing;
+		if (Attribute == UHealthAttributeSet::GetHealingShieldAttribute())		return EHealthStreamEventKind::HealingShield;
+		if (Attribute == UHealthAttributeSet::GetHealthAttribute())				return EHealthStreamEventKind::SetHealth;
+		if (Attribute == UHealthAttributeSet::GetMinHealthAttribute())			return EHealthStreamEventKind::SetMinHealth;
+		if (Attribute == UHealthAttributeSet::GetMaxHealthAttribute())			return EHealthStreamEventKind::SetMaxHealth;
+		if (Attribute == UHealthAttributeSet::GetExtraHealthAttribute())		return EHealthStreamEventKind::SetExtraHealth;
+		if (Attribute == UHealthAttributeSet::GetShieldAttribute())				return EHealthStreamEventKind::SetShield;
+		if (Attribute == UHealthAttributeSet::GetMaxShieldAttribute())			return EHealthStreamEventKind::SetMaxShield;
+		if (Attribute == UHealthAttributeSet::GetDamageResistanceAttribute())	return EHealthStreamEventKind::SetDamageResistance;
+
+		return EHealthStreamEventKind::MAX;
+	}
+
+	void RecordExecute(const UHealthAttributeSet* AttributeSet, const FGameplayAttribute& Attribute, float Magnitude, bool bNotifiedOutOfHealth)
+	{
+		const auto Key{ TObjectKey<UHealthAttributeSet>(AttributeSet) };
+		const auto* SetIndex{ RecordingSetIndices.Find(Key) };
+		const auto* Sequence{ RecordingSequences.Find(Key) };
+		const auto Kind{ GetEventKind(Attribute) };
+
+		if (!SetIndex || !Sequence || (Kind == EHealthStreamEventKind::MAX))
+		{
+			return;
+		}
+
+		const auto bIsMetaAttribute{ Kind <= EHealthStreamEventKind::HealingShield };
+
+		auto& Event{ RecordingStream.Events.AddDefaulted_GetRef() };
+		Event.Sequence = *Sequence;
+		Event.SetIndex = *SetIndex;
+		Event.Kind = Kind;
+		Event.Value = bIsMetaAttribute ? Magnitude : Attribute.GetNumericValue(AttributeSet);
+		Event.bNotifiedOutOfHealth = bNotifiedOutOfHealth;
+		Event.HealthAfter = AttributeSet->GetHealth();
+		Event.ExtraHealthAfter = AttributeSet->GetExtraHealth();
+		Event.ShieldAfter = AttributeSet->GetShield();
+	}
+}
+
+#pragma endregion
+
+
+#pragma region Replayer
+
+namespace GAHAHealthStream
+{
+	struct FReplaySetState
+	{
+		FHealthAttributeValues Values;
+		bool bOutOfHealth{ false };
+		bool bDead{ false };
+	};
+
+	static EHealthAttribute GetAttribute(EHealthStreamEventKind Kind)
+	{
+		static_assert(static_cast<int32>(EHealthStreamEventKind::SetDamageResistance) - static_cast<int32>(EHealthStreamEventKind::SetHealth)
+			== static_cast<int32>(EHealthAttribute::DamageResistance), "Set events must follow the order of EHealthAttribute");
+
+		if ((Kind < EHealthStreamEventKind::SetHealth) || (Kind >= EHealthStreamEventKind::MAX))
+		{
+			return EHealthAttribute::MAX;
+		}
+
+		return static_cast<EHealthAttribute>(static_cast<int32>(Kind) - static_cast<int32>(EHealthStreamEventKind::SetHealth));
+	}
+
+	static bool CheckInvariants(const FHealthAttributeValues& Values)
+	{
+		return (Values.Health >= Values.MinHealth)
+			&& (Values.Health <= Values.MaxHealth)
+			&& (Values.Shield >= 0.0f)
+			&& (Values.Shield <= Values.MaxShield)
+			&& (Values.ExtraHealth >= 0.0f);
+	}
+
+	/**
+	 * Checks how the input may change the layers, written out here rather than derived from FHealthAttributeMath
+	 */
+	static bool CheckTransition(EHealthStreamEventKind Kind, float Value, const FHealthAttributeValues& Before, const FHealthAttributeValues& After)
+	{
+		constexpr auto Tolerance{ 1.0e-3f };
+
+		const auto PoolBefore{ Before.Health + Before.ExtraHealth + Before.Shield };
+		const auto PoolAfter{ After.Health + After.ExtraHealth + After.Shield };
+		const auto Magnitude{ FMath::Max(Value, 0.0f) };
+
+		switch (Kind)
+		{
+		case EHealthStreamEventKind::Damage:
+			// No layer grows and the pool loses the whole damage, less only what Health could not lose
+
+			if ((After.Health > Before.Health + Tolerance) || (After.ExtraHealth > Before.ExtraHealth + Tolerance) || (After.Shield > Before.Shield + Tolerance))
+			{
+				return false;
+			}
+
+			if ((PoolBefore - PoolAfter) > (Magnitude + Tolerance))
+			{
+				return false;
+			}
+
+			return (After.Health <= FMath::Max(After.MinHealth, 0.0f) + Tolerance) || FMath::IsNearlyEqual(PoolBefore - PoolAfter, Magnitude, Tolerance);
+
+		case EHealthStreamEventKind::Healing:
+			// No layer shrinks, ExtraHealth is not healed and the pool gains at most the healing
+
+			if ((After.Health < Before.Health - Tolerance) || (After.Shield < Before.Shield - Tolerance) || !FMath::IsNearlyEqual(After.ExtraHealth, Before.ExtraHealth, Tolerance))
+			{
+				return false;
+			}
+
+			return (PoolAfter - PoolBefore) <= (Magnitude + Tolerance);
+
+		case EHealthStreamEventKind::HealingShield:
+			// Only Shield changes, by at most the healing
+
+			if (!FMath::IsNearlyEqual(After.Health, Before.Health, Tolerance) || !FMath::IsNearlyEqual(After.ExtraHealth, Before.ExtraHealth, Tolerance))
+			{
+				return false;
+			}
+
+			return (After.Shield >= Before.Shield - Tolerance) && ((After.Shield - Before.Shield) <= (Magnitude + Tolerance));
+
+		default:
+			return true;
+		}
+	}
+
+	FHealthStreamReplayResult Replay(const FHealthStream& Stream, int32 Iterations)
+	{
+		FHealthStreamReplayResult Result;
+
+		TArray<FReplaySetState> States;
+		States.SetNum(Stream.InitialValues.Num());
+
+		const auto StartTime{ FPlatformTime::Seconds() };
+
+		for (auto Iteration{ 0 }; Iteration < Iterations; ++Iteration)
+		{
+			// Start from fresh values on every iteration
+
+			for (auto SetIndex{ 0 }; SetIndex < States.Num(); ++SetIndex)
+			{
+				auto& State{ States[SetIndex] };
+				State.Values = Stream.InitialValues[SetIndex];
+				State.bOutOfHealth = FHealthAttributeMath::IsOutOfHealth(State.Values.Health);
+				State.bDead = State.bOutOfHealth;
+			}
+
+			const auto bCheck{ Iteration == 0 };
+
+			auto PreviousSequence{ static_cast<int64>(-1) };
+
+			for (const auto& Event : Stream.Events)
+			{
+				auto& State{ States[Event.SetIndex] };
+				auto& Values{ State.Values };
+
+				const auto ValuesBefore{ Values };
+
+				switch (Event.Kind)
+				{
+				case EHealthStreamEventKind::Damage:				FHealthAttributeMath::ApplyDamage(Values, Event.Value); break;
+				case EHealthStreamEventKind::Healing:				FHealthAttributeMath::ApplyHealing(Values, Event.Value); break;
+				case EHealthStreamEventKind::HealingShield:			FHealthAttributeMath::ApplyHealingShield(Values, Event.Value); break;
+				default:											FHealthAttributeMath::SetValue(Values, GetAttribute(Event.Kind), Event.Value); break;
+				}
+
+				// Same out of health transition as UHealthAttributeSet::PostAttributeChange and PostGameplayEffectExecute
+
+				FHealthAttributeMath::ResetOutOfHealth(Values.Health, State.bOutOfHealth);
+
+				auto bNotifiedOutOfHealth{ false };
+
+				if ((Event.Kind == EHealthStreamEventKind::Damage) || (Event.Kind == EHealthStreamEventKind::SetHealth))
+				{
+					bNotifiedOutOfHealth = FHealthAttributeMath::UpdateOutOfHealth(Values.Health, State.bOutOfHealth);
+				}
+
+				if (!bCheck)
+				{
+					continue;
+				}
+
+				++Result.NumEvents;
+
+				if (bNotifiedOutOfHealth)
+				{
+					++Result.NumOutOfHealth;
+				}
+
+				// Only one out of health per death, and only at no health
+
+				const auto bSequenceInOrder{ static_cast<int64>(Event.Sequence) > PreviousSequence };
+				PreviousSequence = Event.Sequence;
+
+				if (bNotifiedOutOfHealth && (State.bDead || (Values.Health > 0.0f)))
+				{
+					++Result.NumInvariantViolations;
+				}
+				else if (!CheckInvariants(Values) || !CheckTransition(Event.Kind, Event.Value, ValuesBefore, Values) || !bSequenceInOrder)
+				{
+					++Result.NumInvariantViolations;
+				}
+
+				if (bNotifiedOutOfHealth)
+				{
+					State.bDead = true;
+				}
+				else if (Values.Health > 0.0f)
+				{
+					State.bDead = false;
+				}
+
+				if ((bNotifiedOutOfHealth != Event.bNotifiedOutOfHealth) ||
+					!FMath::IsNearlyEqual(Values.Health, Event.HealthAfter) ||
+					!FMath::IsNearlyEqual(Values.ExtraHealth, Event.ExtraHealthAfter) ||
+					!FMath::IsNearlyEqual(Values.Shield, Event.ShieldAfter))
+				{
+					++Result.NumDivergences;
+				}
+			}
+		}
+
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		return Result;
+	}
+}
+
+#pragma endregion
+
+
+#pragma region Commands
+
+namespace GAHAHealthStream
+{
+	static FString GetStreamDirectory()
+	{
+		return FPaths::ProfilingDir() / TEXT("GAHA") / TEXT("Streams");
+	}
+
+	static FAutoConsoleCommand RecordCommand(
+		TEXT("GAHA.Stream.Record"),
+		TEXT("Start recording the inputs applied to health attribute sets. Usage: GAHA.Stream.Record [ActorNameFilter]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda(
+			[](const TArray<FString>& Args)
+			{
+				StartRecording(Args.IsValidIndex(0) ? Args[0] : FString());
+
+				UE_LOG(LogGAHA, Log, TEXT("GAHA.Stream.Record: Recording started."));
+			}));
+
+	static FAutoConsoleCommand StopCommand(
+		TEXT("GAHA.Stream.Stop"),
+		TEXT("Stop recording and save the stream. Usage: GAHA.Stream.Stop [Name]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda(
+			[](const TArray<FString>& Args)
+			{
+				if (!IsRecording())
+				{
+					UE_LOG(LogGAHA, Warning, TEXT("GAHA.Stream.Stop: Not recording."));
+					return;
+				}
+
+				FHealthStream Stream;
+				StopRecording(Stream);
+
+				const auto Name{ Args.IsValidIndex(0) ? Args[0] : FDateTime::Now().ToString() };
+				const auto FilePath{ GetStreamDirectory() / (Name + TEXT(".txt")) };
+
+				if (Stream.SaveToFile(FilePath))
+				{
+					UE_LOG(LogGAHA, Log, TEXT("GAHA.Stream.Stop: Saved %d sets and %d events to %s"), Stream.InitialValues.Num(), Stream.Events.Num(), *FilePath);
+				}
+				else
+				{
+					UE_LOG(LogGAHA, Error, TEXT("GAHA.Stream.Stop: Failed to save %s"), *FilePath);
+				}
+			}));
+
+	static FAutoConsoleCommand ReplayCommand(
+		TEXT("GAHA.Stream.Replay"),
+		TEXT("Replay a recorded stream, check invariants and report throughput. Usage: GAHA.Stream.Replay <Name|Path> [Iterations=1]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda(
+			[](const TArray<FString>& Args)
+			{
+				if (!Args.IsValidIndex(0))
+				{
+					UE_LOG(LogGAHA, Warning, TEXT("GAHA.Stream.Replay: No stream specified."));
+					return;
+				}
+
+				auto FilePath{ Args[0] };
+				if (!FPaths::FileExists(FilePath))
+				{
+					FilePath = GetStreamDirectory() / (Args[0] + TEXT(".txt"));
+				}
+
+				FHealthStream Stream;
+				if (!Stream.LoadFromFile(FilePath))
+				{
+					UE_LOG(LogGAHA, Error, TEXT("GAHA.Stream.Replay: Failed to load %s"), *FilePath);
+					return;
+				}
+
+				auto Iterations{ 1 };
+				if (Args.IsValidIndex(1))
+				{
+					LexFromString(Iterations, *Args[1]);
+				}
+
+				const auto Result{ Replay(Stream, FMath::Max(Iterations, 1)) };
+				const auto TotalEvents{ static_cast<double>(Stream.Events.Num()) * FMath::Max(Iterations, 1) };
+
+				UE_LOG(LogGAHA, Log, TEXT("GAHA.Stream.Replay: %lld events, %d out of health, %d invariant violations, %d divergences, %.0f events/s"),
+					Result.NumEvents, Result.NumOutOfHealth, Result.NumInvariantViolations, Result.NumDivergences, (Result.Seconds > 0.0) ? (TotalEvents / Result.Seconds) : 0.0);
+			}));
+}
+
+#pragma endregion
@@ -0,0 +1,134 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Attribute/HealthAttributeMath.h"
+
+class UHealthAttributeSet;
+struct FGameplayAttribute;
+
+
+/**
+ * Kind of input recorded in a health stream
+ */
+enum class EHealthStreamEventKind : uint8
+{
+	Damage,				// Damage after damage resistance
+	Healing,
+	HealingShield,
+	SetHealth,			// Direct modifications of stateful attributes, recorded as the resulting value
+	SetMinHealth,
+	SetMaxHealth,
+	SetExtraHealth,
+	SetShield,
+	SetMaxShield,
+	SetDamageResistance,
+	MAX
+};
+
+
+/**
+ * Input applied to a recorded attribute set and the layer values that resulted from it
+ */
+struct FHealthStreamEvent
+{
+public:
+	//
+	// Order in which the inputs began executing. Increases with the event index unless an input was recorded out of order.
+	//
+	uint32 Sequence{ 0 };
+
+	int32 SetIndex{ INDEX_NONE };
+	EHealthStreamEventKind Kind{ EHealthStreamEventKind::MAX };
+	float Value{ 0.0f };
+	bool bNotifiedOutOfHealth{ false };
+
+	float HealthAfter{ 0.0f };
+	float ExtraHealthAfter{ 0.0f };
+	float ShieldAfter{ 0.0f };
+
+};
+
+
+/**
+ * Ordered stream of health-affecting inputs applied to a set of health attribute sets
+ */
+struct GAHADDON_API FHealthStream
+{
+public:
+	//
+	// Values of each recorded attribute set when it was first affected
+	//
+	TArray<FHealthAttributeValues> InitialValues;
+
+	TArray<FHealthStreamEvent> Events;
+
+public:
+	FString ToString() const;
+	bool FromString(const FString& InString);
+
+	bool SaveToFile(const FString& FilePath) const;
+	bool LoadFromFile(const FString& FilePath);
+
+};
+
+
+/**
+ * Result of replaying a health stream
+ */
+struct FHealthStreamReplayResult
+{
+public:
+	int64 NumEvents{ 0 };
+	int32 NumOutOfHealth{ 0 };
+
+	//
+	// Events that broke an invariant checked independently of FHealthAttributeMath:
+	// clamp bounds, how each input can change the sum of Health, ExtraHealth and Shield,
+	// one out of health per death and increasing sequence numbers
+	//
+	int32 NumInvariantViolations{ 0 };
+
+	//
+	// Events whose replayed result differs from the recorded one
+	//
+	int32 NumDivergences{ 0 };
+
+	double Seconds{ 0.0 };
+
+};
+
+
+/**
+ * Recorder and replayer of the inputs applied to UHealthAttributeSet
+ * 
+ * Tips:
+ *	"GAHA.Stream.Record [ActorFilter]" starts recording attribute sets whose owner name contains the filter,
+ *	"GAHA.Stream.Stop [Name]" writes the stream to <ProfilingDir>/GAHA/Streams and
+ *	"GAHA.Stream.Replay <Name|Path> [Iterations]" replays it with FHealthAttributeMath, checks invariants and reports throughput.
+ *	Only inputs applied by gameplay effects are recorded. Base values set directly must be part of the initial values.
+ */
+namespace GAHAHealthStream
+{
+	extern GAHADDON_API bool bRecording;
+
+	FORCEINLINE bool IsRecording() { return bRecording; }
+
+	GAHADDON_API void StartRecording(const FString& ActorFilter);
+	GAHADDON_API void StopRecording(FHealthStream& OutStream);
+
+	/**
+	 * Start tracking the attribute set if it matches the filter
+	 */
+	void NotifyPreExecute(const UHealthAttributeSet* AttributeSet);
+
+	/**
+	 * Record an input applied to the attribute set
+	 */
+	void RecordExecute(const UHealthAttributeSet* AttributeSet, const FGameplayAttribute& Attribute, float Magnitude, bool bNotifiedOutOfHealth);
+
+	/**
+	 * Feed the stream into fresh attribute values
+	 */
+	GAHADDON_API FHealthStreamReplayResult Replay(const FHealthStream& Stream, int32 Iterations);
+}
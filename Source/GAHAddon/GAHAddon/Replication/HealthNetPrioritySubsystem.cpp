@@ -0,0 +1,251 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthNetPrioritySubsystem.h"
+
+#include "HealthComponent.h"
+
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+
+#if UE_WITH_IRIS
+#include "Iris/ReplicationSystem/ReplicationSystem.h"
+#include "Iris/ReplicationSystem/Prioritization/NetObjectPrioritizer.h"
+#include "Net/Iris/ReplicationSystem/ReplicationSystemUtil.h"
+#endif // #if UE_WITH_IRIS
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthNetPrioritySubsystem)
+
+
+namespace HealthNetPriority
+{
+	static float RecentChangeDuration{ 2.0f };
+	static FAutoConsoleVariableRef CVarRecentChangeDuration(
+		TEXT("GAHA.Iris.RecentChangeDuration"),
+		RecentChangeDuration,
+		TEXT("Seconds an actor stays urgent after its health or death state changed."));
+
+	static float LowHealthRatio{ 0.3f };
+	static FAutoConsoleVariableRef CVarLowHealthRatio(
+		TEXT("GAHA.Iris.LowHealthRatio"),
+		LowHealthRatio,
+		TEXT("Health ratio below which an actor stays urgent."));
+
+	static float UrgentPriority{ 1.5f };
+	static FAutoConsoleVariableRef CVarUrgentPriority(
+		TEXT("GAHA.Iris.UrgentPriority"),
+		UrgentPriority,
+		TEXT("Static replication priority of urgent health-bearing actors."));
+
+	static float IdlePriority{ 0.1f };
+	static FAutoConsoleVariableRef CVarIdlePriority(
+		TEXT("GAHA.Iris.IdlePriority"),
+		IdlePriority,
+		TEXT("Static replication priority of full-health idle actors."));
+
+	static FString DefaultPrioritizer;
+	static FAutoConsoleVariableRef CVarDefaultPrioritizer(
+		TEXT("GAHA.Iris.DefaultPrioritizer"),
+		DefaultPrioritizer,
+		TEXT("Name of the prioritizer restored for actors that are neither urgent nor idle. Uses the default spatial prioritizer if empty."));
+
+	static float UpdateInterval{ 0.25f };
+}
+
+
+bool UHealthNetPrioritySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_WITH_IRIS
+	return Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+void UHealthNetPrioritySubsystem::Deinitialize()
+{
+	if (auto* World{ GetWorld() })
+	{
+		World->GetTimerManager().ClearTimer(UpdateTimer);
+	}
+
+	Entries.Reset();
+	NumRecentlyChanged = 0;
+
+	Super::Deinitialize();
+}
+
+
+void UHealthNetPrioritySubsystem::NotifyHealthStateChanged(UHealthComponent* HealthComponent)
+{
+#if UE_WITH_IRIS
+	auto* World{ GetWorld() };
+	if (!HealthComponent || !World || !UE::Net::FReplicationSystemUtil::GetReplicationSystem(HealthComponent->GetOwner()))
+	{
+		return;
+	}
+
+	const auto CurrentTime{ World->GetTimeSeconds() };
+
+	auto& Entry{ Entries.FindOrAdd(HealthComponent) };
+	Entry.HealthComponent = HealthComponent;
+	Entry.LastChangeTime = CurrentTime;
+
+	const auto NewTier{ EvaluateTier(Entry, CurrentTime) };
+	if (NewTier != Entry.Tier)
+	{
+		Entry.Tier = NewTier;
+		ApplyTier(HealthComponent, NewTier);
+	}
+
+	++NumRecentlyChanged;
+
+	if (!UpdateTimer.IsValid())
+	{
+		World->GetTimerManager().SetTimer(UpdateTimer, this, &ThisClass::HandleUpdateTimer, HealthNetPriority::UpdateInterval, true);
+	}
+#endif // #if UE_WITH_IRIS
+}
+
+void UHealthNetPrioritySubsystem::RemoveHealthComponent(UHealthComponent* HealthComponent)
+{
+	Entries.Remove(HealthComponent);
+}
+
+
+EHealthNetPriorityTier UHealthNetPrioritySubsystem::EvaluateTier(const FEntry& Entry, double CurrentTime) const
+{
+	const auto* HealthComponent{ Entry.HealthComponent.Get() };
+	if (!HealthComponent)
+	{
+		return EHealthNetPriorityTier::Default;
+	}
+
+	if ((CurrentTime - Entry.LastChangeTime) < HealthNetPriority::RecentChangeDuration)
+	{
+		return EHealthNetPriorityTier::Urgent;
+	}
+
+	if (HealthComponent->IsDeadOrDying())
+	{
+		return EHealthNetPriorityTier::Default;
+	}
+
+	const auto MaxHealth{ HealthComponent->GetMaxHealth() };
+	if ((MaxHealth > 0.0f) && ((HealthComponent->GetHealth() / MaxHealth) < HealthNetPriority::LowHealthRatio))
+	{
+		return EHealthNetPriorityTier::Urgent;
+	}
+
+	if (HealthComponent->GetTotalHealth() >= HealthComponent->GetTotalMaxHealth())
+	{
+		return EHealthNetPriorityTier::Idle;
+	}
+
+	return EHealthNetPriorityTier::Default;
+}
+
+void UHealthNetPrioritySubsystem::ApplyTier(UHealthComponent* HealthComponent, EHealthNetPriorityTier Tier) const
+{
+#if UE_WITH_IRIS
+	TArray<AActor*, TInlineAllocator<2>> ReplicatingActors;
+	HealthComponent->GetReplicatingActors(ReplicatingActors);
+
+	for (const auto* Actor : ReplicatingActors)
+	{
+		// The priority applies to everything the actor replicates, so only owners without replicated movement are throttled.
+		// The owner of the ability system, e.g. a player state, is never throttled.
+
+		auto ActorTier{ Tier };
+		if ((ActorTier == EHealthNetPriorityTier::Idle) && ((Actor != HealthComponent->GetOwner()) || Actor->IsReplicatingMovement()))
+		{
+			ActorTier = EHealthNetPriorityTier::Default;
+		}
+
+		auto* ReplicationSystem{ UE::Net::FReplicationSystemUtil::GetReplicationSystem(Actor) };
+		if (!ReplicationSystem)
+		{
+			continue;
+		}
+
+		const auto Handle{ UE::Net::FReplicationSystemUtil::GetNetRefHandle(Actor) };
+		if (!Handle.IsValid())
+		{
+			continue;
+		}
+
+		switch (ActorTier)
+		{
+		case EHealthNetPriorityTier::Urgent:
+			ReplicationSystem->SetStaticPriority(Handle, HealthNetPriority::UrgentPriority);
+			break;
+
+		case EHealthNetPriorityTier::Idle:
+			ReplicationSystem->SetStaticPriority(Handle, HealthNetPriority::IdlePriority);
+			break;
+
+		default:
+		{
+			auto PrioritizerHandle{ UE::Net::DefaultSpatialNetObjectPrioritizerHandle };
+
+			if (!HealthNetPriority::DefaultPrioritizer.IsEmpty())
+			{
+				const auto NamedHandle{ ReplicationSystem->GetPrioritizerHandle(FName(*HealthNetPriority::DefaultPrioritizer)) };
+				if (NamedHandle != UE::Net::InvalidNetObjectPrioritizerHandle)
+				{
+					PrioritizerHandle = NamedHandle;
+				}
+			}
+
+			ReplicationSystem->SetPrioritizer(Handle, PrioritizerHandle);
+			break;
+		}
+		}
+	}
+#endif // #if UE_WITH_IRIS
+}
+
+void UHealthNetPrioritySubsystem::HandleUpdateTimer()
+{
+	auto* World{ GetWorld() };
+	if (!World)
+	{
+		return;
+	}
+
+	const auto CurrentTime{ World->GetTimeSeconds() };
+
+	NumRecentlyChanged = 0;
+
+	for (auto It{ Entries.CreateIterator() }; It; ++It)
+	{
+		auto& Entry{ It.Value() };
+
+		auto* HealthComponent{ Entry.HealthComponent.Get() };
+		if (!HealthComponent)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if ((CurrentTime - Entry.LastChangeTime) < HealthNetPriority::RecentChangeDuration)
+		{
+			++NumRecentlyChanged;
+			continue;
+		}
+
+		const auto NewTier{ EvaluateTier(Entry, CurrentTime) };
+		if (NewTier != Entry.Tier)
+		{
+			Entry.Tier = NewTier;
+			ApplyTier(HealthComponent, NewTier);
+		}
+	}
+
+	// Stop updating while nothing can be demoted
+
+	if (NumRecentlyChanged <= 0)
+	{
+		World->GetTimerManager().ClearTimer(UpdateTimer);
+	}
+}
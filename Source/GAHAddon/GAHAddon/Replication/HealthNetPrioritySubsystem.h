@@ -0,0 +1,88 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "HealthNetPrioritySubsystem.generated.h"
+
+class UHealthComponent;
+
+
+/**
+ * Replication priority tier of a health-bearing actor
+ */
+enum class EHealthNetPriorityTier : uint8
+{
+	// Use the default prioritizer of the replication system
+	Default,
+
+	// Health or death state changed recently, or health is low
+	Urgent,
+
+	// Full health and no recent changes
+	Idle,
+};
+
+
+/**
+ * Subsystem that adjusts Iris replication priority of health-bearing actors on the server.
+ * 
+ * Tips:
+ *	Only the owners of health components with bUseHealthNetPriority are managed, all other actors keep
+ *	the distance based prioritization of the replication system.
+ *	Actors whose health or death state changed recently, or whose health is below "GAHA.Iris.LowHealthRatio",
+ *	replicate with "GAHA.Iris.UrgentPriority" and full-health idle actors with "GAHA.Iris.IdlePriority".
+ *	The idle priority only applies to owners that do not replicate movement, since it throttles all of their properties.
+ *	All others are returned to the prioritizer named by "GAHA.Iris.DefaultPrioritizer" (the default spatial prioritizer if empty).
+ *	Does nothing when the world does not replicate with Iris.
+ */
+UCLASS()
+class GAHADDON_API UHealthNetPrioritySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	UHealthNetPrioritySubsystem() {}
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+protected:
+	struct FEntry
+	{
+		TWeakObjectPtr<UHealthComponent> HealthComponent;
+
+		double LastChangeTime{ 0.0 };
+
+		EHealthNetPriorityTier Tier{ EHealthNetPriorityTier::Default };
+	};
+
+	TMap<TObjectKey<UHealthComponent>, FEntry> Entries;
+
+	//
+	// Number of entries in the urgent tier due to a recent change
+	//
+	int32 NumRecentlyChanged{ 0 };
+
+	FTimerHandle UpdateTimer;
+
+public:
+	/**
+	 * Notify that the replicated health state of the component has changed
+	 */
+	void NotifyHealthStateChanged(UHealthComponent* HealthComponent);
+
+	/**
+	 * Stop managing the priority of the component
+	 */
+	void RemoveHealthComponent(UHealthComponent* HealthComponent);
+
+protected:
+	EHealthNetPriorityTier EvaluateTier(const FEntry& Entry, double CurrentTime) const;
+	void ApplyTier(UHealthComponent* HealthComponent, EHealthNetPriorityTier Tier) const;
+
+	void HandleUpdateTimer();
+
+};
@@ -0,0 +1,92 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthPushModel.h"
+
+#if GAHA_WITH_PUSH_MODEL_AUDIT
+
+#include "GAHAddonLogs.h"
+
+#include "HAL/IConsoleManager.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UnrealType.h"
+
+
+namespace GAHAPushModelAudit
+{
+	static TAutoConsoleVariable<bool> CVarAudit(
+		TEXT("GAHA.PushModel.Audit"),
+		false,
+		TEXT("Report push based replicated health properties that changed without being marked dirty."));
+
+	static TMap<TObjectKey<UObject>, TMap<FName, FString>> RecordedValues;
+
+
+	static FString ExportPropertyValue(const UObject* Object, const FProperty* Property)
+	{
+		FString Value;
+		Property->ExportTextItem_Direct(Value, Property->ContainerPtrToValuePtr<void>(Object), nullptr, nullptr, PPF_None);
+		return Value;
+	}
+
+	bool IsEnabled()
+	{
+		return CVarAudit.GetValueOnGameThread();
+	}
+
+	void RecordMarkedDirty(const UObject* Object, FName PropertyName)
+	{
+		if (!Object || !IsEnabled())
+		{
+			return;
+		}
+
+		if (const auto* Property{ FindFProperty<FProperty>(Object->GetClass(), PropertyName) })
+		{
+			RecordedValues.FindOrAdd(Object).Add(PropertyName, ExportPropertyValue(Object, Property));
+		}
+	}
+
+	void AuditObject(const UObject* Object, const UClass* PropertyOwnerClass)
+	{
+		if (!Object || !PropertyOwnerClass || !IsEnabled())
+		{
+			return;
+		}
+
+		auto& ObjectValues{ RecordedValues.FindOrAdd(Object) };
+
+		for (TFieldIterator<FProperty> It(PropertyOwnerClass, EFieldIteratorFlags::ExcludeSuper); It; ++It)
+		{
+			const auto* Property{ *It };
+
+			if (!Property->HasAnyPropertyFlags(CPF_Net))
+			{
+				continue;
+			}
+
+			auto CurrentValue{ ExportPropertyValue(Object, Property) };
+
+			if (auto* RecordedValue{ ObjectValues.Find(Property->GetFName()) })
+			{
+				if (!RecordedValue->Equals(CurrentValue, ESearchCase::CaseSensitive))
+				{
+					UE_LOG(LogGAHA, Warning, TEXT("GAHAPushModelAudit: Property [%s] of [%s] changed without being marked dirty (%s -> %s)."),
+						*Property->GetName(), *GetPathNameSafe(Object), **RecordedValue, *CurrentValue);
+
+					*RecordedValue = MoveTemp(CurrentValue);
+				}
+			}
+			else
+			{
+				ObjectValues.Add(Property->GetFName(), MoveTemp(CurrentValue));
+			}
+		}
+	}
+
+	void ForgetObject(const UObject* Object)
+	{
+		RecordedValues.Remove(Object);
+	}
+}
+
+#endif // #if GAHA_WITH_PUSH_MODEL_AUDIT
@@ -0,0 +1,56 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Net/Core/PushModel/PushModel.h"
+
+
+#if !UE_BUILD_SHIPPING
+#define GAHA_WITH_PUSH_MODEL_AUDIT 1
+#else
+#define GAHA_WITH_PUSH_MODEL_AUDIT 0
+#endif
+
+
+#if GAHA_WITH_PUSH_MODEL_AUDIT
+
+/**
+ * Debug helpers to find mutations of push based replicated properties that were not marked dirty.
+ * 
+ * Tips:
+ *	Enabled by "GAHA.PushModel.Audit 1".
+ *	Every value marked dirty through GAHA_MARK_PROPERTY_DIRTY is recorded, and AuditObject reports
+ *	replicated properties whose current value differs from the last recorded one.
+ */
+namespace GAHAPushModelAudit
+{
+	GAHADDON_API bool IsEnabled();
+
+	/**
+	 * Record the current value of the property marked dirty
+	 */
+	GAHADDON_API void RecordMarkedDirty(const UObject* Object, FName PropertyName);
+
+	/**
+	 * Report replicated properties declared in PropertyOwnerClass that changed without being marked dirty
+	 */
+	GAHADDON_API void AuditObject(const UObject* Object, const UClass* PropertyOwnerClass);
+
+	/**
+	 * Discard the recorded values of the object
+	 */
+	GAHADDON_API void ForgetObject(const UObject* Object);
+}
+
+#define GAHA_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) \
+	do \
+	{ \
+		MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object); \
+		GAHAPushModelAudit::RecordMarkedDirty(Object, GET_MEMBER_NAME_CHECKED(ClassName, PropertyName)); \
+	} while (0)
+
+#else
+
+#define GAHA_MARK_PROPERTY_DIRTY(ClassName, PropertyName, Object) MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object)
+
+#endif
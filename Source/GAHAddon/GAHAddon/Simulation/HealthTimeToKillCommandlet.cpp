@@ -0,0 +1,290 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTimeToKillCommandlet.h"
+
+#include "Attribute/HealthAttributeMath.h"
+#include "Execution/DamageExecution.h"
+#include "Execution/HealthExecutionModifier.h"
+#include "HealthData.h"
+#include "GAHAddonLogs.h"
+
+#include "Async/ParallelFor.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthTimeToKillCommandlet)
+
+
+namespace GAHATimeToKill
+{
+	struct FWeapon
+	{
+		float DamageMin{ 10.0f };
+		float DamageMax{ 10.0f };
+		float HitChance{ 1.0f };
+		float CritChance{ 0.0f };
+		float CritMultiplier{ 2.0f };
+		float FireInterval{ 0.1f };
+	};
+
+	struct FSimulationConfig
+	{
+		FWeapon Weapon;
+		const UDamageExecution* DamageExecution{ nullptr };
+		FGameplayTag EffectTag;
+		int64 Trials{ 1000000 };
+		int32 MaxShots{ 1000 };
+		int32 Seed{ 0 };
+	};
+
+	static constexpr int64 TrialsPerChunk{ 16384 };
+
+	/**
+	 * Returns the number of shots needed to run the profile out of health, or MaxShots + 1 if it survives
+	 */
+	static int32 RunTrial(const FHealthAttributeValues& Profile, const FSimulationConfig& Config, FRandomStream& Random)
+	{
+		auto Values{ Profile };
+
+		FHealthExecutionSimulationParams SimulationParams;
+		SimulationParams.EffectTag = Config.EffectTag;
+
+		for (auto Shot{ 1 }; Shot <= Config.MaxShots; ++Shot)
+		{
+			if (Random.GetFraction() >= Config.Weapon.HitChance)
+			{
+				continue;
+			}
+
+			auto BaseDamage{ Random.FRandRange(Config.Weapon.DamageMin, Config.Weapon.DamageMax) };
+
+			if (Random.GetFraction() < Config.Weapon.CritChance)
+			{
+				BaseDamage *= Config.Weapon.CritMultiplier;
+			}
+
+			// Same steps as UDamageExecution, UHealthAttributeSet::PreGameplayEffectExecute and PostGameplayEffectExecute
+
+			SimulationParams.TargetValues = Values;
+
+			const auto Damage{ Config.DamageExecution->Simulate(BaseDamage, SimulationParams) };
+			if (Damage <= 0.0f)
+			{
+				continue;
+			}
+
+			FHealthAttributeMath::ApplyDamage(Values, FHealthAttributeMath::ApplyDamageResistance(Damage, Values.DamageResistance));
+
+			if (FHealthAttributeMath::IsOutOfHealth(Values.Health))
+			{
+				return Shot;
+			}
+		}
+
+		return Config.MaxShots + 1;
+	}
+
+	/**
+	 * Returns the histogram of shots to kill, the last bin counting the trials that survived
+	 */
+	static TArray<int64> SimulateProfile(const FHealthAttributeValues& Profile, const FSimulationConfig& Config)
+	{
+		const auto NumChunks{ static_cast<int32>((Config.Trials + TrialsPerChunk - 1) / TrialsPerChunk) };
+
+		TArray<TArray<int64>> ChunkHistograms;
+		ChunkHistograms.SetNum(NumChunks);
+
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			auto& Histogram{ ChunkHistograms[ChunkIndex] };
+			Histogram.SetNumZeroed(Config.MaxShots + 2);
+
+			FRandomStream Random(HashCombine(GetTypeHash(Config.Seed), GetTypeHash(ChunkIndex)));
+
+			const auto FirstTrial{ static_cast<int64>(ChunkIndex) * TrialsPerChunk };
+			const auto NumTrials{ FMath::Min(TrialsPerChunk, Config.Trials - FirstTrial) };
+
+			for (int64 Trial{ 0 }; Trial < NumTrials; ++Trial)
+			{
+				++Histogram[RunTrial(Profile, Config, Random)];
+			}
+		});
+
+		TArray<int64> Histogram;
+		Histogram.SetNumZeroed(Config.MaxShots + 2);
+
+		for (const auto& ChunkHistogram : ChunkHistograms)
+		{
+			for (auto Bin{ 0 }; Bin < Histogram.Num(); ++Bin)
+			{
+				Histogram[Bin] += ChunkHistogram[Bin];
+			}
+		}
+
+		return Histogram;
+	}
+
+	static int32 GetPercentileShots(const TArray<int64>& Histogram, int64 Trials, double Percentile)
+	{
+		const auto Threshold{ static_cast<int64>(FMath::CeilToDouble(Trials * Percentile)) };
+
+		int64 Cumulative{ 0 };
+		for (auto Bin{ 0 }; Bin < Histogram.Num(); ++Bin)
+		{
+			Cumulative += Histogram[Bin];
+
+			if (Cumulative >= Threshold)
+			{
+				return Bin;
+			}
+		}
+
+		return Histogram.Num() - 1;
+	}
+}
+
+
+UHealthTimeToKillCommandlet::UHealthTimeToKillCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UHealthTimeToKillCommandlet::Main(const FString& Params)
+{
+	using namespace GAHATimeToKill;
+
+	FString HealthDataPaths;
+	if (!FParse::Value(*Params, TEXT("HealthData="), HealthDataPaths, false))
+	{
+		UE_LOG(LogGAHA, Error, TEXT("HealthTimeToKill: -HealthData=<ObjectPath>[+<ObjectPath>...] is required."));
+		return 1;
+	}
+
+	auto DamageResistance{ 0.0f };
+	FParse::Value(*Params, TEXT("DamageResistance="), DamageResistance);
+
+	// Health profiles
+
+	TArray<FString> ProfilePaths;
+	HealthDataPaths.ParseIntoArray(ProfilePaths, TEXT("+"));
+
+	TArray<TPair<FString, FHealthAttributeValues>> Profiles;
+
+	for (const auto& ProfilePath : ProfilePaths)
+	{
+		const auto* HealthData{ LoadObject<UHealthData>(nullptr, *ProfilePath) };
+		if (!HealthData)
+		{
+			UE_LOG(LogGAHA, Error, TEXT("HealthTimeToKill: Failed to load health data %s."), *ProfilePath);
+			return 1;
+		}
+
+		FHealthAttributeValues Values;
+		Values.Health = HealthData->Health;
+		Values.MinHealth = HealthData->MinHealth;
+		Values.MaxHealth = HealthData->MaxHealth;
+		Values.ExtraHealth = HealthData->ExtraHealth;
+		Values.Shield = HealthData->Shield;
+		Values.MaxShield = HealthData->MaxShield;
+		Values.DamageResistance = DamageResistance;
+
+		Profiles.Emplace(HealthData->GetName(), Values);
+	}
+
+	// Weapon and simulation settings
+
+	FSimulationConfig Config;
+	FParse::Value(*Params, TEXT("DamageMin="), Config.Weapon.DamageMin);
+	FParse::Value(*Params, TEXT("DamageMax="), Config.Weapon.DamageMax);
+	FParse::Value(*Params, TEXT("HitChance="), Config.Weapon.HitChance);
+	FParse::Value(*Params, TEXT("CritChance="), Config.Weapon.CritChance);
+	FParse::Value(*Params, TEXT("CritMultiplier="), Config.Weapon.CritMultiplier);
+	FParse::Value(*Params, TEXT("FireInterval="), Config.Weapon.FireInterval);
+	FParse::Value(*Params, TEXT("Trials="), Config.Trials);
+	FParse::Value(*Params, TEXT("MaxShots="), Config.MaxShots);
+	FParse::Value(*Params, TEXT("Seed="), Config.Seed);
+
+	Config.Weapon.DamageMax = FMath::Max(Config.Weapon.DamageMin, Config.Weapon.DamageMax);
+	Config.Trials = FMath::Max<int64>(Config.Trials, 1);
+	Config.MaxShots = FMath::Max(Config.MaxShots, 1);
+
+	FString EffectTagName;
+	if (FParse::Value(*Params, TEXT("EffectTag="), EffectTagName))
+	{
+		Config.EffectTag = FGameplayTag::RequestGameplayTag(FName(*EffectTagName), false);
+	}
+
+	Config.DamageExecution = GetDefault<UDamageExecution>();
+
+	FString DamageExecutionPath;
+	if (FParse::Value(*Params, TEXT("DamageExecution="), DamageExecutionPath))
+	{
+		auto* DamageExecutionClass{ LoadClass<UDamageExecution>(nullptr, *DamageExecutionPath) };
+		if (!DamageExecutionClass)
+		{
+			UE_LOG(LogGAHA, Error, TEXT("HealthTimeToKill: Failed to load damage execution %s."), *DamageExecutionPath);
+			return 1;
+		}
+
+		Config.DamageExecution = GetDefault<UDamageExecution>(DamageExecutionClass);
+	}
+
+	// Simulate every profile
+
+	FString OutputPath{ FPaths::ProfilingDir() / TEXT("GAHA") / TEXT("TimeToKill.csv") };
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString Csv{ TEXT("Profile,ShotsToKill,TimeToKill,Count,Probability,Cumulative" LINE_TERMINATOR) };
+
+	for (const auto& [ProfileName, Profile] : Profiles)
+	{
+		const auto StartTime{ FPlatformTime::Seconds() };
+		const auto Histogram{ SimulateProfile(Profile, Config) };
+		const auto ElapsedSeconds{ FPlatformTime::Seconds() - StartTime };
+
+		const auto Survived{ Histogram.Last() };
+		auto MeanShots{ 0.0 };
+		int64 Cumulative{ 0 };
+
+		for (auto Shots{ 1 }; Shots <= Config.MaxShots; ++Shots)
+		{
+			const auto Count{ Histogram[Shots] };
+			Cumulative += Count;
+
+			if (Count == 0)
+			{
+				continue;
+			}
+
+			MeanShots += static_cast<double>(Shots) * Count;
+
+			Csv += FString::Printf(TEXT("%s,%d,%.4f,%lld,%.6f,%.6f" LINE_TERMINATOR), *ProfileName, Shots, (Shots - 1) * Config.Weapon.FireInterval,
+				Count, static_cast<double>(Count) / Config.Trials, static_cast<double>(Cumulative) / Config.Trials);
+		}
+
+		const auto Killed{ Config.Trials - Survived };
+		MeanShots = (Killed > 0) ? (MeanShots / Killed) : 0.0;
+
+		const auto MedianShots{ GetPercentileShots(Histogram, Config.Trials, 0.5) };
+		const auto P90Shots{ GetPercentileShots(Histogram, Config.Trials, 0.9) };
+
+		UE_LOG(LogGAHA, Display, TEXT("HealthTimeToKill: %s: mean %.2f shots (%.3f s), median %d, p90 %d, %lld of %lld trials survived %d shots. %.0f trials/s"),
+			*ProfileName, MeanShots, (MeanShots - 1.0) * Config.Weapon.FireInterval, MedianShots, P90Shots, Survived, Config.Trials, Config.MaxShots,
+			(ElapsedSeconds > 0.0) ? (Config.Trials / ElapsedSeconds) : 0.0);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogGAHA, Error, TEXT("HealthTimeToKill: Failed to write %s."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogGAHA, Display, TEXT("HealthTimeToKill: Histograms written to %s."), *OutputPath);
+
+	return 0;
+}
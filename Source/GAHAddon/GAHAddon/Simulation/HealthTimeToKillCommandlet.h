@@ -0,0 +1,32 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "HealthTimeToKillCommandlet.generated.h"
+
+
+/**
+ * Commandlet that estimates shots and time to kill of a weapon against health profiles with a Monte Carlo simulation
+ *
+ * Tips:
+ *	Usage: -run=HealthTimeToKill -HealthData=<ObjectPath>[+<ObjectPath>...] [-DamageResistance=0] [-DamageExecution=<ClassPath>]
+ *	[-EffectTag=<Tag>] [-DamageMin=10] [-DamageMax=10] [-HitChance=1] [-CritChance=0] [-CritMultiplier=2]
+ *	[-FireInterval=0.1] [-Trials=1000000] [-MaxShots=1000] [-Seed=0] [-Output=<CsvPath>]
+ *
+ *	Every shot hits with HitChance, rolls a uniform base damage and is multiplied by CritMultiplier with CritChance.
+ *	Hits run through UDamageExecution::Simulate and FHealthAttributeMath, the same modifier loop and math as the runtime path.
+ *	Modifiers that only override ModifierExecution cannot run without an ability system, they are skipped with a warning.
+ *	Trials are split into chunks with their own seeded random stream, so results do not depend on the number of threads.
+ */
+UCLASS()
+class UHealthTimeToKillCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UHealthTimeToKillCommandlet(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual int32 Main(const FString& Params) override;
+
+};
@@ -0,0 +1,32 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthComponentRegistrySubsystem.h"
+
+#include "HealthComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthComponentRegistrySubsystem)
+
+
+void UHealthComponentRegistrySubsystem::RegisterHealthComponent(UHealthComponent* HealthComponent)
+{
+	if (!HealthComponent)
+	{
+		return;
+	}
+
+	auto bAlreadyRegistered{ false };
+	HealthComponents.Add(HealthComponent, &bAlreadyRegistered);
+
+	if (!bAlreadyRegistered)
+	{
+		OnHealthComponentRegistered.Broadcast(HealthComponent);
+	}
+}
+
+void UHealthComponentRegistrySubsystem::UnregisterHealthComponent(UHealthComponent* HealthComponent)
+{
+	if (HealthComponents.Remove(HealthComponent) > 0)
+	{
+		OnHealthComponentUnregistered.Broadcast(HealthComponent);
+	}
+}
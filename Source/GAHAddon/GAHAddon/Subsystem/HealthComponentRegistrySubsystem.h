@@ -0,0 +1,48 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "HealthComponentRegistrySubsystem.generated.h"
+
+class UHealthComponent;
+
+
+/**
+ * Delegate to notify that a health component has been registered or unregistered
+ */
+DECLARE_MULTICAST_DELEGATE_OneParam(FHealthComponentRegistryDelegate, UHealthComponent* /*HealthComponent*/);
+
+
+/**
+ * Subsystem that keeps track of all health components that have begun play in the world
+ */
+UCLASS()
+class GAHADDON_API UHealthComponentRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	UHealthComponentRegistrySubsystem() {}
+
+protected:
+	//
+	// Registered components, kept in a set so that actors spawning and despawning in crowds do not search the whole registry
+	//
+	UPROPERTY(Transient)
+	TSet<TObjectPtr<UHealthComponent>> HealthComponents;
+
+public:
+	FHealthComponentRegistryDelegate OnHealthComponentRegistered;
+	FHealthComponentRegistryDelegate OnHealthComponentUnregistered;
+
+public:
+	void RegisterHealthComponent(UHealthComponent* HealthComponent);
+	void UnregisterHealthComponent(UHealthComponent* HealthComponent);
+
+	/**
+	 * Returns the registered components, in no particular order
+	 */
+	const TSet<TObjectPtr<UHealthComponent>>& GetHealthComponents() const { return HealthComponents; }
+
+};
@@ -0,0 +1,142 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthDataPreloadSubsystem.h"
+
+#include "HealthData.h"
+#include "GAHAddonLogs.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthDataPreloadSubsystem)
+
+
+void UHealthDataPreloadSubsystem::Deinitialize()
+{
+	ReleasePreloadedHealthData();
+
+	Super::Deinitialize();
+}
+
+
+void UHealthDataPreloadSubsystem::PreloadHealthData(const TArray<TSoftObjectPtr<UHealthData>>& HealthDatas, const FHealthDataPreloadedDelegate& OnPreloaded)
+{
+	TArray<FSoftObjectPath> AssetPaths;
+
+	for (const auto& HealthData : HealthDatas)
+	{
+		if (!HealthData.IsNull())
+		{
+			AssetPaths.AddUnique(HealthData.ToSoftObjectPath());
+		}
+	}
+
+	if (AssetPaths.IsEmpty())
+	{
+		OnPreloaded.ExecuteIfBound();
+		return;
+	}
+
+	// Load the health data first and then the assets they reference, since the references are unknown until the data is loaded.
+
+	auto NewHandle{ StreamableManager.RequestAsyncLoad(AssetPaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority) };
+	if (!NewHandle.IsValid())
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UHealthDataPreloadSubsystem::PreloadHealthData: Failed to request async load of %d health data."), AssetPaths.Num());
+
+		OnPreloaded.ExecuteIfBound();
+		return;
+	}
+
+	PreloadHandles.Add(NewHandle);
+
+	if (NewHandle->HasLoadCompleted())
+	{
+		HandleHealthDataPreloaded(HealthDatas, OnPreloaded);
+	}
+	else
+	{
+		NewHandle->BindCompleteDelegate(FStreamableDelegate::CreateUObject(this, &ThisClass::HandleHealthDataPreloaded, HealthDatas, OnPreloaded));
+	}
+}
+
+void UHealthDataPreloadSubsystem::ReleasePreloadedHealthData()
+{
+	for (const auto& Handle : PreloadHandles)
+	{
+		if (Handle.IsValid())
+		{
+			Handle->ReleaseHandle();
+		}
+	}
+
+	PreloadHandles.Reset();
+}
+
+TSharedPtr<FStreamableHandle> UHealthDataPreloadSubsystem::RequestHealthDataAssets(const UHealthData* HealthData, FStreamableDelegate OnLoaded)
+{
+	return LoadHealthDataAssets(StreamableManager, HealthData, OnLoaded);
+}
+
+TSharedPtr<FStreamableHandle> UHealthDataPreloadSubsystem::LoadHealthDataAssets(FStreamableManager& InStreamableManager, const UHealthData* HealthData, FStreamableDelegate OnLoaded)
+{
+	if (!HealthData)
+	{
+		return nullptr;
+	}
+
+	TArray<FSoftObjectPath> AssetPaths;
+	HealthData->GetAssetsToLoad(AssetPaths);
+
+	if (AssetPaths.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	// Loaded assets are still held by a handle since nothing else may keep them until they are used
+
+	if (HealthData->AreAssetsLoaded())
+	{
+		return InStreamableManager.RequestSyncLoad(AssetPaths);
+	}
+
+	return InStreamableManager.RequestAsyncLoad(AssetPaths, OnLoaded, FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UHealthDataPreloadSubsystem::HandleHealthDataPreloaded(TArray<TSoftObjectPtr<UHealthData>> HealthDatas, FHealthDataPreloadedDelegate OnPreloaded)
+{
+	TArray<FSoftObjectPath> AssetPaths;
+
+	for (const auto& HealthData : HealthDatas)
+	{
+		if (const auto* LoadedHealthData{ HealthData.Get() })
+		{
+			LoadedHealthData->GetAssetsToLoad(AssetPaths);
+		}
+	}
+
+	if (AssetPaths.IsEmpty())
+	{
+		OnPreloaded.ExecuteIfBound();
+		return;
+	}
+
+	auto NewHandle{ StreamableManager.RequestAsyncLoad(AssetPaths, FStreamableDelegate::CreateWeakLambda(this, [OnPreloaded]() { OnPreloaded.ExecuteIfBound(); }), FStreamableManager::AsyncLoadHighPriority) };
+	if (NewHandle.IsValid())
+	{
+		PreloadHandles.Add(NewHandle);
+	}
+	else
+	{
+		OnPreloaded.ExecuteIfBound();
+	}
+}
+
+
+UHealthDataPreloadSubsystem* UHealthDataPreloadSubsystem::Get(const UObject* WorldContextObject)
+{
+	const auto* World{ WorldContextObject ? WorldContextObject->GetWorld() : nullptr };
+	const auto* GameInstance{ World ? World->GetGameInstance() : nullptr };
+
+	return GameInstance ? GameInstance->GetSubsystem<UHealthDataPreloadSubsystem>() : nullptr;
+}
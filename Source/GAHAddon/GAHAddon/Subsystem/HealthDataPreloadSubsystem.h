@@ -0,0 +1,74 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "Engine/StreamableManager.h"
+
+#include "HealthDataPreloadSubsystem.generated.h"
+
+class UHealthData;
+
+
+/**
+ * Delegate to notify that the requested health data has finished preloading
+ */
+DECLARE_DYNAMIC_DELEGATE(FHealthDataPreloadedDelegate);
+
+
+/**
+ * Subsystem that streams health data and the assets they softly reference ahead of time.
+ * 
+ * Tips:
+ *	Call PreloadHealthData before a wave spawns so that HealthComponent does not have to wait for the load at initialization.
+ */
+UCLASS()
+class GAHADDON_API UHealthDataPreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+public:
+	UHealthDataPreloadSubsystem() {}
+
+	virtual void Deinitialize() override;
+
+protected:
+	FStreamableManager StreamableManager;
+
+	//
+	// Handles that keep the preloaded health data in memory
+	//
+	TArray<TSharedPtr<FStreamableHandle>> PreloadHandles;
+
+public:
+	/**
+	 * Asynchronously load health data and the assets they reference and keep them in memory until released
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health", Meta = (AutoCreateRefTerm = "OnPreloaded"))
+	void PreloadHealthData(const TArray<TSoftObjectPtr<UHealthData>>& HealthDatas, const FHealthDataPreloadedDelegate& OnPreloaded);
+
+	/**
+	 * Release all health data kept in memory by PreloadHealthData
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void ReleasePreloadedHealthData();
+
+	/**
+	 * Asynchronously load the assets referenced by the health data, see LoadHealthDataAssets
+	 */
+	TSharedPtr<FStreamableHandle> RequestHealthDataAssets(const UHealthData* HealthData, FStreamableDelegate OnLoaded);
+
+	/**
+	 * Asynchronously load the assets referenced by the health data with the streamable manager.
+	 * Returns a handle that keeps the assets loaded, already completed without calling OnLoaded if they were loaded,
+	 * or nullptr if the health data does not reference any asset or the request failed.
+	 */
+	static TSharedPtr<FStreamableHandle> LoadHealthDataAssets(FStreamableManager& InStreamableManager, const UHealthData* HealthData, FStreamableDelegate OnLoaded);
+
+protected:
+	void HandleHealthDataPreloaded(TArray<TSoftObjectPtr<UHealthData>> HealthDatas, FHealthDataPreloadedDelegate OnPreloaded);
+
+public:
+	static UHealthDataPreloadSubsystem* Get(const UObject* WorldContextObject);
+
+};
@@ -0,0 +1,109 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthDeathQueueSubsystem.h"
+
+#include "GAHAddonLogs.h"
+#include "GAHAddonStats.h"
+
+#include "HAL/IConsoleManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthDeathQueueSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Death Queue"), STAT_GAHA_DeathQueue, STATGROUP_GAHA);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending Deaths"), STAT_GAHA_PendingDeaths, STATGROUP_GAHA);
+
+
+namespace GAHADeathQueue
+{
+	static float BudgetMs{ 1.0f };
+	static FAutoConsoleVariableRef CVarBudgetMs(
+		TEXT("GAHA.DeathQueue.BudgetMs"),
+		BudgetMs,
+		TEXT("Milliseconds per frame spent processing queued deaths."));
+
+	static int32 MinPerFrame{ 1 };
+	static FAutoConsoleVariableRef CVarMinPerFrame(
+		TEXT("GAHA.DeathQueue.MinPerFrame"),
+		MinPerFrame,
+		TEXT("Number of queued deaths processed each frame regardless of the budget, at least 1."));
+}
+
+
+void UHealthDeathQueueSubsystem::Deinitialize()
+{
+	PendingDeaths.Empty();
+	HeadIndex = 0;
+
+	Super::Deinitialize();
+}
+
+void UHealthDeathQueueSubsystem::Tick(float DeltaTime)
+{
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_DeathQueue);
+
+	ProcessPendingDeaths(GAHADeathQueue::BudgetMs / 1000.0, GAHADeathQueue::MinPerFrame);
+
+	SET_DWORD_STAT(STAT_GAHA_PendingDeaths, GetNumPendingDeaths());
+}
+
+
+void UHealthDeathQueueSubsystem::EnqueueDeath(UHealthComponent* HealthComponent, FHealthOutOfHealthInfo&& Info)
+{
+	check(HealthComponent);
+
+	auto& PendingDeath{ PendingDeaths.AddDefaulted_GetRef() };
+	PendingDeath.HealthComponent = HealthComponent;
+	PendingDeath.Info = MoveTemp(Info);
+}
+
+int32 UHealthDeathQueueSubsystem::ProcessPendingDeaths(double BudgetSeconds, int32 MinDeaths)
+{
+	const auto StartTime{ FPlatformTime::Seconds() };
+	auto NumProcessed{ 0 };
+
+	// Always make progress, otherwise a zero budget would leave the owners dying forever
+
+	MinDeaths = FMath::Max(MinDeaths, 1);
+
+	// Deaths caused by the processing are appended to the array, so the entry is moved out before it is processed
+
+	while (HeadIndex < PendingDeaths.Num())
+	{
+		if ((NumProcessed >= MinDeaths) && ((FPlatformTime::Seconds() - StartTime) >= BudgetSeconds))
+		{
+			break;
+		}
+
+		auto PendingDeath{ MoveTemp(PendingDeaths[HeadIndex]) };
+		++HeadIndex;
+
+		// Skip components that were destroyed, reset or healed while waiting
+
+		auto* HealthComponent{ PendingDeath.HealthComponent.Get() };
+		if (!HealthComponent || !HealthComponent->ProcessPendingDeath(PendingDeath.Info))
+		{
+			continue;
+		}
+
+		++NumProcessed;
+	}
+
+	if (HeadIndex >= PendingDeaths.Num())
+	{
+		PendingDeaths.Reset();
+		HeadIndex = 0;
+	}
+	else if (HeadIndex > (PendingDeaths.Num() / 2))
+	{
+		PendingDeaths.RemoveAt(0, HeadIndex, false);
+		HeadIndex = 0;
+	}
+
+	if (NumProcessed > 0)
+	{
+		UE_LOG(LogGAHA, Verbose, TEXT("UHealthDeathQueueSubsystem: Processed %d deaths in %.3f ms, %d pending."),
+			NumProcessed, (FPlatformTime::Seconds() - StartTime) * 1000.0, GetNumPendingDeaths());
+	}
+
+	return NumProcessed;
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "HealthComponent.h"
+
+#include "HealthDeathQueueSubsystem.generated.h"
+
+
+/**
+ * Subsystem that processes the deaths of health components with deferred death processing within a per frame budget
+ * 
+ * Tips:
+ *	Deaths are processed in the order the owners ran out of health, deaths caused while processing are appended to the end.
+ *	At least "GAHA.DeathQueue.MinPerFrame" (and at least one) deaths are processed each frame, then more until "GAHA.DeathQueue.BudgetMs" is used up.
+ *	Healing is blocked while a death is queued (Status.Death.Pending), and a queued death is canceled if health was raised by other means.
+ */
+UCLASS()
+class GAHADDON_API UHealthDeathQueueSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	UHealthDeathQueueSubsystem() {}
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return (HeadIndex < PendingDeaths.Num()); }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UHealthDeathQueueSubsystem, STATGROUP_Tickables); }
+
+protected:
+	struct FPendingDeath
+	{
+		TWeakObjectPtr<UHealthComponent> HealthComponent;
+
+		FHealthOutOfHealthInfo Info;
+	};
+
+	//
+	// Deaths in the order they were queued, entries before HeadIndex have already been processed
+	//
+	TArray<FPendingDeath> PendingDeaths;
+
+	int32 HeadIndex{ 0 };
+
+public:
+	/**
+	 * Queue the processing of the death of the component
+	 */
+	void EnqueueDeath(UHealthComponent* HealthComponent, FHealthOutOfHealthInfo&& Info);
+
+	/**
+	 * Process queued deaths until the budget is used up, returns the number of deaths processed
+	 */
+	int32 ProcessPendingDeaths(double BudgetSeconds, int32 MinDeaths);
+
+	/**
+	 * Returns the number of deaths waiting to be processed
+	 */
+	int32 GetNumPendingDeaths() const { return PendingDeaths.Num() - HeadIndex; }
+
+};
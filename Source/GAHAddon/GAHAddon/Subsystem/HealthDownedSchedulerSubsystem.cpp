@@ -0,0 +1,69 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthDownedSchedulerSubsystem.h"
+
+#include "HealthComponent.h"
+#include "GAHAddonStats.h"
+
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthDownedSchedulerSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Bleed Out Scheduler"), STAT_GAHA_BleedOutScheduler, STATGROUP_GAHA);
+
+
+void UHealthDownedSchedulerSubsystem::Deinitialize()
+{
+	Timers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHealthDownedSchedulerSubsystem::Tick(float DeltaTime)
+{
+	GAHA_SCOPE_CYCLE_COUNTER(STAT_GAHA_BleedOutScheduler);
+
+	const auto* World{ GetWorld() };
+	if (!World)
+	{
+		return;
+	}
+
+	const auto CurrentTime{ World->GetTimeSeconds() };
+
+	// Bleeding out may schedule other timers, so the timer is popped before the component is notified
+
+	while (!Timers.IsEmpty() && (Timers.HeapTop().EndTime <= CurrentTime))
+	{
+		FBleedOutTimer Timer;
+		Timers.HeapPop(Timer, false);
+
+		auto* HealthComponent{ Timer.HealthComponent.Get() };
+		if (HealthComponent && (HealthComponent->GetBleedOutHandle() == Timer.Handle))
+		{
+			HealthComponent->HandleBleedOut();
+		}
+	}
+}
+
+
+uint32 UHealthDownedSchedulerSubsystem::ScheduleBleedOut(UHealthComponent* HealthComponent, double EndTime)
+{
+	check(HealthComponent);
+
+	// Zero is reserved for no timer
+
+	if (++LastHandle == 0)
+	{
+		++LastHandle;
+	}
+
+	FBleedOutTimer Timer;
+	Timer.EndTime = EndTime;
+	Timer.HealthComponent = HealthComponent;
+	Timer.Handle = LastHandle;
+
+	Timers.HeapPush(Timer);
+
+	return Timer.Handle;
+}
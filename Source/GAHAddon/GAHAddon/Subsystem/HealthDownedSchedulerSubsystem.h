@@ -0,0 +1,65 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "HealthDownedSchedulerSubsystem.generated.h"
+
+class UHealthComponent;
+
+
+/**
+ * Subsystem that runs the bleed-out timers of all downed health components in the world
+ * 
+ * Tips:
+ *	Timers are kept in a single heap ordered by their end time, so a frame only looks at the timers that have expired.
+ *	A timer is canceled by changing the bleed-out handle of the component, stale entries are dropped when they reach the top.
+ */
+UCLASS()
+class GAHADDON_API UHealthDownedSchedulerSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	UHealthDownedSchedulerSubsystem() {}
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return !Timers.IsEmpty(); }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UHealthDownedSchedulerSubsystem, STATGROUP_Tickables); }
+
+protected:
+	struct FBleedOutTimer
+	{
+		double EndTime{ 0.0 };
+
+		TWeakObjectPtr<UHealthComponent> HealthComponent;
+
+		uint32 Handle{ 0 };
+
+		bool operator<(const FBleedOutTimer& Other) const { return EndTime < Other.EndTime; }
+	};
+
+	//
+	// Heap of the scheduled timers, earliest end time first
+	//
+	TArray<FBleedOutTimer> Timers;
+
+	uint32 LastHandle{ 0 };
+
+public:
+	/**
+	 * Schedule the bleed-out of the component at the given world time, returns the handle of the timer
+	 */
+	uint32 ScheduleBleedOut(UHealthComponent* HealthComponent, double EndTime);
+
+	/**
+	 * Returns the number of scheduled timers, including canceled ones not yet dropped
+	 */
+	int32 GetNumTimers() const { return Timers.Num(); }
+
+};
@@ -0,0 +1,622 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthSubscriptionSubsystem.h"
+
+#include "Subsystem/HealthComponentRegistrySubsystem.h"
+#include "HealthFunctionLibrary.h"
+#include "HealthComponent.h"
+#include "GAHAddonLogs.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/Pawn.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthSubscriptionSubsystem)
+
+
+void UHealthSubscriptionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (auto* Registry{ Collection.InitializeDependency<UHealthComponentRegistrySubsystem>() })
+	{
+		Registry->OnHealthComponentRegistered.AddUObject(this, &ThisClass::HandleHealthComponentRegistered);
+		Registry->OnHealthComponentUnregistered.AddUObject(this, &ThisClass::HandleHealthComponentUnregistered);
+	}
+}
+
+void UHealthSubscriptionSubsystem::Deinitialize()
+{
+	if (auto* World{ GetWorld() })
+	{
+		World->GetTimerManager().ClearTimer(FlushTimer);
+
+		if (auto* Registry{ UWorld::GetSubsystem<UHealthComponentRegistrySubsystem>(World) })
+		{
+			Registry->OnHealthComponentRegistered.RemoveAll(this);
+			Registry->OnHealthComponentUnregistered.RemoveAll(this);
+		}
+	}
+
+	for (const auto& KVP : ComponentEntries)
+	{
+		UnbindHealthComponent(KVP.Value.HealthComponent.Get());
+	}
+
+	for (const auto& KVP : TargetEntries)
+	{
+		if (auto* PlayerState{ KVP.Value.BoundPlayerState.Get() })
+		{
+			PlayerState->OnPawnSet.RemoveAll(this);
+		}
+
+		if (auto* Controller{ KVP.Value.BoundController.Get() })
+		{
+			Controller->OnPossessedPawnChanged.RemoveAll(this);
+		}
+	}
+
+	TargetEntries.Reset();
+	ComponentEntries.Reset();
+	SubscriptionTargets.Reset();
+	PendingComponents.Reset();
+
+	Super::Deinitialize();
+}
+
+
+FHealthSubscriptionHandle UHealthSubscriptionSubsystem::Subscribe(AActor* Target, FHealthSubscriptionNativeDelegate Delegate)
+{
+	FSubscriber NewSubscriber;
+	NewSubscriber.NativeDelegate = MoveTemp(Delegate);
+
+	return AddSubscriber(Target, MoveTemp(NewSubscriber));
+}
+
+FHealthSubscriptionHandle UHealthSubscriptionSubsystem::K2_Subscribe(AActor* Target, FHealthSubscriptionDelegate Delegate)
+{
+	FSubscriber NewSubscriber;
+	NewSubscriber.Delegate = Delegate;
+
+	return AddSubscriber(Target, MoveTemp(NewSubscriber));
+}
+
+void UHealthSubscriptionSubsystem::Unsubscribe(FHealthSubscriptionHandle& Handle)
+{
+	FObjectKey TargetKey;
+	if (!SubscriptionTargets.RemoveAndCopyValue(Handle.Id, TargetKey))
+	{
+		Handle.Reset();
+		return;
+	}
+
+	if (auto* TargetEntry{ TargetEntries.Find(TargetKey) })
+	{
+		TargetEntry->Subscribers.RemoveAll([&Handle](const FSubscriber& Subscriber) { return Subscriber.Id == Handle.Id; });
+
+		if (TargetEntry->Subscribers.IsEmpty())
+		{
+			RemoveTarget(TargetKey);
+		}
+	}
+
+	Handle.Reset();
+}
+
+bool UHealthSubscriptionSubsystem::GetSnapshot(AActor* Target, FHealthSnapshot& OutSnapshot) const
+{
+	// Use the shared snapshot if the target is already tracked
+
+	if (const auto* TargetEntry{ TargetEntries.Find(FObjectKey(Target)) })
+	{
+		if (const auto* ComponentEntry{ ComponentEntries.Find(FObjectKey(TargetEntry->HealthComponent.Get())) })
+		{
+			OutSnapshot = ComponentEntry->Snapshot;
+			return true;
+		}
+	}
+
+	APlayerState* PlayerState{ nullptr };
+	AController* Controller{ nullptr };
+	if (const auto* HealthComponent{ ResolveHealthComponent(Target, PlayerState, Controller) })
+	{
+		OutSnapshot = FHealthSnapshot::MakeFromComponent(HealthComponent);
+		return true;
+	}
+
+	return false;
+}
+
+
+FHealthSubscriptionHandle UHealthSubscriptionSubsystem::AddSubscriber(AActor* Target, FSubscriber&& Subscriber)
+{
+	FHealthSubscriptionHandle Handle;
+
+	if (!Target)
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UHealthSubscriptionSubsystem::Subscribe: Invalid target."));
+		return Handle;
+	}
+
+	Handle.Id = ++LastSubscriptionId;
+	Subscriber.Id = Handle.Id;
+
+	const auto TargetKey{ FObjectKey(Target) };
+	SubscriptionTargets.Add(Handle.Id, TargetKey);
+
+	auto* TargetEntry{ TargetEntries.Find(TargetKey) };
+	if (!TargetEntry)
+	{
+		TargetEntry = &TargetEntries.Add(TargetKey);
+		TargetEntry->Target = Target;
+
+		RefreshTarget(TargetKey);
+
+		TargetEntry = TargetEntries.Find(TargetKey);
+	}
+
+	const auto& NewSubscriber{ TargetEntry->Subscribers.Add_GetRef(MoveTemp(Subscriber)) };
+
+	// Deliver the current snapshot to the new subscriber
+
+	if (const auto* ComponentEntry{ ComponentEntries.Find(FObjectKey(TargetEntry->HealthComponent.Get())) })
+	{
+		BroadcastToSubscriber(NewSubscriber, Target, ComponentEntry->Snapshot, EHealthSnapshotField::All);
+	}
+
+	return Handle;
+}
+
+
+UHealthComponent* UHealthSubscriptionSubsystem::ResolveHealthComponent(AActor* Target, APlayerState*& OutPlayerState, AController*& OutController)
+{
+	// Components that have not begun play or have already ended play are not tracked
+
+	auto GetActiveHealthComponent
+	{
+		[](const AActor* Actor) -> UHealthComponent*
+		{
+			auto* HealthComponent{ UHealthFunctionLibrary::GetHealthComponentFromActor(Actor) };
+			return (HealthComponent && HealthComponent->HasBegunPlay()) ? HealthComponent : nullptr;
+		}
+	};
+
+	OutPlayerState = nullptr;
+	OutController = nullptr;
+
+	// Controllers without a player state, such as AI controllers, follow their pawn
+
+	if (auto* Controller{ Cast<AController>(Target) })
+	{
+		if (!Controller->PlayerState)
+		{
+			OutController = Controller;
+
+			return GetActiveHealthComponent(Controller->GetPawn());
+		}
+
+		Target = Controller->PlayerState;
+	}
+
+	if (auto* HealthComponent{ GetActiveHealthComponent(Target) })
+	{
+		return HealthComponent;
+	}
+
+	// Player states without their own health component follow their pawn
+
+	if (auto* PlayerState{ Cast<APlayerState>(Target) })
+	{
+		OutPlayerState = PlayerState;
+
+		return GetActiveHealthComponent(PlayerState->GetPawn());
+	}
+
+	return nullptr;
+}
+
+void UHealthSubscriptionSubsystem::RefreshTarget(const FObjectKey& TargetKey)
+{
+	auto* TargetEntry{ TargetEntries.Find(TargetKey) };
+	if (!TargetEntry)
+	{
+		return;
+	}
+
+	auto* Target{ TargetEntry->Target.Get() };
+	if (!Target)
+	{
+		RemoveTarget(TargetKey);
+		return;
+	}
+
+	APlayerState* PlayerState{ nullptr };
+	AController* Controller{ nullptr };
+	auto* NewHealthComponent{ ResolveHealthComponent(Target, PlayerState, Controller) };
+
+	// Follow pawn changes of the player state
+
+	if (PlayerState != TargetEntry->BoundPlayerState.Get())
+	{
+		if (auto* OldPlayerState{ TargetEntry->BoundPlayerState.Get() })
+		{
+			OldPlayerState->OnPawnSet.RemoveDynamic(this, &ThisClass::HandlePlayerStatePawnSet);
+		}
+
+		if (PlayerState)
+		{
+			PlayerState->OnPawnSet.AddUniqueDynamic(this, &ThisClass::HandlePlayerStatePawnSet);
+		}
+
+		TargetEntry->BoundPlayerState = PlayerState;
+	}
+
+	// Follow possession changes of the controller without a player state
+
+	if (Controller != TargetEntry->BoundController.Get())
+	{
+		if (auto* OldController{ TargetEntry->BoundController.Get() })
+		{
+			OldController->OnPossessedPawnChanged.RemoveDynamic(this, &ThisClass::HandleControllerPossessedPawnChanged);
+		}
+
+		if (Controller)
+		{
+			Controller->OnPossessedPawnChanged.AddUniqueDynamic(this, &ThisClass::HandleControllerPossessedPawnChanged);
+		}
+
+		TargetEntry->BoundController = Controller;
+	}
+
+	auto* OldHealthComponent{ TargetEntry->HealthComponent.Get() };
+	if (NewHealthComponent == OldHealthComponent)
+	{
+		return;
+	}
+
+	TargetEntry->HealthComponent = NewHealthComponent;
+
+	RemoveTargetFromComponent(TargetKey, OldHealthComponent);
+	AddTargetToComponent(TargetKey, NewHealthComponent);
+
+	// Notify subscribers that all values have changed with the component
+
+	TargetEntry = TargetEntries.Find(TargetKey);
+
+	if (const auto* ComponentEntry{ ComponentEntries.Find(FObjectKey(NewHealthComponent)) })
+	{
+		BroadcastToTarget(*TargetEntry, ComponentEntry->Snapshot, EHealthSnapshotField::All);
+	}
+	else
+	{
+		BroadcastToTarget(*TargetEntry, FHealthSnapshot(), EHealthSnapshotField::All);
+	}
+}
+
+void UHealthSubscriptionSubsystem::RefreshAllTargets()
+{
+	TArray<FObjectKey> TargetKeys;
+	TargetEntries.GenerateKeyArray(TargetKeys);
+
+	for (const auto& TargetKey : TargetKeys)
+	{
+		RefreshTarget(TargetKey);
+	}
+}
+
+void UHealthSubscriptionSubsystem::RemoveTarget(const FObjectKey& TargetKey)
+{
+	FTargetEntry TargetEntry;
+	if (!TargetEntries.RemoveAndCopyValue(TargetKey, TargetEntry))
+	{
+		return;
+	}
+
+	if (auto* PlayerState{ TargetEntry.BoundPlayerState.Get() })
+	{
+		PlayerState->OnPawnSet.RemoveDynamic(this, &ThisClass::HandlePlayerStatePawnSet);
+	}
+
+	if (auto* Controller{ TargetEntry.BoundController.Get() })
+	{
+		Controller->OnPossessedPawnChanged.RemoveDynamic(this, &ThisClass::HandleControllerPossessedPawnChanged);
+	}
+
+	for (const auto& Subscriber : TargetEntry.Subscribers)
+	{
+		SubscriptionTargets.Remove(Subscriber.Id);
+	}
+
+	RemoveTargetFromComponent(TargetKey, TargetEntry.HealthComponent.Get());
+}
+
+
+void UHealthSubscriptionSubsystem::AddTargetToComponent(const FObjectKey& TargetKey, UHealthComponent* HealthComponent)
+{
+	if (!HealthComponent)
+	{
+		return;
+	}
+
+	const auto ComponentKey{ FObjectKey(HealthComponent) };
+
+	auto* ComponentEntry{ ComponentEntries.Find(ComponentKey) };
+	if (!ComponentEntry)
+	{
+		ComponentEntry = &ComponentEntries.Add(ComponentKey);
+		ComponentEntry->HealthComponent = HealthComponent;
+		ComponentEntry->Snapshot = FHealthSnapshot::MakeFromComponent(HealthComponent);
+
+		BindHealthComponent(HealthComponent);
+	}
+
+	ComponentEntry->Targets.AddUnique(TargetKey);
+}
+
+void UHealthSubscriptionSubsystem::RemoveTargetFromComponent(const FObjectKey& TargetKey, UHealthComponent* HealthComponent)
+{
+	const auto ComponentKey{ FObjectKey(HealthComponent) };
+
+	auto* ComponentEntry{ ComponentEntries.Find(ComponentKey) };
+	if (!ComponentEntry)
+	{
+		return;
+	}
+
+	ComponentEntry->Targets.RemoveSingleSwap(TargetKey);
+
+	if (ComponentEntry->Targets.IsEmpty())
+	{
+		UnbindHealthComponent(HealthComponent);
+
+		ComponentEntries.Remove(ComponentKey);
+	}
+}
+
+
+void UHealthSubscriptionSubsystem::BindHealthComponent(UHealthComponent* HealthComponent)
+{
+	if (HealthComponent)
+	{
+		HealthComponent->OnHealthChangedNative.AddUObject(this, &ThisClass::HandleHealthChanged);
+		HealthComponent->OnMaxHealthChangedNative.AddUObject(this, &ThisClass::HandleMaxHealthChanged);
+		HealthComponent->OnMinHealthChangedNative.AddUObject(this, &ThisClass::HandleMinHealthChanged);
+		HealthComponent->OnExtraHealthChangedNative.AddUObject(this, &ThisClass::HandleExtraHealthChanged);
+		HealthComponent->OnShieldChangedNative.AddUObject(this, &ThisClass::HandleShieldChanged);
+		HealthComponent->OnMaxShieldChangedNative.AddUObject(this, &ThisClass::HandleMaxShieldChanged);
+		HealthComponent->OnDeathStartedNative.AddUObject(this, &ThisClass::HandleDeathStateChanged);
+		HealthComponent->OnDeathFinishedNative.AddUObject(this, &ThisClass::HandleDeathStateChanged);
+		HealthComponent->OnRevivedNative.AddUObject(this, &ThisClass::HandleDeathStateChanged);
+	}
+}
+
+void UHealthSubscriptionSubsystem::UnbindHealthComponent(UHealthComponent* HealthComponent)
+{
+	if (HealthComponent)
+	{
+		HealthComponent->OnHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnMaxHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnMinHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnExtraHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnShieldChangedNative.RemoveAll(this);
+		HealthComponent->OnMaxShieldChangedNative.RemoveAll(this);
+		HealthComponent->OnDeathStartedNative.RemoveAll(this);
+		HealthComponent->OnDeathFinishedNative.RemoveAll(this);
+		HealthComponent->OnRevivedNative.RemoveAll(this);
+	}
+}
+
+
+void UHealthSubscriptionSubsystem::MarkComponentDirty(UHealthComponent* HealthComponent, EHealthSnapshotField Fields)
+{
+	const auto ComponentKey{ FObjectKey(HealthComponent) };
+
+	auto* ComponentEntry{ ComponentEntries.Find(ComponentKey) };
+	if (!ComponentEntry)
+	{
+		return;
+	}
+
+	if (ComponentEntry->PendingFields == EHealthSnapshotField::None)
+	{
+		PendingComponents.Add(ComponentKey);
+	}
+
+	ComponentEntry->PendingFields |= Fields;
+
+	if (!FlushTimer.IsValid())
+	{
+		if (auto* World{ GetWorld() })
+		{
+			FlushTimer = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ThisClass::FlushPendingSnapshots));
+		}
+	}
+}
+
+void UHealthSubscriptionSubsystem::FlushPendingSnapshots()
+{
+	FlushTimer.Invalidate();
+
+	auto ComponentKeys{ MoveTemp(PendingComponents) };
+	PendingComponents.Reset();
+
+	for (const auto& ComponentKey : ComponentKeys)
+	{
+		auto* ComponentEntry{ ComponentEntries.Find(ComponentKey) };
+		if (!ComponentEntry)
+		{
+			continue;
+		}
+
+		const auto ChangedFields{ ComponentEntry->PendingFields };
+		ComponentEntry->PendingFields = EHealthSnapshotField::None;
+
+		auto* HealthComponent{ ComponentEntry->HealthComponent.Get() };
+		if (!HealthComponent || (ChangedFields == EHealthSnapshotField::None))
+		{
+			continue;
+		}
+
+		ComponentEntry->Snapshot = FHealthSnapshot::MakeFromComponent(HealthComponent);
+
+		// Copy since subscribers may subscribe or unsubscribe during the broadcast
+
+		const auto Snapshot{ ComponentEntry->Snapshot };
+		const auto TargetKeys{ ComponentEntry->Targets };
+
+		for (const auto& TargetKey : TargetKeys)
+		{
+			if (auto* TargetEntry{ TargetEntries.Find(TargetKey) })
+			{
+				BroadcastToTarget(*TargetEntry, Snapshot, ChangedFields);
+			}
+		}
+	}
+}
+
+
+void UHealthSubscriptionSubsystem::BroadcastToTarget(FTargetEntry& TargetEntry, const FHealthSnapshot& Snapshot, EHealthSnapshotField ChangedFields)
+{
+	auto* Target{ TargetEntry.Target.Get() };
+	const auto Subscribers{ TargetEntry.Subscribers };
+
+	// Iterate a copy since subscribers may subscribe or unsubscribe during the broadcast.
+	// Unsubscribing removes the subscription id, so skip subscribers that have been removed since the copy was made.
+
+	for (const auto& Subscriber : Subscribers)
+	{
+		if (SubscriptionTargets.Contains(Subscriber.Id))
+		{
+			BroadcastToSubscriber(Subscriber, Target, Snapshot, ChangedFields);
+		}
+	}
+}
+
+void UHealthSubscriptionSubsystem::BroadcastToSubscriber(const FSubscriber& Subscriber, AActor* Target, const FHealthSnapshot& Snapshot, EHealthSnapshotField ChangedFields)
+{
+	Subscriber.NativeDelegate.ExecuteIfBound(Target, Snapshot, ChangedFields);
+	Subscriber.Delegate.ExecuteIfBound(Target, Snapshot, static_cast<int32>(ChangedFields));
+}
+
+
+void UHealthSubscriptionSubsystem::HandleHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+{
+	MarkComponentDirty(HealthComponent, EHealthSnapshotField::Health);
+}
+
+void UHealthSubscriptionSubsystem::HandleMaxHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+{
+	MarkComponentDirty(HealthComponent, EHealthSnapshotField::MaxHealth);
+}
+
+void UHealthSubscriptionSubsystem::HandleMinHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+{
+	MarkComponentDirty(HealthComponent, EHealthSnapshotField::MinHealth);
+}
+
+void UHealthSubscriptionSubsystem::HandleExtraHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+{
+	MarkComponentDirty(HealthComponent, EHealthSnapshotField::ExtraHealth);
+}
+
+void UHealthSubscriptionSubsystem::HandleShieldChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+{
+	MarkComponentDirty(HealthComponent, EHealthSnapshotField::Shield);
+}
+
+void UHealthSubscriptionSubsystem::HandleMaxShieldChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator)
+{
+	MarkComponentDirty(HealthComponent, EHealthSnapshotField::MaxShield);
+}
+
+void UHealthSubscriptionSubsystem::HandleDeathStateChanged(AActor* OwningActor)
+{
+	// The death delegates do not pass the component, so find the entry by its owner
+
+	for (const auto& KVP : ComponentEntries)
+	{
+		auto* HealthComponent{ KVP.Value.HealthComponent.Get() };
+
+		if (HealthComponent && (HealthComponent->GetOwner() == OwningActor))
+		{
+			MarkComponentDirty(HealthComponent, EHealthSnapshotField::DeathState);
+			break;
+		}
+	}
+}
+
+
+void UHealthSubscriptionSubsystem::HandleHealthComponentRegistered(UHealthComponent* HealthComponent)
+{
+	if (!TargetEntries.IsEmpty())
+	{
+		RefreshAllTargets();
+	}
+}
+
+void UHealthSubscriptionSubsystem::HandleHealthComponentUnregistered(UHealthComponent* HealthComponent)
+{
+	const auto ComponentKey{ FObjectKey(HealthComponent) };
+
+	if (const auto* ComponentEntry{ ComponentEntries.Find(ComponentKey) })
+	{
+		// Unbind now so that the targets resolving to this component are moved away from it
+
+		const auto TargetKeys{ ComponentEntry->Targets };
+
+		UnbindHealthComponent(HealthComponent);
+		ComponentEntries.Remove(ComponentKey);
+
+		for (const auto& TargetKey : TargetKeys)
+		{
+			if (auto* TargetEntry{ TargetEntries.Find(TargetKey) })
+			{
+				TargetEntry->HealthComponent.Reset();
+
+				BroadcastToTarget(*TargetEntry, FHealthSnapshot(), EHealthSnapshotField::All);
+			}
+		}
+	}
+}
+
+void UHealthSubscriptionSubsystem::HandlePlayerStatePawnSet(APlayerState* PlayerState, APawn* NewPawn, APawn* OldPawn)
+{
+	TArray<FObjectKey> TargetKeys;
+
+	for (const auto& KVP : TargetEntries)
+	{
+		if (KVP.Value.BoundPlayerState.Get() == PlayerState)
+		{
+			TargetKeys.Add(KVP.Key);
+		}
+	}
+
+	for (const auto& TargetKey : TargetKeys)
+	{
+		RefreshTarget(TargetKey);
+	}
+}
+
+void UHealthSubscriptionSubsystem::HandleControllerPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn)
+{
+	// The delegate does not pass the controller, so refresh every target bound to a controller that now possesses the new pawn
+
+	TArray<FObjectKey> TargetKeys;
+
+	for (const auto& KVP : TargetEntries)
+	{
+		const auto* Controller{ KVP.Value.BoundController.Get() };
+
+		if (Controller && (Controller->GetPawn() == NewPawn))
+		{
+			TargetKeys.Add(KVP.Key);
+		}
+	}
+
+	for (const auto& TargetKey : TargetKeys)
+	{
+		RefreshTarget(TargetKey);
+	}
+}
@@ -0,0 +1,172 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "HealthSnapshot.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "HealthSubscriptionSubsystem.generated.h"
+
+class UHealthComponent;
+class APlayerState;
+class AController;
+class APawn;
+class AActor;
+
+
+/**
+ * Delegate to notify subscribers that the health snapshot of the target has changed
+ */
+DECLARE_DELEGATE_ThreeParams(FHealthSubscriptionNativeDelegate, AActor* /*Target*/, const FHealthSnapshot& /*Snapshot*/, EHealthSnapshotField /*ChangedFields*/);
+DECLARE_DYNAMIC_DELEGATE_ThreeParams(FHealthSubscriptionDelegate, AActor*, Target, const FHealthSnapshot&, Snapshot, int32, ChangedFields);
+
+
+/**
+ * Handle to cancel a subscription
+ */
+USTRUCT(BlueprintType)
+struct FHealthSubscriptionHandle
+{
+	GENERATED_BODY()
+public:
+	FHealthSubscriptionHandle() {}
+
+public:
+	UPROPERTY()
+	uint64 Id{ 0 };
+
+public:
+	bool IsValid() const { return Id != 0; }
+	void Reset() { Id = 0; }
+
+};
+
+
+/**
+ * Subsystem that tracks the health of any set of actors for frames such as party, raid or boss frames
+ * 
+ * Tips:
+ *	Each health component is bound once regardless of the number of subscribers and changes are coalesced into one snapshot per frame.
+ *	A target can be an actor with a health component, an actor implementing IHealthComponentInterface, a player state or a controller.
+ *	The target is resolved again when its pawn changes or when health components begin or end play, so subscribers do not need to handle it.
+ */
+UCLASS()
+class GAHADDON_API UHealthSubscriptionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	UHealthSubscriptionSubsystem() {}
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+protected:
+	struct FSubscriber
+	{
+		uint64 Id{ 0 };
+		FHealthSubscriptionNativeDelegate NativeDelegate;
+		FHealthSubscriptionDelegate Delegate;
+	};
+
+	struct FTargetEntry
+	{
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<UHealthComponent> HealthComponent;
+		TWeakObjectPtr<APlayerState> BoundPlayerState;
+		TWeakObjectPtr<AController> BoundController;
+		TArray<FSubscriber> Subscribers;
+	};
+
+	struct FComponentEntry
+	{
+		TWeakObjectPtr<UHealthComponent> HealthComponent;
+		FHealthSnapshot Snapshot;
+		EHealthSnapshotField PendingFields{ EHealthSnapshotField::None };
+		TArray<FObjectKey> Targets;
+	};
+
+	TMap<FObjectKey, FTargetEntry> TargetEntries;
+	TMap<FObjectKey, FComponentEntry> ComponentEntries;
+	TMap<uint64, FObjectKey> SubscriptionTargets;
+
+	TArray<FObjectKey> PendingComponents;
+	FTimerHandle FlushTimer;
+
+	uint64 LastSubscriptionId{ 0 };
+
+public:
+	/**
+	 * Subscribe to the health of the target. The current snapshot is delivered immediately if it is available.
+	 */
+	FHealthSubscriptionHandle Subscribe(AActor* Target, FHealthSubscriptionNativeDelegate Delegate);
+
+	/**
+	 * Subscribe to the health of the target. The current snapshot is delivered immediately if it is available.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health", Meta = (DisplayName = "Subscribe Health"))
+	FHealthSubscriptionHandle K2_Subscribe(AActor* Target, FHealthSubscriptionDelegate Delegate);
+
+	/**
+	 * Cancel the subscription
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health", Meta = (DisplayName = "Unsubscribe Health"))
+	void Unsubscribe(UPARAM(ref) FHealthSubscriptionHandle& Handle);
+
+	/**
+	 * Returns the last snapshot of the target, or false if its health component is not available
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	bool GetSnapshot(AActor* Target, FHealthSnapshot& OutSnapshot) const;
+
+protected:
+	FHealthSubscriptionHandle AddSubscriber(AActor* Target, FSubscriber&& Subscriber);
+
+	/**
+	 * Returns the health component of the target, following player states and controllers to their pawn
+	 */
+	static UHealthComponent* ResolveHealthComponent(AActor* Target, APlayerState*& OutPlayerState, AController*& OutController);
+
+	/**
+	 * Resolve the target again and move it to its current health component
+	 */
+	void RefreshTarget(const FObjectKey& TargetKey);
+	void RefreshAllTargets();
+
+	void RemoveTarget(const FObjectKey& TargetKey);
+
+	void AddTargetToComponent(const FObjectKey& TargetKey, UHealthComponent* HealthComponent);
+	void RemoveTargetFromComponent(const FObjectKey& TargetKey, UHealthComponent* HealthComponent);
+
+	void BindHealthComponent(UHealthComponent* HealthComponent);
+	void UnbindHealthComponent(UHealthComponent* HealthComponent);
+
+	void MarkComponentDirty(UHealthComponent* HealthComponent, EHealthSnapshotField Fields);
+	void FlushPendingSnapshots();
+
+	/**
+	 * Broadcast to the subscribers of the target, skipping those that unsubscribe during the broadcast
+	 */
+	void BroadcastToTarget(FTargetEntry& TargetEntry, const FHealthSnapshot& Snapshot, EHealthSnapshotField ChangedFields);
+	static void BroadcastToSubscriber(const FSubscriber& Subscriber, AActor* Target, const FHealthSnapshot& Snapshot, EHealthSnapshotField ChangedFields);
+
+	void HandleHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator);
+	void HandleMaxHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator);
+	void HandleMinHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator);
+	void HandleExtraHealthChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator);
+	void HandleShieldChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator);
+	void HandleMaxShieldChanged(UHealthComponent* HealthComponent, float OldValue, float NewValue, AActor* Instigator);
+	void HandleDeathStateChanged(AActor* OwningActor);
+
+	void HandleHealthComponentRegistered(UHealthComponent* HealthComponent);
+	void HandleHealthComponentUnregistered(UHealthComponent* HealthComponent);
+
+	UFUNCTION()
+	void HandlePlayerStatePawnSet(APlayerState* PlayerState, APawn* NewPawn, APawn* OldPawn);
+
+	UFUNCTION()
+	void HandleControllerPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn);
+
+};
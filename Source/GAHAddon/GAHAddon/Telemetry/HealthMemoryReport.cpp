@@ -0,0 +1,196 @@
+// Copyright (C) 2024 owoDra
+
+#include "Attribute/HealthAttributeSet.h"
+#include "Attribute/CombatAttributeSet.h"
+#include "Ability/GameplayAbility_Death.h"
+#include "Subsystem/HealthComponentRegistrySubsystem.h"
+#include "HealthComponent.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+
+
+/**
+ * Memory footprint report of the objects the plugin adds to every health-bearing actor
+ *
+ * Tips:
+ *	"GAHA.Memory.Report [ProjectedActors=2000] [Verbose]" prints the bytes per actor of the health component,
+ *	the health and combat attribute sets and the death ability, measured like "obj list" (class size plus
+ *	the allocations reported by the object), and projects the total for the given number of actors.
+ *	Actors exceeding GAHA.Memory.BudgetBytesPerActor are reported.
+ */
+namespace GAHAMemoryReport
+{
+	static TAutoConsoleVariable<int32> CVarBudgetBytesPerActor(
+		TEXT("GAHA.Memory.BudgetBytesPerActor"),
+		0,
+		TEXT("Budget of the plugin owned memory per actor reported by GAHA.Memory.Report. 0 disables the check."));
+
+	enum class ECategory : uint8
+	{
+		Component,
+		HealthSet,
+		CombatSet,
+		DeathAbility,
+		MAX
+	};
+
+	static constexpr int32 NumCategories{ static_cast<int32>(ECategory::MAX) };
+
+	static const TCHAR* GetCategoryName(ECategory Category)
+	{
+		switch (Category)
+		{
+		case ECategory::Component:		return TEXT("HealthComponent");
+		case ECategory::HealthSet:		return TEXT("HealthAttributeSet");
+		case ECategory::CombatSet:		return TEXT("CombatAttributeSet");
+		case ECategory::DeathAbility:	return TEXT("DeathAbility");
+		default:						return TEXT("Unknown");
+		}
+	}
+
+	static int64 GetObjectBytes(const UObject* Object)
+	{
+		if (!Object)
+		{
+			return 0;
+		}
+
+		// Counts the object itself as well as its allocations, like "obj list"
+
+		FArchiveCountMem CountMem(const_cast<UObject*>(Object));
+
+		return static_cast<int64>(CountMem.GetMax());
+	}
+
+	static void MeasureActor(const UHealthComponent* HealthComponent, int64 (&OutBytes)[NumCategories])
+	{
+		FMemory::Memzero(OutBytes);
+
+		OutBytes[static_cast<int32>(ECategory::Component)] = GetObjectBytes(HealthComponent);
+
+		const auto* ASC{ UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(HealthComponent->GetOwner()) };
+		if (!ASC)
+		{
+			return;
+		}
+
+		OutBytes[static_cast<int32>(ECategory::HealthSet)] = GetObjectBytes(ASC->GetSet<UHealthAttributeSet>());
+		OutBytes[static_cast<int32>(ECategory::CombatSet)] = GetObjectBytes(ASC->GetSet<UCombatAttributeSet>());
+
+		// Spec in the ability system and its instances
+
+		for (const auto& Spec : ASC->GetActivatableAbilities())
+		{
+			if ((Spec.SourceObject.Get() == HealthComponent) && Spec.Ability && Spec.Ability->IsA<UGameplayAbility_Death>())
+			{
+				auto& AbilityBytes{ OutBytes[static_cast<int32>(ECategory::DeathAbility)] };
+				AbilityBytes += sizeof(FGameplayAbilitySpec);
+
+				for (const auto* Instance : Spec.GetAbilityInstances())
+				{
+					AbilityBytes += GetObjectBytes(Instance);
+				}
+			}
+		}
+	}
+
+	static void Report(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const auto* Registry{ World ? World->GetSubsystem<UHealthComponentRegistrySubsystem>() : nullptr };
+		if (!Registry)
+		{
+			Ar.Logf(TEXT("GAHA.Memory.Report: No world."));
+			return;
+		}
+
+		// Arguments can be given in any order
+
+		auto ProjectedActors{ 2000 };
+		auto bVerbose{ false };
+
+		for (const auto& Arg : Args)
+		{
+			if (Arg.Equals(TEXT("Verbose"), ESearchCase::IgnoreCase))
+			{
+				bVerbose = true;
+			}
+			else if (Arg.IsNumeric())
+			{
+				LexFromString(ProjectedActors, *Arg);
+			}
+		}
+
+		const auto Budget{ static_cast<int64>(CVarBudgetBytesPerActor.GetValueOnGameThread()) };
+
+		int64 TotalBytes[NumCategories]{ 0 };
+		int64 MaxActorBytes{ 0 };
+		auto NumActors{ 0 };
+		auto NumOverBudget{ 0 };
+
+		for (const auto& HealthComponent : Registry->GetHealthComponents())
+		{
+			if (!HealthComponent)
+			{
+				continue;
+			}
+
+			int64 ActorBytes[NumCategories];
+			MeasureActor(HealthComponent, ActorBytes);
+
+			int64 ActorTotal{ 0 };
+			for (auto Index{ 0 }; Index < NumCategories; ++Index)
+			{
+				TotalBytes[Index] += ActorBytes[Index];
+				ActorTotal += ActorBytes[Index];
+			}
+
+			++NumActors;
+			MaxActorBytes = FMath::Max(MaxActorBytes, ActorTotal);
+
+			const auto bOverBudget{ (Budget > 0) && (ActorTotal > Budget) };
+			if (bOverBudget)
+			{
+				++NumOverBudget;
+			}
+
+			if (bVerbose || bOverBudget)
+			{
+				Ar.Logf(TEXT("  %-40s %8lld bytes%s"), *GetNameSafe(HealthComponent->GetOwner()), ActorTotal, bOverBudget ? TEXT(" (over budget)") : TEXT(""));
+			}
+		}
+
+		if (NumActors == 0)
+		{
+			Ar.Logf(TEXT("GAHA.Memory.Report: No health component is registered."));
+			return;
+		}
+
+		Ar.Logf(TEXT("GAHA Memory (%d actors)"), NumActors);
+
+		int64 AverageTotal{ 0 };
+		for (auto Index{ 0 }; Index < NumCategories; ++Index)
+		{
+			const auto Average{ TotalBytes[Index] / NumActors };
+			AverageTotal += Average;
+
+			Ar.Logf(TEXT("  %-24s %8lld bytes/actor  %10.1f KiB total"), GetCategoryName(static_cast<ECategory>(Index)), Average, TotalBytes[Index] / 1024.0);
+		}
+
+		Ar.Logf(TEXT("  %-24s %8lld bytes/actor  (max %lld)"), TEXT("Total"), AverageTotal, MaxActorBytes);
+		Ar.Logf(TEXT("  Projected for %d actors: %.2f MiB"), ProjectedActors, (AverageTotal * ProjectedActors) / (1024.0 * 1024.0));
+
+		if (Budget > 0)
+		{
+			Ar.Logf(TEXT("  %d actors over the budget of %lld bytes"), NumOverBudget, Budget);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice ReportCommand(
+		TEXT("GAHA.Memory.Report"),
+		TEXT("Print the memory per actor of the objects owned by the health addon. Usage: GAHA.Memory.Report [ProjectedActors=2000] [Verbose]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&Report));
+}
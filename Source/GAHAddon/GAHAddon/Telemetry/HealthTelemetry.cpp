@@ -0,0 +1,141 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTelemetry.h"
+
+#include "GAHAddonLogs.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(GAHA, true);
+
+
+namespace GAHATelemetry
+{
+	static TAutoConsoleVariable<bool> CVarResetOnWorldInit(
+		TEXT("GAHA.Telemetry.ResetOnWorldInit"),
+		true,
+		TEXT("Reset the health telemetry counters when a new game world has initialized its actors."));
+
+	static constexpr int32 NumCounters{ static_cast<int32>(EHealthTelemetryCounter::MAX) };
+
+	static int64 Totals[NumCounters]{ 0 };
+	static int64 FrameValues[NumCounters]{ 0 };
+	static double ResetTime{ 0.0 };
+
+	static FDelegateHandle EndFrameHandle;
+	static FDelegateHandle WorldInitializedActorsHandle;
+
+
+	void Add(EHealthTelemetryCounter Counter, int64 Amount)
+	{
+		const auto Index{ static_cast<int32>(Counter) };
+
+		Totals[Index] += Amount;
+		FrameValues[Index] += Amount;
+	}
+
+	void Reset()
+	{
+		for (auto Index{ 0 }; Index < NumCounters; ++Index)
+		{
+			Totals[Index] = 0;
+			FrameValues[Index] = 0;
+		}
+
+		ResetTime = FPlatformTime::Seconds();
+	}
+
+	int64 GetTotal(EHealthTelemetryCounter Counter)
+	{
+		return Totals[static_cast<int32>(Counter)];
+	}
+
+	double GetSecondsSinceReset()
+	{
+		return FPlatformTime::Seconds() - ResetTime;
+	}
+
+	const TCHAR* GetCounterName(EHealthTelemetryCounter Counter)
+	{
+		switch (Counter)
+		{
+		case EHealthTelemetryCounter::DamageApplications:		return TEXT("DamageApplications");
+		case EHealthTelemetryCounter::HealApplications:			return TEXT("HealApplications");
+		case EHealthTelemetryCounter::CoalescedNotifications:	return TEXT("CoalescedNotifications");
+		case EHealthTelemetryCounter::OutOfHealthEvents:		return TEXT("OutOfHealthEvents");
+		case EHealthTelemetryCounter::DeathTransitions:			return TEXT("DeathTransitions");
+		case EHealthTelemetryCounter::PredictionRollbacks:		return TEXT("PredictionRollbacks");
+		case EHealthTelemetryCounter::ReplicatedBytes:			return TEXT("ReplicatedBytes");
+		default:												return TEXT("Unknown");
+		}
+	}
+
+
+	static void HandleEndFrame()
+	{
+#if CSV_PROFILER
+		CSV_CUSTOM_STAT(GAHA, DamageApplications, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::DamageApplications)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GAHA, HealApplications, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::HealApplications)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GAHA, CoalescedNotifications, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::CoalescedNotifications)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GAHA, OutOfHealthEvents, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::OutOfHealthEvents)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GAHA, DeathTransitions, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::DeathTransitions)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GAHA, PredictionRollbacks, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::PredictionRollbacks)]), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(GAHA, ReplicatedBytes, static_cast<int32>(FrameValues[static_cast<int32>(EHealthTelemetryCounter::ReplicatedBytes)]), ECsvCustomStatOp::Set);
+#endif
+
+		for (auto& Value : FrameValues)
+		{
+			Value = 0;
+		}
+	}
+
+	static void HandleWorldInitializedActors(const FActorsInitializedParams& Params)
+	{
+		if (Params.World && Params.World->IsGameWorld() && CVarResetOnWorldInit.GetValueOnGameThread())
+		{
+			Reset();
+		}
+	}
+
+	void Startup()
+	{
+		Reset();
+
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&HandleEndFrame);
+		WorldInitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddStatic(&HandleWorldInitializedActors);
+	}
+
+	void Shutdown()
+	{
+		FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+		FWorldDelegates::OnWorldInitializedActors.Remove(WorldInitializedActorsHandle);
+	}
+
+
+	static FAutoConsoleCommandWithOutputDevice DumpCommand(
+		TEXT("GAHA.Telemetry.Dump"),
+		TEXT("Print the health telemetry counters since the last reset."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateLambda(
+			[](FOutputDevice& Ar)
+			{
+				const auto Seconds{ FMath::Max(GetSecondsSinceReset(), UE_SMALL_NUMBER) };
+
+				Ar.Logf(TEXT("GAHA Telemetry (%.1f s since reset)"), Seconds);
+
+				for (auto Index{ 0 }; Index < NumCounters; ++Index)
+				{
+					const auto Counter{ static_cast<EHealthTelemetryCounter>(Index) };
+					const auto Total{ GetTotal(Counter) };
+
+					Ar.Logf(TEXT("  %-24s %12lld  (%.2f/s)"), GetCounterName(Counter), Total, Total / Seconds);
+				}
+			}));
+
+	static FAutoConsoleCommand ResetCommand(
+		TEXT("GAHA.Telemetry.Reset"),
+		TEXT("Reset the health telemetry counters."),
+		FConsoleCommandDelegate::CreateStatic(&Reset));
+}
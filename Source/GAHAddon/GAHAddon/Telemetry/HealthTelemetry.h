@@ -0,0 +1,45 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/**
+ * Counters of the health telemetry
+ */
+enum class EHealthTelemetryCounter : uint8
+{
+	DamageApplications,		// Damage applied through UHealthAttributeSet
+	HealApplications,		// Healing and shield healing applied through UHealthAttributeSet
+	CoalescedNotifications,	// Damage / heal changes merged into an already pending notification
+	OutOfHealthEvents,		// Out of health events handled by UHealthComponent
+	DeathTransitions,		// Death started and death finished transitions
+	PredictionRollbacks,	// Replicated death states older than the locally predicted one
+	ReplicatedBytes,		// Estimated payload of the replicated health attribute values changed on the server, at most once per value and frame
+	MAX
+};
+
+
+/**
+ * Cheap game thread counters of the health plugin for running servers
+ * 
+ * Tips:
+ *	"GAHA.Telemetry.Dump" prints totals and rates since the last reset, "GAHA.Telemetry.Reset" resets them.
+ *	Counters are reset when a new game world has initialized its actors if "GAHA.Telemetry.ResetOnWorldInit" is enabled.
+ *	Per frame values are recorded in the "GAHA" CsvProfiler category.
+ */
+namespace GAHATelemetry
+{
+	GAHADDON_API void Add(EHealthTelemetryCounter Counter, int64 Amount);
+	GAHADDON_API void Reset();
+	GAHADDON_API int64 GetTotal(EHealthTelemetryCounter Counter);
+	GAHADDON_API double GetSecondsSinceReset();
+	GAHADDON_API const TCHAR* GetCounterName(EHealthTelemetryCounter Counter);
+
+	void Startup();
+	void Shutdown();
+}
+
+#define GAHA_TELEMETRY_ADD(Counter, Amount) GAHATelemetry::Add(EHealthTelemetryCounter::Counter, Amount)
+#define GAHA_TELEMETRY_INC(Counter) GAHA_TELEMETRY_ADD(Counter, 1)
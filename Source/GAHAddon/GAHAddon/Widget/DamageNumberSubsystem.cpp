@@ -0,0 +1,258 @@
+// Copyright (C) 2024 owoDra
+
+#include "DamageNumberSubsystem.h"
+
+#include "DamageNumberWidgetBase.h"
+#include "HealthComponent.h"
+#include "GAHAddonLogs.h"
+
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "GameFramework/PlayerController.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DamageNumberSubsystem)
+
+
+void UDamageNumberSubsystem::TickPool(float DeltaTime, APlayerController* PlayerController)
+{
+	const auto FadeStartAge{ Settings.Lifetime - Settings.FadeOutDuration };
+
+	for (auto Index{ 0 }; Index < Numbers.Num(); ++Index)
+	{
+		auto& Number{ Numbers[Index] };
+		if (!Number.bActive)
+		{
+			continue;
+		}
+
+		Number.Age += DeltaTime;
+
+		if (Number.Age >= Settings.Lifetime)
+		{
+			ReleaseNumber(Index);
+			continue;
+		}
+
+		auto* Widget{ Widgets[Index].Get() };
+		if (!Widget)
+		{
+			continue;
+		}
+
+		const auto WorldLocation{ Number.WorldLocation + FVector(0.0, 0.0, Settings.RiseSpeed * Number.Age) };
+
+		FVector2D WidgetPosition;
+		if (UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(PlayerController, WorldLocation, WidgetPosition, true))
+		{
+			Widget->SetPositionInViewport(WidgetPosition, false);
+			Widget->SetRenderOpacity((Number.Age > FadeStartAge) ? (Settings.Lifetime - Number.Age) / Settings.FadeOutDuration : 1.0f);
+		}
+		else
+		{
+			Widget->SetRenderOpacity(0.0f);
+		}
+	}
+}
+
+
+void UDamageNumberSubsystem::StartDamageNumbers(const FDamageNumberSettings& InSettings)
+{
+	StopDamageNumbers();
+
+	auto* PlayerController{ GetPlayerController() };
+
+	if (!PlayerController || !InSettings.WidgetClass)
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UDamageNumberSubsystem::StartDamageNumbers: No player controller or widget class."));
+		return;
+	}
+
+	Settings = InSettings;
+
+	for (auto Index{ 0 }; Index < Settings.PoolSize; ++Index)
+	{
+		auto* NewWidget{ CreateWidget<UDamageNumberWidgetBase>(PlayerController, Settings.WidgetClass) };
+		if (!NewWidget)
+		{
+			continue;
+		}
+
+		NewWidget->SetAlignmentInViewport(FVector2D(0.5, 0.5));
+		NewWidget->SetVisibility(ESlateVisibility::Collapsed);
+		NewWidget->AddToPlayerScreen(Settings.ZOrder);
+
+		Widgets.Add(NewWidget);
+		Numbers.AddDefaulted();
+	}
+
+	ActivatePool();
+}
+
+void UDamageNumberSubsystem::StopDamageNumbers()
+{
+	DeactivatePool();
+	DestroyPool();
+}
+
+
+void UDamageNumberSubsystem::ReleaseAllTargets()
+{
+	for (auto Index{ 0 }; Index < Numbers.Num(); ++Index)
+	{
+		ReleaseNumber(Index);
+	}
+}
+
+void UDamageNumberSubsystem::DestroyPool()
+{
+	for (const auto& Widget : Widgets)
+	{
+		if (Widget)
+		{
+			Widget->RemoveFromParent();
+		}
+	}
+
+	Widgets.Reset();
+	Numbers.Reset();
+}
+
+
+void UDamageNumberSubsystem::BindHealthComponent(UHealthComponent* HealthComponent)
+{
+	if (HealthComponent)
+	{
+		HealthComponent->OnDamageNative.AddUObject(this, &ThisClass::HandleDamage);
+		HealthComponent->OnHealNative.AddUObject(this, &ThisClass::HandleHeal);
+	}
+}
+
+void UDamageNumberSubsystem::UnbindHealthComponent(UHealthComponent* HealthComponent)
+{
+	if (HealthComponent)
+	{
+		HealthComponent->OnDamageNative.RemoveAll(this);
+		HealthComponent->OnHealNative.RemoveAll(this);
+	}
+}
+
+
+void UDamageNumberSubsystem::AddHit(UHealthComponent* HealthComponent, float Amount, bool bIsHeal)
+{
+	if (Amount <= 0.0f)
+	{
+		return;
+	}
+
+	const auto TargetKey{ FObjectKey(HealthComponent) };
+
+	// Merge into the number of the same target if it is still within the merge window
+
+	for (auto Index{ 0 }; Index < Numbers.Num(); ++Index)
+	{
+		auto& Number{ Numbers[Index] };
+
+		if (Number.bActive && (Number.Target == TargetKey) && (Number.bIsHeal == bIsHeal) && (Number.Age < Settings.MergeWindow))
+		{
+			Number.Amount += Amount;
+			Number.HitCount++;
+
+			if (auto* Widget{ Widgets[Index].Get() })
+			{
+				Widget->MergeDamageNumber(Number.Amount, Number.HitCount, Number.bIsHeal);
+			}
+
+			return;
+		}
+	}
+
+	auto* Actor{ GetDisplayActor(HealthComponent) };
+	auto* PlayerController{ GetPlayerController() };
+
+	if (!Actor || !PlayerController)
+	{
+		return;
+	}
+
+	const auto WorldLocation{ Actor->GetActorLocation() + Settings.WorldOffset };
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	if (FVector::DistSquared(ViewLocation, WorldLocation) > FMath::Square(Settings.MaxDistance))
+	{
+		return;
+	}
+
+	// Use a free widget, or recycle the oldest number when the pool is exhausted
+
+	auto NewIndex{ INDEX_NONE };
+	auto OldestAge{ -1.0f };
+
+	for (auto Index{ 0 }; Index < Numbers.Num(); ++Index)
+	{
+		if (!Numbers[Index].bActive)
+		{
+			NewIndex = Index;
+			break;
+		}
+
+		if (Numbers[Index].Age > OldestAge)
+		{
+			OldestAge = Numbers[Index].Age;
+			NewIndex = Index;
+		}
+	}
+
+	if (NewIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Let the widget finish the recycled number before showing the new one
+
+	ReleaseNumber(NewIndex);
+
+	auto& Number{ Numbers[NewIndex] };
+	Number.Target = TargetKey;
+	Number.WorldLocation = WorldLocation;
+	Number.Amount = Amount;
+	Number.Age = 0.0f;
+	Number.HitCount = 1;
+	Number.bIsHeal = bIsHeal;
+	Number.bActive = true;
+
+	if (auto* Widget{ Widgets[NewIndex].Get() })
+	{
+		Widget->ShowDamageNumber(Amount, bIsHeal);
+	}
+}
+
+void UDamageNumberSubsystem::ReleaseNumber(int32 Index)
+{
+	if (!Numbers.IsValidIndex(Index) || !Numbers[Index].bActive)
+	{
+		return;
+	}
+
+	Numbers[Index].bActive = false;
+
+	if (auto* Widget{ Widgets[Index].Get() })
+	{
+		Widget->HideDamageNumber();
+	}
+}
+
+
+void UDamageNumberSubsystem::HandleDamage(UHealthComponent* HealthComponent, float Value)
+{
+	AddHit(HealthComponent, Value, false);
+}
+
+void UDamageNumberSubsystem::HandleHeal(UHealthComponent* HealthComponent, float Value)
+{
+	if (Settings.bShowHeal)
+	{
+		AddHit(HealthComponent, Value, true);
+	}
+}
@@ -0,0 +1,154 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "HealthWidgetPoolSubsystem.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "DamageNumberSubsystem.generated.h"
+
+class UDamageNumberWidgetBase;
+class UHealthComponent;
+class APlayerController;
+
+
+/**
+ * Settings of the floating damage numbers
+ */
+USTRUCT(BlueprintType)
+struct FDamageNumberSettings
+{
+	GENERATED_BODY()
+public:
+	FDamageNumberSettings() {}
+
+public:
+	//
+	// Widget class used for each number in the pool
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<UDamageNumberWidgetBase> WidgetClass;
+
+	//
+	// Number of widgets created. No more numbers than this are displayed at the same time
+	// and the oldest number is recycled when the pool is exhausted.
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 1))
+	int32 PoolSize{ 24 };
+
+	//
+	// Seconds after the first hit during which further hits on the same target are merged into the same number
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float MergeWindow{ 0.3f };
+
+	//
+	// Seconds a number is displayed
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.01))
+	float Lifetime{ 1.0f };
+
+	//
+	// Seconds at the end of the lifetime during which the number fades out
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float FadeOutDuration{ 0.3f };
+
+	//
+	// Speed at which the number rises in the world (cm/s)
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float RiseSpeed{ 60.0f };
+
+	//
+	// Offset from the actor location where the number appears
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector WorldOffset{ 0.0, 0.0, 100.0 };
+
+	//
+	// Hits on actors farther from the view than this are not displayed
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float MaxDistance{ 5000.0f };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bShowHeal{ true };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 ZOrder{ -5 };
+
+};
+
+
+/**
+ * Subsystem that displays floating damage and heal numbers from a fixed pool of widgets
+ * 
+ * Tips:
+ *	Hits on the same target within MergeWindow are merged into one rising number,
+ *	so the number of widgets updated per frame stays flat under sustained fire.
+ */
+UCLASS()
+class GAHADDON_API UDamageNumberSubsystem : public UHealthWidgetPoolSubsystem
+{
+	GENERATED_BODY()
+public:
+	UDamageNumberSubsystem() {}
+
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageNumberSubsystem, STATGROUP_Tickables); }
+
+protected:
+	struct FDamageNumber
+	{
+		FObjectKey Target;
+		FVector WorldLocation{ FVector::ZeroVector };
+		float Amount{ 0.0f };
+		float Age{ 0.0f };
+		int32 HitCount{ 0 };
+		bool bIsHeal{ false };
+		bool bActive{ false };
+	};
+
+	UPROPERTY(Transient)
+	FDamageNumberSettings Settings;
+
+	//
+	// Pooled number widgets
+	//
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UDamageNumberWidgetBase>> Widgets;
+
+	//
+	// Number displayed by each widget
+	//
+	TArray<FDamageNumber> Numbers;
+
+public:
+	/**
+	 * Create the pool of numbers and start displaying damage and heal of health components in the world
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void StartDamageNumbers(const FDamageNumberSettings& InSettings);
+
+	/**
+	 * Remove all numbers
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void StopDamageNumbers();
+
+protected:
+	virtual void TickPool(float DeltaTime, APlayerController* PlayerController) override;
+	virtual void ReleaseAllTargets() override;
+	virtual void DestroyPool() override;
+
+	virtual void BindHealthComponent(UHealthComponent* HealthComponent) override;
+	virtual void UnbindHealthComponent(UHealthComponent* HealthComponent) override;
+
+	void AddHit(UHealthComponent* HealthComponent, float Amount, bool bIsHeal);
+	void ReleaseNumber(int32 Index);
+
+	void HandleDamage(UHealthComponent* HealthComponent, float Value);
+	void HandleHeal(UHealthComponent* HealthComponent, float Value);
+
+};
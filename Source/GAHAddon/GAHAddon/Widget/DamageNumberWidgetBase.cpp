@@ -0,0 +1,32 @@
+// Copyright (C) 2024 owoDra
+
+#include "DamageNumberWidgetBase.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(DamageNumberWidgetBase)
+
+
+UDamageNumberWidgetBase::UDamageNumberWidgetBase(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+
+void UDamageNumberWidgetBase::ShowDamageNumber(float Amount, bool bIsHeal)
+{
+	SetRenderOpacity(1.0f);
+	SetVisibility(ESlateVisibility::HitTestInvisible);
+
+	OnDamageNumberShown(Amount, bIsHeal);
+}
+
+void UDamageNumberWidgetBase::MergeDamageNumber(float Amount, int32 HitCount, bool bIsHeal)
+{
+	OnDamageNumberMerged(Amount, HitCount, bIsHeal);
+}
+
+void UDamageNumberWidgetBase::HideDamageNumber()
+{
+	SetVisibility(ESlateVisibility::Collapsed);
+
+	OnDamageNumberHidden();
+}
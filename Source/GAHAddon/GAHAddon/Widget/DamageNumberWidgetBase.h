@@ -0,0 +1,48 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Blueprint/UserWidget.h"
+
+#include "DamageNumberWidgetBase.generated.h"
+
+
+/**
+ * Base widget class for the floating damage numbers displayed by UDamageNumberSubsystem
+ * 
+ * Tips:
+ *	Widgets are pooled and reused, so reset any animation state in OnDamageNumberShown.
+ *	Position and opacity are driven natively while the number is displayed.
+ */
+UCLASS(Abstract, Blueprintable)
+class UDamageNumberWidgetBase : public UUserWidget
+{
+	GENERATED_BODY()
+public:
+	UDamageNumberWidgetBase(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+public:
+	void ShowDamageNumber(float Amount, bool bIsHeal);
+	void MergeDamageNumber(float Amount, int32 HitCount, bool bIsHeal);
+	void HideDamageNumber();
+
+protected:
+	/**
+	 * Called when the widget starts displaying a new number
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
+	void OnDamageNumberShown(float Amount, bool bIsHeal);
+
+	/**
+	 * Called when further hits on the same target have been merged into the displayed number
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
+	void OnDamageNumberMerged(float TotalAmount, int32 HitCount, bool bIsHeal);
+
+	/**
+	 * Called when the widget returns to the pool
+	 */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
+	void OnDamageNumberHidden();
+
+};
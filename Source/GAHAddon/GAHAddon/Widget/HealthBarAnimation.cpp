@@ -0,0 +1,123 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "HealthBarAnimation.h"
+
+#include "HealthBarWidgetBase.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthBarAnimation)
+
+
+#pragma region AnimatedValue
+
+void FHealthBarAnimatedValue::SetTarget(float NewTarget, float TrailDelay, bool bSnap)
+{
+	if (bSnap)
+	{
+		Target = NewTarget;
+		Displayed = NewTarget;
+		Trail = NewTarget;
+		TrailDelayRemaining = 0.0f;
+		return;
+	}
+
+	// Restart the trail delay only when the value goes down
+
+	if (NewTarget < Target)
+	{
+		TrailDelayRemaining = TrailDelay;
+	}
+
+	Target = NewTarget;
+}
+
+bool FHealthBarAnimatedValue::Advance(float DeltaTime, float SmoothingSpeed, float TrailDecayRate)
+{
+	// Smooth the displayed value towards the target
+
+	if (SmoothingSpeed > 0.0f)
+	{
+		Displayed = FMath::FInterpTo(Displayed, Target, DeltaTime, SmoothingSpeed);
+
+		if (FMath::IsNearlyEqual(Displayed, Target, UE_KINDA_SMALL_NUMBER))
+		{
+			Displayed = Target;
+		}
+	}
+	else
+	{
+		Displayed = Target;
+	}
+
+	// The trail never falls behind the displayed value and decays after the delay
+
+	if (Trail <= Displayed)
+	{
+		Trail = Displayed;
+	}
+	else if (TrailDelayRemaining > 0.0f)
+	{
+		TrailDelayRemaining -= DeltaTime;
+	}
+	else
+	{
+		Trail = (TrailDecayRate > 0.0f) ? FMath::Max(Displayed, Trail - (TrailDecayRate * DeltaTime)) : Displayed;
+	}
+
+	return IsAnimating();
+}
+
+#pragma endregion
+
+
+#pragma region Animator
+
+FHealthBarAnimator& FHealthBarAnimator::Get()
+{
+	static FHealthBarAnimator Instance;
+	return Instance;
+}
+
+void FHealthBarAnimator::AddWidget(UHealthBarWidgetBase* Widget)
+{
+	if (!Widget)
+	{
+		return;
+	}
+
+	ActiveWidgets.AddUnique(Widget);
+
+	if (!TickerHandle.IsValid())
+	{
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FHealthBarAnimator::Tick));
+	}
+}
+
+void FHealthBarAnimator::RemoveWidget(UHealthBarWidgetBase* Widget)
+{
+	ActiveWidgets.RemoveSingleSwap(Widget);
+}
+
+bool FHealthBarAnimator::Tick(float DeltaTime)
+{
+	for (auto Index{ ActiveWidgets.Num() - 1 }; Index >= 0; --Index)
+	{
+		auto* Widget{ ActiveWidgets[Index].Get() };
+
+		if (!Widget || !Widget->AdvanceHealthAnimation(DeltaTime))
+		{
+			ActiveWidgets.RemoveAtSwap(Index);
+		}
+	}
+
+	// Stop ticking while no health bar is animating
+
+	if (ActiveWidgets.IsEmpty())
+	{
+		TickerHandle.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+#pragma endregion
@@ -0,0 +1,90 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Containers/Ticker.h"
+
+#include "HealthBarAnimation.generated.h"
+
+class UHealthBarWidgetBase;
+
+
+/**
+ * Animated value of a health bar with smoothing and a delayed damage trail
+ */
+USTRUCT(BlueprintType)
+struct GAHADDON_API FHealthBarAnimatedValue
+{
+	GENERATED_BODY()
+public:
+	FHealthBarAnimatedValue() {}
+
+public:
+	//
+	// Value to be displayed eventually
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float Target{ 0.0f };
+
+	//
+	// Value currently displayed, approaching Target
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float Displayed{ 0.0f };
+
+	//
+	// Value of the damage trail, which stays at the previous value and then decays to Displayed
+	//
+	UPROPERTY(BlueprintReadOnly)
+	float Trail{ 0.0f };
+
+	//
+	// Seconds remaining before the trail starts to decay
+	//
+	float TrailDelayRemaining{ 0.0f };
+
+public:
+	/**
+	 * Set a new target value. If bSnap, the displayed and trail values jump to it immediately.
+	 */
+	void SetTarget(float NewTarget, float TrailDelay, bool bSnap);
+
+	/**
+	 * Advance the animation. Returns true while the value is still animating.
+	 */
+	bool Advance(float DeltaTime, float SmoothingSpeed, float TrailDecayRate);
+
+	bool IsAnimating() const { return (Displayed != Target) || (Trail != Displayed); }
+
+};
+
+
+/**
+ * Shared ticker that advances the animation of all health bars that are currently animating in a single loop.
+ * Health bars at rest are removed and cost nothing.
+ */
+class GAHADDON_API FHealthBarAnimator
+{
+public:
+	static FHealthBarAnimator& Get();
+
+protected:
+	TArray<TWeakObjectPtr<UHealthBarWidgetBase>> ActiveWidgets;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+public:
+	/**
+	 * Start advancing the animation of the widget until it comes to rest
+	 */
+	void AddWidget(UHealthBarWidgetBase* Widget);
+
+	/**
+	 * Stop advancing the animation of the widget
+	 */
+	void RemoveWidget(UHealthBarWidgetBase* Widget);
+
+protected:
+	bool Tick(float DeltaTime);
+
+};
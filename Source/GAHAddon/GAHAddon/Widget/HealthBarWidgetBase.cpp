@@ -2,11 +2,15 @@
 
 #include "HealthBarWidgetBase.h"
 
+#include "HealthLayerBar.h"
+
 #include "HealthFunctionLibrary.h"
 #include "HealthComponent.h"
 
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(HealthBarWidgetBase)
 
@@ -21,9 +25,12 @@ void UHealthBarWidgetBase::NativeOnInitialized()
 {
 	Super::NativeOnInitialized();
 
-	ListenPawnChange();
+	if (bFollowOwningPlayerPawn)
+	{
+		ListenPawnChange();
 
-	RefreshHealthComponent(GetOwningPlayerPawn());
+		RefreshHealthComponent(GetOwningPlayerPawn());
+	}
 }
 
 void UHealthBarWidgetBase::NativeDestruct()
@@ -32,6 +39,13 @@ void UHealthBarWidgetBase::NativeDestruct()
 
 	UnlistenHealthEvents();
 	UnlistenPawnChange();
+
+	FHealthBarAnimator::Get().RemoveWidget(this);
+
+	if (auto* World{ GetWorld() })
+	{
+		World->GetTimerManager().ClearTimer(SnapshotFlushTimer);
+	}
 }
 
 
@@ -67,37 +81,77 @@ void UHealthBarWidgetBase::RefreshHealthComponent(APawn* InPawn)
 {
 	if (auto* NewHealthComponent{ UHealthFunctionLibrary::GetHealthComponentFromActor(InPawn) })
 	{
-		UnlistenHealthEvents();
+		SetHealthComponent(NewHealthComponent);
+	}
+}
 
-		HealthComponent = NewHealthComponent;
+void UHealthBarWidgetBase::SetObservedActor(AActor* InActor)
+{
+	SetObservedHealthComponent(UHealthFunctionLibrary::GetHealthComponentFromActor(InActor));
+}
+
+void UHealthBarWidgetBase::SetObservedHealthComponent(UHealthComponent* InHealthComponent)
+{
+	if (bFollowOwningPlayerPawn)
+	{
+		bFollowOwningPlayerPawn = false;
 
+		UnlistenPawnChange();
+	}
+
+	SetHealthComponent(InHealthComponent);
+}
+
+void UHealthBarWidgetBase::SetHealthComponent(UHealthComponent* NewHealthComponent)
+{
+	if (HealthComponent.Get() == NewHealthComponent)
+	{
+		return;
+	}
+
+	UnlistenHealthEvents();
+
+	HealthComponent = NewHealthComponent;
+
+	if (HealthComponent.IsValid())
+	{
 		ListenHealthEvents();
 
 		RefreshHealthValues();
 	}
+	else
+	{
+		HealthSnapshot = FHealthSnapshot();
+		PendingSnapshotFields = EHealthSnapshotField::None;
+
+		UpdateAnimationTargets(true);
+	}
 }
 
 void UHealthBarWidgetBase::RefreshHealthValues()
 {
 	if (HealthComponent.IsValid())
 	{
-		const auto Health{ HealthComponent->GetHealth() };
-		OnHealthChanged(Health, Health);
+		if (bBroadcastPerFieldEvents)
+		{
+			const auto Health{ HealthComponent->GetHealth() };
+			OnHealthChanged(Health, Health);
 
-		const auto MaxHealth{ HealthComponent->GetMaxHealth() };
-		OnMaxHealthChanged(MaxHealth, MaxHealth);
+			const auto MaxHealth{ HealthComponent->GetMaxHealth() };
+			OnMaxHealthChanged(MaxHealth, MaxHealth);
 
-		const auto MinHealth{ HealthComponent->GetMinHealth() };
-		OnMinHealthChanged(MinHealth, MinHealth);
+			const auto MinHealth{ HealthComponent->GetMinHealth() };
+			OnMinHealthChanged(MinHealth, MinHealth);
 
-		const auto ExtraHealth{ HealthComponent->GetExtraHealth() };
-		OnExtraHealthChanged(ExtraHealth, ExtraHealth);
+			const auto ExtraHealth{ HealthComponent->GetExtraHealth() };
+			OnExtraHealthChanged(ExtraHealth, ExtraHealth);
 
-		const auto Shield{ HealthComponent->GetShield() };
-		OnShieldChanged(Shield, Shield);
+			const auto Shield{ HealthComponent->GetShield() };
+			OnShieldChanged(Shield, Shield);
 
-		const auto MaxShield{ HealthComponent->GetMaxShield() };
-		OnMaxShieldChanged(MaxShield, MaxShield);
+			const auto MaxShield{ HealthComponent->GetMaxShield() };
+			OnMaxShieldChanged(MaxShield, MaxShield);
+		}
 
 		if (HealthComponent->IsDeadOrDying())
 		{
@@ -107,6 +161,14 @@ void UHealthBarWidgetBase::RefreshHealthValues()
 		{
 			OnRevive();
 		}
+
+		// Notify all values immediately instead of waiting for the next tick
+
+		PendingSnapshotFields = EHealthSnapshotField::All;
+
+		FlushHealthSnapshot();
+
+		UpdateAnimationTargets(true);
 	}
 }
 
@@ -114,96 +176,185 @@ void UHealthBarWidgetBase::ListenHealthEvents()
 {
 	if (HealthComponent.IsValid())
 	{
-		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleHealthChanged));
-			HealthComponent->OnHealthChanged.Add(NewDelegate);
-		}
+		HealthComponent->OnHealthChangedNative.AddUObject(this, &ThisClass::HandleHealthChanged);
+		HealthComponent->OnMaxHealthChangedNative.AddUObject(this, &ThisClass::HandleMaxHealthChanged);
+		HealthComponent->OnMinHealthChangedNative.AddUObject(this, &ThisClass::HandleMinHealthChanged);
+		HealthComponent->OnExtraHealthChangedNative.AddUObject(this, &ThisClass::HandleExtraHealthChanged);
+		HealthComponent->OnShieldChangedNative.AddUObject(this, &ThisClass::HandleShieldChanged);
+		HealthComponent->OnMaxShieldChangedNative.AddUObject(this, &ThisClass::HandleMaxShieldChanged);
+		HealthComponent->OnDeathStartedNative.AddUObject(this, &ThisClass::HandleDeath);
+		HealthComponent->OnRevivedNative.AddUObject(this, &ThisClass::HandleRevive);
+	}
+}
 
-		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleMaxHealthChanged));
-			HealthComponent->OnMaxHealthChanged.Add(NewDelegate);
-		}
+void UHealthBarWidgetBase::UnlistenHealthEvents()
+{
+	if (HealthComponent.IsValid())
+	{
+		HealthComponent->OnHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnMaxHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnMinHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnExtraHealthChangedNative.RemoveAll(this);
+		HealthComponent->OnShieldChangedNative.RemoveAll(this);
+		HealthComponent->OnMaxShieldChangedNative.RemoveAll(this);
+		HealthComponent->OnDeathStartedNative.RemoveAll(this);
+		HealthComponent->OnRevivedNative.RemoveAll(this);
+	}
+}
 
-		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleMinHealthChanged));
-			HealthComponent->OnMinHealthChanged.Add(NewDelegate);
-		}
 
-		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleExtraHealthChanged));
-			HealthComponent->OnExtraHealthChanged.Add(NewDelegate);
-		}
+void UHealthBarWidgetBase::MarkSnapshotDirty(EHealthSnapshotField Fields)
+{
+	PendingSnapshotFields |= Fields;
 
+	if (!SnapshotFlushTimer.IsValid())
+	{
+		if (auto* World{ GetWorld() })
 		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleShieldChanged));
-			HealthComponent->OnShieldChanged.Add(NewDelegate);
+			SnapshotFlushTimer = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ThisClass::FlushHealthSnapshot));
 		}
+	}
+}
 
+void UHealthBarWidgetBase::FlushHealthSnapshot()
+{
+	if (SnapshotFlushTimer.IsValid())
+	{
+		if (auto* World{ GetWorld() })
 		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleMaxShieldChanged));
-			HealthComponent->OnMaxShieldChanged.Add(NewDelegate);
+			World->GetTimerManager().ClearTimer(SnapshotFlushTimer);
 		}
 
-		{
-			FScriptDelegate NewDelegate;
-			NewDelegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(UHealthBarWidgetBase, HandleDeath));
-			HealthComponent->OnDeathStarted.Add(NewDelegate);
-		}
+		SnapshotFlushTimer.Invalidate();
+	}
+
+	const auto ChangedFields{ PendingSnapshotFields };
+	PendingSnapshotFields = EHealthSnapshotField::None;
+
+	if (!HealthComponent.IsValid() || (ChangedFields == EHealthSnapshotField::None))
+	{
+		return;
 	}
+
+	HealthSnapshot = FHealthSnapshot::MakeFromComponent(HealthComponent.Get());
+
+	UpdateAnimationTargets(!bAnimateValues);
+
+	OnHealthSnapshotChangedNative.Broadcast(HealthSnapshot, ChangedFields);
+	OnHealthSnapshotChanged(HealthSnapshot, static_cast<int32>(ChangedFields));
 }
 
-void UHealthBarWidgetBase::UnlistenHealthEvents()
+
+void UHealthBarWidgetBase::UpdateAnimationTargets(bool bSnap)
 {
-	if (HealthComponent.IsValid())
+	AnimatedHealth.SetTarget(HealthSnapshot.HealthRatio, TrailDelay, bSnap);
+	AnimatedShield.SetTarget(HealthSnapshot.ShieldRatio, TrailDelay, bSnap);
+	AnimatedTotalHealth.SetTarget(HealthSnapshot.TotalHealthRatio, TrailDelay, bSnap);
+
+	if (LayerBar)
+	{
+		LayerBar->SetSnapshot(HealthSnapshot);
+		LayerBar->SetTrailRatio(AnimatedTotalHealth.Trail);
+	}
+
+	if (IsHealthAnimating())
+	{
+		FHealthBarAnimator::Get().AddWidget(this);
+	}
+}
+
+bool UHealthBarWidgetBase::AdvanceHealthAnimation(float DeltaTime)
+{
+	auto bAnimating{ false };
+
+	bAnimating |= AnimatedHealth.Advance(DeltaTime, SmoothingSpeed, TrailDecayRate);
+	bAnimating |= AnimatedShield.Advance(DeltaTime, SmoothingSpeed, TrailDecayRate);
+	bAnimating |= AnimatedTotalHealth.Advance(DeltaTime, SmoothingSpeed, TrailDecayRate);
+
+	if (LayerBar)
 	{
-		HealthComponent->OnHealthChanged.RemoveAll(this);
-		HealthComponent->OnMaxHealthChanged.RemoveAll(this);
-		HealthComponent->OnMinHealthChanged.RemoveAll(this);
-		HealthComponent->OnExtraHealthChanged.RemoveAll(this);
-		HealthComponent->OnShieldChanged.RemoveAll(this);
-		HealthComponent->OnMaxShieldChanged.RemoveAll(this);
-		HealthComponent->OnDeathStarted.RemoveAll(this);
+		LayerBar->SetTrailRatio(AnimatedTotalHealth.Trail);
 	}
+
+	return bAnimating;
+}
+
+bool UHealthBarWidgetBase::IsHealthAnimating() const
+{
+	return (AnimatedHealth.IsAnimating() || AnimatedShield.IsAnimating() || AnimatedTotalHealth.IsAnimating());
 }
 
 
 void UHealthBarWidgetBase::HandleHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator)
 {
-	OnHealthChanged(NewValue, OldValue);
+	if (bBroadcastPerFieldEvents)
+	{
+		OnHealthChanged(NewValue, OldValue);
+	}
+
+	MarkSnapshotDirty(EHealthSnapshotField::Health);
 }
 
 void UHealthBarWidgetBase::HandleMaxHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator)
 {
-	OnMaxHealthChanged(NewValue, OldValue);
+	if (bBroadcastPerFieldEvents)
+	{
+		OnMaxHealthChanged(NewValue, OldValue);
+	}
+
+	MarkSnapshotDirty(EHealthSnapshotField::MaxHealth);
 }
 
 void UHealthBarWidgetBase::HandleMinHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator)
 {
-	OnMinHealthChanged(NewValue, OldValue);
+	if (bBroadcastPerFieldEvents)
+	{
+		OnMinHealthChanged(NewValue, OldValue);
+	}
+
+	MarkSnapshotDirty(EHealthSnapshotField::MinHealth);
 }
 
 void UHealthBarWidgetBase::HandleExtraHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator)
 {
-	OnExtraHealthChanged(NewValue, OldValue);
+	if (bBroadcastPerFieldEvents)
+	{
+		OnExtraHealthChanged(NewValue, OldValue);
+	}
+
+	MarkSnapshotDirty(EHealthSnapshotField::ExtraHealth);
 }
 
 void UHealthBarWidgetBase::HandleShieldChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator)
 {
-	OnShieldChanged(NewValue, OldValue);
+	if (bBroadcastPerFieldEvents)
+	{
+		OnShieldChanged(NewValue, OldValue);
+	}
+
+	MarkSnapshotDirty(EHealthSnapshotField::Shield);
 }
 
 void UHealthBarWidgetBase::HandleMaxShieldChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator)
 {
-	OnMaxShieldChanged(NewValue, OldValue);
+	if (bBroadcastPerFieldEvents)
+	{
+		OnMaxShieldChanged(NewValue, OldValue);
+	}
+
+	MarkSnapshotDirty(EHealthSnapshotField::MaxShield);
 }
 
 void UHealthBarWidgetBase::HandleDeath(AActor* OwningActor)
 {
 	OnDeath();
+
+	MarkSnapshotDirty(EHealthSnapshotField::DeathState);
+}
+
+void UHealthBarWidgetBase::HandleRevive(AActor* OwningActor)
+{
+	OnRevive();
+
+	MarkSnapshotDirty(EHealthSnapshotField::DeathState);
 }
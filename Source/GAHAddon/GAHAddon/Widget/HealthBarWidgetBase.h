@@ -4,15 +4,25 @@
 
 #include "Blueprint/UserWidget.h"
 
+#include "HealthSnapshot.h"
+#include "HealthBarAnimation.h"
+
 #include "HealthBarWidgetBase.generated.h"
 
 class UHealthComponent;
+class UHealthLayerBar;
 class APawn;
 class AActor;
 
 
 /**
  * Base widget class that automatically observes HealthComponent changes and provides basic functionality for health bar implementation
+ * 
+ * Tips:
+ *	Changes made within a frame are collected and notified once per frame through OnHealthSnapshotChanged.
+ *	Per-value events (OnHealthChanged, OnShieldChanged...) are only called if bBroadcastPerFieldEvents is enabled.
+ *	Smoothed and damage trail values of the health, shield and total health ratios are animated natively
+ *	and can be read from AnimatedHealth, AnimatedShield and AnimatedTotalHealth without a Blueprint tick.
  */
 UCLASS(Abstract, Blueprintable)
 class UHealthBarWidgetBase : public UUserWidget
@@ -34,6 +44,13 @@ private:
 
 
 protected:
+	//
+	// If enabled, observes the health component of the pawn possessed by the owning player.
+	// Disabled automatically when an actor is set with SetObservedActor.
+	//
+	UPROPERTY(EditAnywhere, Category = "Health")
+	bool bFollowOwningPlayerPawn{ true };
+
 	UPROPERTY(BlueprintReadOnly, Transient, Category = "Components")
 	TWeakObjectPtr<UHealthComponent> HealthComponent;
 
@@ -41,6 +58,25 @@ protected:
 	UFUNCTION(BlueprintCallable, Category = "Health")
 	virtual void RefreshHealthComponent(APawn* InPawn);
 
+public:
+	/**
+	 * Observe the health component of the actor instead of the owning player's pawn.
+	 * Passing nullptr stops observing.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void SetObservedActor(AActor* InActor);
+
+	/**
+	 * Observe the health component instead of the owning player's pawn.
+	 * Passing nullptr stops observing.
+	 */
+	void SetObservedHealthComponent(UHealthComponent* InHealthComponent);
+
+	UHealthComponent* GetHealthComponent() const { return HealthComponent.Get(); }
+
+protected:
+	void SetHealthComponent(UHealthComponent* NewHealthComponent);
+
 	UFUNCTION(BlueprintCallable, Category = "Health")
 	virtual void RefreshHealthValues();
 
@@ -48,29 +84,115 @@ protected:
 	void UnlistenHealthEvents();
 
 
+protected:
+	//
+	// If enabled, per-value events are called every time a value changes in addition to OnHealthSnapshotChanged
+	//
+	UPROPERTY(EditAnywhere, Category = "Health")
+	bool bBroadcastPerFieldEvents{ false };
+
+	//
+	// Latest snapshot of the observed health component values
+	//
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Health")
+	FHealthSnapshot HealthSnapshot;
+
+	//
+	// Fields changed since the last snapshot notification
+	//
+	EHealthSnapshotField PendingSnapshotFields{ EHealthSnapshotField::None };
+
+	FTimerHandle SnapshotFlushTimer;
+
+public:
+	//
+	// Native delegate called at the same time as OnHealthSnapshotChanged
+	//
+	FOnHealthSnapshotChangedNativeDelegate OnHealthSnapshotChangedNative;
+
+protected:
+	/**
+	 * Mark fields of the snapshot as changed and schedule the notification for the next tick
+	 */
+	void MarkSnapshotDirty(EHealthSnapshotField Fields);
+
+	/**
+	 * Update the snapshot and notify the changed fields
+	 */
+	void FlushHealthSnapshot();
+
+
+protected:
+	//
+	// If enabled, ratios are smoothed and followed by a delayed damage trail. Otherwise they snap to the new value.
+	//
+	UPROPERTY(EditAnywhere, Category = "Health|Animation")
+	bool bAnimateValues{ true };
+
+	//
+	// Speed at which displayed ratios approach their target
+	//
+	UPROPERTY(EditAnywhere, Category = "Health|Animation", Meta = (EditCondition = "bAnimateValues", ClampMin = 0.0))
+	float SmoothingSpeed{ 12.0f };
+
+	//
+	// Seconds the damage trail stays before starting to decay
+	//
+	UPROPERTY(EditAnywhere, Category = "Health|Animation", Meta = (EditCondition = "bAnimateValues", ClampMin = 0.0))
+	float TrailDelay{ 0.5f };
+
+	//
+	// Ratio per second at which the damage trail decays
+	//
+	UPROPERTY(EditAnywhere, Category = "Health|Animation", Meta = (EditCondition = "bAnimateValues", ClampMin = 0.0))
+	float TrailDecayRate{ 0.6f };
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Health|Animation")
+	FHealthBarAnimatedValue AnimatedHealth;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Health|Animation")
+	FHealthBarAnimatedValue AnimatedShield;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Health|Animation")
+	FHealthBarAnimatedValue AnimatedTotalHealth;
+
+	//
+	// Optional layer bar updated with the snapshot and the damage trail of the total health
+	//
+	UPROPERTY(BlueprintReadOnly, Category = "Health", Meta = (BindWidgetOptional))
+	TObjectPtr<UHealthLayerBar> LayerBar;
+
+protected:
+	/**
+	 * Set the animation targets from the current snapshot
+	 */
+	void UpdateAnimationTargets(bool bSnap);
+
+public:
+	/**
+	 * Advance the animated values. Returns true while any value is still animating.
+	 * Called by FHealthBarAnimator.
+	 */
+	bool AdvanceHealthAnimation(float DeltaTime);
+
+	UFUNCTION(BlueprintCallable, Category = "Health|Animation")
+	bool IsHealthAnimating() const;
+
+
 private:
-	UFUNCTION()
 	void HandleHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator);
-
-	UFUNCTION()
 	void HandleMaxHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator);
-
-	UFUNCTION()
 	void HandleMinHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator);
-
-	UFUNCTION()
 	void HandleExtraHealthChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator);
-
-	UFUNCTION()
 	void HandleShieldChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator);
-
-	UFUNCTION()
 	void HandleMaxShieldChanged(UHealthComponent* InHealthComponent, float OldValue, float NewValue, AActor* Instigator);
-
-	UFUNCTION()
 	void HandleDeath(AActor* OwningActor);
+	void HandleRevive(AActor* OwningActor);
 
 protected:
+	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
+	void OnHealthSnapshotChanged(const FHealthSnapshot& Snapshot, UPARAM(Meta = (Bitmask, BitmaskEnum = "/Script/GAHAddon.EHealthSnapshotField")) int32 ChangedFields);
+
 	UFUNCTION(BlueprintImplementableEvent, Category = "Health")
 	void OnHealthChanged(float NewValue, float OldValue);
 
@@ -0,0 +1,75 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthLayerBar.h"
+
+#include "Slate/SHealthLayerBar.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthLayerBar)
+
+#define LOCTEXT_NAMESPACE "GAHAddon"
+
+
+UHealthLayerBar::UHealthLayerBar(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetVisibilityInternal(ESlateVisibility::HitTestInvisible);
+}
+
+void UHealthLayerBar::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+
+	if (MyLayerBar.IsValid())
+	{
+		MyLayerBar->SetStyle(&Style);
+		MyLayerBar->SetDesiredSize(DesiredSize);
+		MyLayerBar->SetSnapshot(Snapshot);
+		MyLayerBar->SetTrailRatio(TrailRatio);
+	}
+}
+
+void UHealthLayerBar::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+
+	MyLayerBar.Reset();
+}
+
+#if WITH_EDITOR
+const FText UHealthLayerBar::GetPaletteCategory()
+{
+	return LOCTEXT("Health", "Health");
+}
+#endif
+
+TSharedRef<SWidget> UHealthLayerBar::RebuildWidget()
+{
+	MyLayerBar = SNew(SHealthLayerBar)
+		.Style(&Style)
+		.DesiredSize(DesiredSize);
+
+	return MyLayerBar.ToSharedRef();
+}
+
+
+void UHealthLayerBar::SetSnapshot(const FHealthSnapshot& InSnapshot)
+{
+	Snapshot = InSnapshot;
+
+	if (MyLayerBar.IsValid())
+	{
+		MyLayerBar->SetSnapshot(Snapshot);
+	}
+}
+
+void UHealthLayerBar::SetTrailRatio(float InTrailRatio)
+{
+	TrailRatio = InTrailRatio;
+
+	if (MyLayerBar.IsValid())
+	{
+		MyLayerBar->SetTrailRatio(TrailRatio);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
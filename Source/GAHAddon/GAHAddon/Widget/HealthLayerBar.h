@@ -0,0 +1,66 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Components/Widget.h"
+
+#include "HealthLayerBarStyle.h"
+#include "HealthSnapshot.h"
+
+#include "HealthLayerBar.generated.h"
+
+class SHealthLayerBar;
+
+
+/**
+ * Widget that draws all layers of a health bar (health, extra health, shield, damage trail and min health marker) without child widgets
+ * 
+ * Tips:
+ *	If placed in a UHealthBarWidgetBase with the name "LayerBar", it is updated automatically.
+ */
+UCLASS()
+class GAHADDON_API UHealthLayerBar : public UWidget
+{
+	GENERATED_BODY()
+public:
+	UHealthLayerBar(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual void SynchronizeProperties() override;
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+#if WITH_EDITOR
+	virtual const FText GetPaletteCategory() override;
+#endif
+
+protected:
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+
+protected:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance")
+	FHealthLayerBarStyle Style;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance")
+	FVector2D DesiredSize{ 200.0, 12.0 };
+
+	//
+	// Last values set, kept so that they survive a rebuild of the slate widget
+	//
+	UPROPERTY(Transient)
+	FHealthSnapshot Snapshot;
+
+	UPROPERTY(Transient)
+	float TrailRatio{ 0.0f };
+
+	TSharedPtr<SHealthLayerBar> MyLayerBar;
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void SetSnapshot(const FHealthSnapshot& InSnapshot);
+
+	/**
+	 * Set the ratio of the total max health at which the damage trail ends
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void SetTrailRatio(float InTrailRatio);
+
+};
@@ -0,0 +1,48 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Styling/SlateBrush.h"
+
+#include "HealthLayerBarStyle.generated.h"
+
+
+/**
+ * Appearance of the health layer bar
+ */
+USTRUCT(BlueprintType)
+struct GAHADDON_API FHealthLayerBarStyle
+{
+	GENERATED_BODY()
+public:
+	FHealthLayerBarStyle() {}
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FSlateBrush BackgroundBrush;
+
+	//
+	// Brush used for every layer. Layers share the brush so that they are drawn in a single batch.
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FSlateBrush FillBrush;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FLinearColor HealthColor{ FLinearColor(0.1f, 0.8f, 0.2f) };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FLinearColor ExtraHealthColor{ FLinearColor(0.9f, 0.8f, 0.2f) };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FLinearColor ShieldColor{ FLinearColor(0.2f, 0.6f, 1.0f) };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FLinearColor TrailColor{ FLinearColor(0.9f, 0.1f, 0.1f) };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance")
+	FLinearColor MinHealthMarkerColor{ FLinearColor::White };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance", Meta = (ClampMin = 0.0))
+	float MinHealthMarkerWidth{ 2.0f };
+
+};
@@ -0,0 +1,125 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthWidgetPoolSubsystem.h"
+
+#include "Subsystem/HealthComponentRegistrySubsystem.h"
+#include "HealthComponent.h"
+
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/Pawn.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthWidgetPoolSubsystem)
+
+
+void UHealthWidgetPoolSubsystem::Deinitialize()
+{
+	DeactivatePool();
+	DestroyPool();
+
+	Super::Deinitialize();
+}
+
+void UHealthWidgetPoolSubsystem::Tick(float DeltaTime)
+{
+	auto* PlayerController{ GetPlayerController() };
+	if (!PlayerController)
+	{
+		return;
+	}
+
+	// Rebind when the world has changed
+
+	auto* Registry{ UWorld::GetSubsystem<UHealthComponentRegistrySubsystem>(GetWorld()) };
+	if (Registry != BoundRegistry.Get())
+	{
+		ReleaseAllTargets();
+
+		BindRegistry(Registry);
+	}
+
+	TickPool(DeltaTime, PlayerController);
+}
+
+
+void UHealthWidgetPoolSubsystem::ActivatePool()
+{
+	BindRegistry(UWorld::GetSubsystem<UHealthComponentRegistrySubsystem>(GetWorld()));
+
+	bActive = true;
+}
+
+void UHealthWidgetPoolSubsystem::DeactivatePool()
+{
+	bActive = false;
+
+	UnbindRegistry();
+}
+
+
+void UHealthWidgetPoolSubsystem::BindRegistry(UHealthComponentRegistrySubsystem* Registry)
+{
+	UnbindRegistry();
+
+	if (Registry)
+	{
+		Registry->OnHealthComponentRegistered.AddUObject(this, &ThisClass::HandleHealthComponentRegistered);
+		Registry->OnHealthComponentUnregistered.AddUObject(this, &ThisClass::HandleHealthComponentUnregistered);
+
+		for (const auto& HealthComponent : Registry->GetHealthComponents())
+		{
+			BindHealthComponent(HealthComponent);
+		}
+
+		BoundRegistry = Registry;
+	}
+}
+
+void UHealthWidgetPoolSubsystem::UnbindRegistry()
+{
+	if (auto* Registry{ BoundRegistry.Get() })
+	{
+		Registry->OnHealthComponentRegistered.RemoveAll(this);
+		Registry->OnHealthComponentUnregistered.RemoveAll(this);
+
+		for (const auto& HealthComponent : Registry->GetHealthComponents())
+		{
+			UnbindHealthComponent(HealthComponent);
+		}
+	}
+
+	BoundRegistry.Reset();
+}
+
+void UHealthWidgetPoolSubsystem::HandleHealthComponentRegistered(UHealthComponent* HealthComponent)
+{
+	BindHealthComponent(HealthComponent);
+}
+
+void UHealthWidgetPoolSubsystem::HandleHealthComponentUnregistered(UHealthComponent* HealthComponent)
+{
+	UnbindHealthComponent(HealthComponent);
+}
+
+
+APlayerController* UHealthWidgetPoolSubsystem::GetPlayerController() const
+{
+	auto* World{ GetWorld() };
+	return World ? GetLocalPlayer()->GetPlayerController(World) : nullptr;
+}
+
+AActor* UHealthWidgetPoolSubsystem::GetDisplayActor(const UHealthComponent* HealthComponent)
+{
+	auto* Owner{ HealthComponent ? HealthComponent->GetOwner() : nullptr };
+
+	// The component may live on the player state of the pawn
+
+	if (auto* PlayerState{ Cast<APlayerState>(Owner) })
+	{
+		return PlayerState->GetPawn();
+	}
+
+	return Owner;
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "Tickable.h"
+
+#include "HealthWidgetPoolSubsystem.generated.h"
+
+class UHealthComponent;
+class UHealthComponentRegistrySubsystem;
+class APlayerController;
+class AActor;
+
+
+/**
+ * Base class of the local player subsystems that display a fixed pool of widgets over the health components of the world
+ * 
+ * Tips:
+ *	Ticks only while the pool is active and rebinds to the health component registry of the current world,
+ *	releasing every widget when the world changes.
+ */
+UCLASS(Abstract)
+class GAHADDON_API UHealthWidgetPoolSubsystem : public ULocalPlayerSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	UHealthWidgetPoolSubsystem() {}
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override { return bActive; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UHealthWidgetPoolSubsystem, STATGROUP_Tickables); }
+
+protected:
+	TWeakObjectPtr<UHealthComponentRegistrySubsystem> BoundRegistry;
+
+	bool bActive{ false };
+
+protected:
+	/**
+	 * Start ticking and bind to the registry of the current world, called once the widgets are created
+	 */
+	void ActivatePool();
+
+	/**
+	 * Stop ticking and unbind from the registry, called before the widgets are removed
+	 */
+	void DeactivatePool();
+
+	/**
+	 * Update the widgets for the frame
+	 */
+	virtual void TickPool(float DeltaTime, APlayerController* PlayerController) {}
+
+	/**
+	 * Release the targets of every widget, e.g. when the world has changed
+	 */
+	virtual void ReleaseAllTargets() {}
+
+	/**
+	 * Remove every widget of the pool
+	 */
+	virtual void DestroyPool() {}
+
+	void BindRegistry(UHealthComponentRegistrySubsystem* Registry);
+	void UnbindRegistry();
+
+	/**
+	 * Called for every health component of the bound registry, including the ones registered before binding
+	 */
+	virtual void BindHealthComponent(UHealthComponent* HealthComponent) {}
+	virtual void UnbindHealthComponent(UHealthComponent* HealthComponent) {}
+
+	void HandleHealthComponentRegistered(UHealthComponent* HealthComponent);
+	void HandleHealthComponentUnregistered(UHealthComponent* HealthComponent);
+
+	/**
+	 * Returns the player controller of the local player in the current world
+	 */
+	APlayerController* GetPlayerController() const;
+
+	/**
+	 * Returns the actor over which the widgets of the health component are displayed
+	 */
+	static AActor* GetDisplayActor(const UHealthComponent* HealthComponent);
+
+};
@@ -0,0 +1,290 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "OverheadHealthBarSubsystem.h"
+
+#include "Subsystem/HealthComponentRegistrySubsystem.h"
+#include "HealthBarWidgetBase.h"
+#include "HealthComponent.h"
+#include "GAHAddonLogs.h"
+
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(OverheadHealthBarSubsystem)
+
+
+void UOverheadHealthBarSubsystem::TickPool(float DeltaTime, APlayerController* PlayerController)
+{
+	AssignmentTimeRemaining -= DeltaTime;
+
+	if (AssignmentTimeRemaining <= 0.0f)
+	{
+		AssignmentTimeRemaining = Settings.AssignmentInterval;
+
+		UpdateAssignments(PlayerController);
+	}
+
+	UpdatePositions(PlayerController);
+}
+
+
+void UOverheadHealthBarSubsystem::StartOverheadHealthBars(const FOverheadHealthBarSettings& InSettings)
+{
+	StopOverheadHealthBars();
+
+	auto* PlayerController{ GetPlayerController() };
+
+	if (!PlayerController || !InSettings.WidgetClass)
+	{
+		UE_LOG(LogGAHA, Warning, TEXT("UOverheadHealthBarSubsystem::StartOverheadHealthBars: No player controller or widget class."));
+		return;
+	}
+
+	Settings = InSettings;
+
+	for (auto Index{ 0 }; Index < Settings.PoolSize; ++Index)
+	{
+		auto* NewBar{ CreateWidget<UHealthBarWidgetBase>(PlayerController, Settings.WidgetClass) };
+		if (!NewBar)
+		{
+			continue;
+		}
+
+		NewBar->SetObservedHealthComponent(nullptr);
+		NewBar->SetAlignmentInViewport(FVector2D(0.5, 1.0));
+		NewBar->SetVisibility(ESlateVisibility::Collapsed);
+		NewBar->AddToPlayerScreen(Settings.ZOrder);
+
+		Bars.Add(NewBar);
+		BarTargets.AddDefaulted();
+	}
+
+	AssignmentTimeRemaining = 0.0f;
+
+	ActivatePool();
+}
+
+void UOverheadHealthBarSubsystem::StopOverheadHealthBars()
+{
+	DeactivatePool();
+	DestroyPool();
+}
+
+
+void UOverheadHealthBarSubsystem::ReleaseAllTargets()
+{
+	for (auto Index{ 0 }; Index < Bars.Num(); ++Index)
+	{
+		AssignBar(Index, nullptr);
+	}
+
+	AssignmentTimeRemaining = 0.0f;
+}
+
+void UOverheadHealthBarSubsystem::DestroyPool()
+{
+	for (const auto& Bar : Bars)
+	{
+		if (Bar)
+		{
+			Bar->SetObservedHealthComponent(nullptr);
+			Bar->RemoveFromParent();
+		}
+	}
+
+	Bars.Reset();
+	BarTargets.Reset();
+}
+
+
+void UOverheadHealthBarSubsystem::UpdateAssignments(APlayerController* PlayerController)
+{
+	auto* Registry{ BoundRegistry.Get() };
+	if (!Registry)
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	auto ViewportSizeX{ 0 };
+	auto ViewportSizeY{ 0 };
+	PlayerController->GetViewportSize(ViewportSizeX, ViewportSizeY);
+
+	const auto MaxDistanceSquared{ FMath::Square(Settings.MaxDistance) };
+	const auto CurrentTime{ GetWorld()->GetTimeSeconds() };
+	const auto* LocalPawn{ PlayerController->GetPawn() };
+
+	// Collect actors in range and in view, scored by distance and recent damage (lower is better)
+
+	TArray<TPair<float, UHealthComponent*>> Candidates;
+
+	for (const auto& HealthComponent : Registry->GetHealthComponents())
+	{
+		auto* Actor{ GetDisplayActor(HealthComponent) };
+		if (!Actor || Actor->IsHidden())
+		{
+			continue;
+		}
+
+		if (Settings.bHideLocalPawn && (Actor == LocalPawn))
+		{
+			continue;
+		}
+
+		if (Settings.bHideDeadActors && HealthComponent->IsDeadOrDying())
+		{
+			continue;
+		}
+
+		const auto WorldLocation{ Actor->GetActorLocation() + Settings.WorldOffset };
+		const auto DistanceSquared{ FVector::DistSquared(ViewLocation, WorldLocation) };
+
+		if (DistanceSquared > MaxDistanceSquared)
+		{
+			continue;
+		}
+
+		FVector2D ScreenLocation;
+		if (!PlayerController->ProjectWorldLocationToScreen(WorldLocation, ScreenLocation, true))
+		{
+			continue;
+		}
+
+		if ((ScreenLocation.X < 0.0) || (ScreenLocation.Y < 0.0) || (ScreenLocation.X > ViewportSizeX) || (ScreenLocation.Y > ViewportSizeY))
+		{
+			continue;
+		}
+
+		auto Score{ (Settings.MaxDistance > 0.0f) ? static_cast<float>(FMath::Sqrt(DistanceSquared) / Settings.MaxDistance) : 0.0f };
+
+		const auto LastDamageTime{ HealthComponent->GetLastDamageTime() };
+		if ((LastDamageTime >= 0.0) && (Settings.RecentDamageDuration > 0.0f))
+		{
+			const auto DamageAge{ static_cast<float>(CurrentTime - LastDamageTime) };
+			if (DamageAge < Settings.RecentDamageDuration)
+			{
+				Score -= Settings.RecentDamagePriority * (1.0f - (DamageAge / Settings.RecentDamageDuration));
+			}
+		}
+
+		Candidates.Emplace(Score, HealthComponent);
+	}
+
+	Candidates.Sort([](const TPair<float, UHealthComponent*>& A, const TPair<float, UHealthComponent*>& B) { return A.Key < B.Key; });
+
+	if (Candidates.Num() > Bars.Num())
+	{
+		Candidates.SetNum(Bars.Num());
+	}
+
+	// Keep bars whose actor is still selected and release the others
+
+	TSet<UHealthComponent*> Selected;
+	Selected.Reserve(Candidates.Num());
+
+	for (const auto& Candidate : Candidates)
+	{
+		Selected.Add(Candidate.Value);
+	}
+
+	for (auto Index{ 0 }; Index < Bars.Num(); ++Index)
+	{
+		auto* Target{ BarTargets[Index].Get() };
+
+		if (Target && Selected.Remove(Target) > 0)
+		{
+			continue;
+		}
+
+		AssignBar(Index, nullptr);
+	}
+
+	// Assign free bars to newly selected actors
+
+	auto FreeIndex{ 0 };
+
+	for (const auto& Candidate : Candidates)
+	{
+		if (!Selected.Contains(Candidate.Value))
+		{
+			continue;
+		}
+
+		while ((FreeIndex < Bars.Num()) && BarTargets[FreeIndex].IsValid())
+		{
+			++FreeIndex;
+		}
+
+		if (FreeIndex >= Bars.Num())
+		{
+			break;
+		}
+
+		AssignBar(FreeIndex, Candidate.Value);
+	}
+}
+
+void UOverheadHealthBarSubsystem::UpdatePositions(APlayerController* PlayerController)
+{
+	for (auto Index{ 0 }; Index < Bars.Num(); ++Index)
+	{
+		auto* Bar{ Bars[Index].Get() };
+		auto* Actor{ GetDisplayActor(BarTargets[Index].Get()) };
+
+		if (!Bar || !Actor)
+		{
+			continue;
+		}
+
+		FVector2D WidgetPosition;
+		if (UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(PlayerController, Actor->GetActorLocation() + Settings.WorldOffset, WidgetPosition, true))
+		{
+			Bar->SetPositionInViewport(WidgetPosition, false);
+
+			if (Bar->GetVisibility() != ESlateVisibility::HitTestInvisible)
+			{
+				Bar->SetVisibility(ESlateVisibility::HitTestInvisible);
+			}
+		}
+		else if (Bar->GetVisibility() != ESlateVisibility::Collapsed)
+		{
+			Bar->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+}
+
+void UOverheadHealthBarSubsystem::AssignBar(int32 BarIndex, UHealthComponent* HealthComponent)
+{
+	if (!Bars.IsValidIndex(BarIndex))
+	{
+		return;
+	}
+
+	BarTargets[BarIndex] = HealthComponent;
+
+	if (auto* Bar{ Bars[BarIndex].Get() })
+	{
+		Bar->SetObservedHealthComponent(HealthComponent);
+
+		if (!HealthComponent)
+		{
+			Bar->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+}
+
+void UOverheadHealthBarSubsystem::UnbindHealthComponent(UHealthComponent* HealthComponent)
+{
+	for (auto Index{ 0 }; Index < Bars.Num(); ++Index)
+	{
+		if (BarTargets[Index].Get() == HealthComponent)
+		{
+			AssignBar(Index, nullptr);
+		}
+	}
+}
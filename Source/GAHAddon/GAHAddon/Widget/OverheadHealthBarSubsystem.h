@@ -0,0 +1,137 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "HealthWidgetPoolSubsystem.h"
+
+#include "OverheadHealthBarSubsystem.generated.h"
+
+class UHealthBarWidgetBase;
+class UHealthComponent;
+class APlayerController;
+
+
+/**
+ * Settings of the overhead health bars
+ */
+USTRUCT(BlueprintType)
+struct FOverheadHealthBarSettings
+{
+	GENERATED_BODY()
+public:
+	FOverheadHealthBarSettings() {}
+
+public:
+	//
+	// Widget class used for each bar in the pool
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TSubclassOf<UHealthBarWidgetBase> WidgetClass;
+
+	//
+	// Number of bars created. No more actors than this will display a bar at the same time.
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 1))
+	int32 PoolSize{ 16 };
+
+	//
+	// Actors farther from the view than this do not display a bar
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float MaxDistance{ 5000.0f };
+
+	//
+	// Offset from the actor location where the bar is displayed
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector WorldOffset{ 0.0, 0.0, 120.0 };
+
+	//
+	// Seconds an actor is prioritized after being damaged
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float RecentDamageDuration{ 3.0f };
+
+	//
+	// Priority bonus of a just damaged actor, relative to a distance of MaxDistance
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float RecentDamagePriority{ 1.0f };
+
+	//
+	// Seconds between reassignments of bars to actors
+	//
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Meta = (ClampMin = 0.0))
+	float AssignmentInterval{ 0.1f };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bHideLocalPawn{ true };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bHideDeadActors{ false };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 ZOrder{ -10 };
+
+};
+
+
+/**
+ * Subsystem that displays overhead health bars of nearby actors from a fixed pool of widgets.
+ * 
+ * Tips:
+ *	Bars are assigned only to actors in range and in view, prioritized by recent damage and distance,
+ *	and are recycled as actors leave, so the number of widgets does not grow with the number of actors.
+ */
+UCLASS()
+class GAHADDON_API UOverheadHealthBarSubsystem : public UHealthWidgetPoolSubsystem
+{
+	GENERATED_BODY()
+public:
+	UOverheadHealthBarSubsystem() {}
+
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UOverheadHealthBarSubsystem, STATGROUP_Tickables); }
+
+protected:
+	UPROPERTY(Transient)
+	FOverheadHealthBarSettings Settings;
+
+	//
+	// Pooled bar widgets
+	//
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UHealthBarWidgetBase>> Bars;
+
+	//
+	// Health component assigned to each bar
+	//
+	TArray<TWeakObjectPtr<UHealthComponent>> BarTargets;
+
+	float AssignmentTimeRemaining{ 0.0f };
+
+public:
+	/**
+	 * Create the pool of bars and start displaying them over nearby actors
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void StartOverheadHealthBars(const FOverheadHealthBarSettings& InSettings);
+
+	/**
+	 * Remove all bars
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Health")
+	void StopOverheadHealthBars();
+
+protected:
+	virtual void TickPool(float DeltaTime, APlayerController* PlayerController) override;
+	virtual void ReleaseAllTargets() override;
+	virtual void DestroyPool() override;
+
+	virtual void UnbindHealthComponent(UHealthComponent* HealthComponent) override;
+
+	void UpdateAssignments(APlayerController* PlayerController);
+	void UpdatePositions(APlayerController* PlayerController);
+
+	void AssignBar(int32 BarIndex, UHealthComponent* HealthComponent);
+
+};
@@ -0,0 +1,115 @@
+// Copyright (C) 2024 owoDra
+
+#include "SHealthLayerBar.h"
+
+#include "Rendering/DrawElements.h"
+
+
+void SHealthLayerBar::Construct(const FArguments& InArgs)
+{
+	Style = InArgs._Style;
+	DesiredSize = InArgs._DesiredSize;
+}
+
+int32 SHealthLayerBar::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	if (!Style)
+	{
+		return LayerId;
+	}
+
+	const auto DrawEffects{ ShouldBeEnabled(bParentEnabled) ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect };
+	const auto Tint{ InWidgetStyle.GetColorAndOpacityTint() };
+	const auto LocalSize{ FVector2D(AllottedGeometry.GetLocalSize()) };
+
+	const auto MakeBox
+	{
+		[&](const FSlateBrush* Brush, int32 BoxLayerId, float StartX, float Width, const FLinearColor& Color)
+		{
+			if (Width > 0.0f)
+			{
+				FSlateDrawElement::MakeBox(
+					OutDrawElements,
+					BoxLayerId,
+					AllottedGeometry.ToPaintGeometry(FVector2D(Width, LocalSize.Y), FSlateLayoutTransform(FVector2D(StartX, 0.0))),
+					Brush,
+					DrawEffects,
+					Tint * Brush->GetTint(InWidgetStyle) * Color);
+			}
+		}
+	};
+
+	MakeBox(&Style->BackgroundBrush, LayerId, 0.0f, LocalSize.X, FLinearColor::White);
+
+	const auto TotalMaxHealth{ Snapshot.MaxHealth + Snapshot.ExtraHealth + Snapshot.MaxShield };
+	if (TotalMaxHealth <= 0.0f)
+	{
+		return LayerId;
+	}
+
+	// Every layer shares the fill brush and the layer so that they are batched together
+
+	const auto FillLayerId{ LayerId + 1 };
+	const auto* FillBrush{ &Style->FillBrush };
+	const auto UnitWidth{ LocalSize.X / TotalMaxHealth };
+
+	const auto HealthWidth{ FMath::Max(Snapshot.Health, 0.0f) * UnitWidth };
+	const auto ExtraHealthWidth{ FMath::Max(Snapshot.ExtraHealth, 0.0f) * UnitWidth };
+	const auto ShieldWidth{ FMath::Max(Snapshot.Shield, 0.0f) * UnitWidth };
+	const auto TotalWidth{ HealthWidth + ExtraHealthWidth + ShieldWidth };
+
+	MakeBox(FillBrush, FillLayerId, 0.0f, HealthWidth, Style->HealthColor);
+	MakeBox(FillBrush, FillLayerId, HealthWidth, ExtraHealthWidth, Style->ExtraHealthColor);
+	MakeBox(FillBrush, FillLayerId, HealthWidth + ExtraHealthWidth, ShieldWidth, Style->ShieldColor);
+
+	const auto TrailEnd{ FMath::Clamp(TrailRatio, 0.0f, 1.0f) * LocalSize.X };
+	MakeBox(FillBrush, FillLayerId, TotalWidth, TrailEnd - TotalWidth, Style->TrailColor);
+
+	if (Snapshot.MinHealth > 0.0f)
+	{
+		const auto MarkerX{ Snapshot.MinHealth * UnitWidth - (Style->MinHealthMarkerWidth * 0.5f) };
+		MakeBox(FillBrush, FillLayerId, MarkerX, Style->MinHealthMarkerWidth, Style->MinHealthMarkerColor);
+	}
+
+	return FillLayerId;
+}
+
+FVector2D SHealthLayerBar::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return DesiredSize;
+}
+
+
+void SHealthLayerBar::SetStyle(const FHealthLayerBarStyle* InStyle)
+{
+	Style = InStyle;
+
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SHealthLayerBar::SetDesiredSize(const FVector2D& InDesiredSize)
+{
+	if (DesiredSize != InDesiredSize)
+	{
+		DesiredSize = InDesiredSize;
+
+		Invalidate(EInvalidateWidgetReason::Layout);
+	}
+}
+
+void SHealthLayerBar::SetSnapshot(const FHealthSnapshot& InSnapshot)
+{
+	Snapshot = InSnapshot;
+
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SHealthLayerBar::SetTrailRatio(float InTrailRatio)
+{
+	if (TrailRatio != InTrailRatio)
+	{
+		TrailRatio = InTrailRatio;
+
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
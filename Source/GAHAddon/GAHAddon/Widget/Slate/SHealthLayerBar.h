@@ -0,0 +1,51 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Widgets/SLeafWidget.h"
+
+#include "Widget/HealthLayerBarStyle.h"
+#include "HealthSnapshot.h"
+
+
+/**
+ * Slate widget that paints the health, extra health, shield, damage trail and min health marker of a health bar in one pass
+ * 
+ * Tips:
+ *	Layers are laid out along the total max health (MaxHealth + ExtraHealth + MaxShield).
+ *	Changing the values only invalidates the paint, never the layout.
+ */
+class GAHADDON_API SHealthLayerBar : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SHealthLayerBar)
+		: _Style(nullptr)
+		, _DesiredSize(FVector2D(200.0, 12.0))
+	{}
+		SLATE_ARGUMENT(const FHealthLayerBarStyle*, Style)
+		SLATE_ARGUMENT(FVector2D, DesiredSize)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+protected:
+	const FHealthLayerBarStyle* Style{ nullptr };
+	FVector2D DesiredSize{ FVector2D::ZeroVector };
+
+	FHealthSnapshot Snapshot;
+
+	//
+	// Ratio of the total health at which the damage trail ends
+	//
+	float TrailRatio{ 0.0f };
+
+public:
+	void SetStyle(const FHealthLayerBarStyle* InStyle);
+	void SetDesiredSize(const FVector2D& InDesiredSize);
+	void SetSnapshot(const FHealthSnapshot& InSnapshot);
+	void SetTrailRatio(float InTrailRatio);
+
+};
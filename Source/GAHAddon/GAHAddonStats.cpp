@@ -0,0 +1,10 @@
+﻿// Copyright (C) 2024 owoDra
+
+#include "GAHAddonStats.h"
+
+DEFINE_STAT(STAT_GAHA_DamageEvents);
+DEFINE_STAT(STAT_GAHA_HealEvents);
+DEFINE_STAT(STAT_GAHA_Broadcasts);
+DEFINE_STAT(STAT_GAHA_Deaths);
+
+UE_TRACE_CHANNEL_DEFINE(GAHAChannel);
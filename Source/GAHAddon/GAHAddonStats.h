@@ -0,0 +1,23 @@
+﻿// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_STATS_GROUP(TEXT("GAHAddon"), STATGROUP_GAHA, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Damage Events"), STAT_GAHA_DamageEvents, STATGROUP_GAHA, GAHADDON_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Heal Events"), STAT_GAHA_HealEvents, STATGROUP_GAHA, GAHADDON_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Broadcasts"), STAT_GAHA_Broadcasts, STATGROUP_GAHA, GAHADDON_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deaths"), STAT_GAHA_Deaths, STATGROUP_GAHA, GAHADDON_API);
+
+UE_TRACE_CHANNEL_EXTERN(GAHAChannel, GAHADDON_API);
+
+/**
+ * Scope of a GAHA cycle stat that is also traced as a CPU event on the GAHA channel ("-trace=cpu,GAHA")
+ */
+#define GAHA_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(#Stat, GAHAChannel)
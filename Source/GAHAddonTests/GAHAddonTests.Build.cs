@@ -0,0 +1,42 @@
+﻿// Copyright (C) 2024 owoDra
+
+using UnrealBuildTool;
+
+public class GAHAddonTests : ModuleRules
+{
+	public GAHAddonTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        PublicIncludePaths.AddRange(
+            new string[]
+            {
+                ModuleDirectory,
+                ModuleDirectory + "/GAHAddonTests",
+            }
+        );
+
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+                "CoreUObject",
+                "Engine",
+                "GameplayTags",
+                "GameplayAbilities",
+                "GFCore",
+                "GAHAddon",
+            }
+        );
+
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "GAExt",
+                "NetCore",
+            }
+        );
+    }
+}
@@ -0,0 +1,5 @@
+// Copyright (C) 2024 owoDra
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, GAHAddonTests)
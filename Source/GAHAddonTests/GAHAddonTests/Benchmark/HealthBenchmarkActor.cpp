@@ -0,0 +1,26 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthBenchmarkActor.h"
+
+#include "HealthComponent.h"
+
+#include "GAEAbilitySystemComponent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthBenchmarkActor)
+
+
+AHealthBenchmarkActor::AHealthBenchmarkActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	AbilitySystemComponent = CreateDefaultSubobject<UGAEAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
+	HealthComponent = CreateDefaultSubobject<UHealthComponent>(TEXT("HealthComponent"));
+}
+
+void AHealthBenchmarkActor::BeginPlay()
+{
+	AbilitySystemComponent->InitAbilityActorInfo(this, this);
+
+	Super::BeginPlay();
+}
@@ -0,0 +1,37 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "AbilitySystemInterface.h"
+
+#include "HealthBenchmarkActor.generated.h"
+
+class UHealthComponent;
+
+
+/**
+ * Minimal actor with an ability system and a health component spawned by the health benchmark and the automation tests
+ */
+UCLASS(NotPlaceable, Transient, NotBlueprintable)
+class GAHADDONTESTS_API AHealthBenchmarkActor : public AActor, public IAbilitySystemInterface
+{
+	GENERATED_BODY()
+public:
+	AHealthBenchmarkActor(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+protected:
+	virtual void BeginPlay() override;
+
+protected:
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	TObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
+
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	TObjectPtr<UHealthComponent> HealthComponent;
+
+public:
+	virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override { return AbilitySystemComponent; }
+	UHealthComponent* GetHealthComponent() const { return HealthComponent; }
+
+};
@@ -0,0 +1,52 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthBenchmarkEffects.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+#include "UObject/Package.h"
+
+
+namespace GAHABenchmark
+{
+	static const FName AttributeMagnitudeName{ TEXT("GAHA.Bench.Magnitude") };
+
+	UGameplayEffect* CreateExecutionEffect(TSubclassOf<UGameplayEffectExecutionCalculation> ExecutionClass)
+	{
+		auto* NewEffect{ NewObject<UGameplayEffect>(GetTransientPackage(), NAME_None, RF_Transient) };
+		NewEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+
+		FGameplayEffectExecutionDefinition ExecutionDefinition;
+		ExecutionDefinition.CalculationClass = ExecutionClass;
+		NewEffect->Executions.Add(ExecutionDefinition);
+
+		return NewEffect;
+	}
+
+	UGameplayEffect* CreateAttributeEffect(const FGameplayAttribute& Attribute)
+	{
+		auto* NewEffect{ NewObject<UGameplayEffect>(GetTransientPackage(), NAME_None, RF_Transient) };
+		NewEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+
+		FSetByCallerFloat SetByCallerMagnitude;
+		SetByCallerMagnitude.DataName = AttributeMagnitudeName;
+
+		FGameplayModifierInfo ModifierInfo;
+		ModifierInfo.Attribute = Attribute;
+		ModifierInfo.ModifierOp = EGameplayModOp::Additive;
+		ModifierInfo.ModifierMagnitude = FGameplayEffectModifierMagnitude(SetByCallerMagnitude);
+		NewEffect->Modifiers.Add(ModifierInfo);
+
+		return NewEffect;
+	}
+
+	void ApplyAttributeEffect(UAbilitySystemComponent* AbilitySystemComponent, UGameplayEffect* Effect, float Magnitude)
+	{
+		const auto SpecHandle{ AbilitySystemComponent->MakeOutgoingSpec(Effect, 1.0f, AbilitySystemComponent->MakeEffectContext()) };
+		if (SpecHandle.IsValid())
+		{
+			SpecHandle.Data->SetSetByCallerMagnitude(AttributeMagnitudeName, Magnitude);
+			AbilitySystemComponent->ApplyGameplayEffectSpecToTarget(*SpecHandle.Data.Get(), AbilitySystemComponent);
+		}
+	}
+}
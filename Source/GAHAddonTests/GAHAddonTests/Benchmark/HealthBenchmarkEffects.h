@@ -0,0 +1,32 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Templates/SubclassOf.h"
+
+class UAbilitySystemComponent;
+class UGameplayEffect;
+class UGameplayEffectExecutionCalculation;
+struct FGameplayAttribute;
+
+
+/**
+ * Transient gameplay effects used by the health benchmarks and the automation tests
+ */
+namespace GAHABenchmark
+{
+	/**
+	 * Returns a new instant effect that runs the execution
+	 */
+	GAHADDONTESTS_API UGameplayEffect* CreateExecutionEffect(TSubclassOf<UGameplayEffectExecutionCalculation> ExecutionClass);
+
+	/**
+	 * Returns a new instant effect that adds a set by caller magnitude to the attribute, see ApplyAttributeEffect
+	 */
+	GAHADDONTESTS_API UGameplayEffect* CreateAttributeEffect(const FGameplayAttribute& Attribute);
+
+	/**
+	 * Apply an effect created by CreateAttributeEffect to the ability system with the magnitude
+	 */
+	GAHADDONTESTS_API void ApplyAttributeEffect(UAbilitySystemComponent* AbilitySystemComponent, UGameplayEffect* Effect, float Magnitude);
+}
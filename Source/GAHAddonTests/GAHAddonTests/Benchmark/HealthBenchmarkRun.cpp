@@ -0,0 +1,291 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthBenchmarkRun.h"
+
+#if GAHA_WITH_BENCHMARK
+
+#include "HealthBenchmarkActor.h"
+#include "HealthBenchmarkEffects.h"
+#include "Attribute/CombatAttributeSet.h"
+#include "Ability/GameplayAbility_Death.h"
+#include "Execution/DamageExecution.h"
+#include "Execution/HealExecution.h"
+#include "HealthComponent.h"
+#include "HealthData.h"
+#include "GAHAddonLogs.h"
+
+#include "InitState/InitStateTags.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+
+namespace GAHABenchmark
+{
+	static TAutoConsoleVariable<FString> CVarDeathAbilityClass(
+		TEXT("GAHA.Bench.DeathAbilityClass"),
+		TEXT(""),
+		TEXT("Path of the death ability class granted to the benchmark actors. No death ability is granted if empty."));
+
+	FRun::FRun(UWorld* InWorld, const FRunConfig& InConfig)
+		: World(InWorld)
+		, Config(InConfig)
+	{
+	}
+
+	FRun::~FRun()
+	{
+		bCapturing = false;
+
+		for (const auto& Actor : Actors)
+		{
+			if (IsValid(Actor))
+			{
+				Actor->Destroy();
+			}
+		}
+	}
+
+	void FRun::AddReferencedObjects(FReferenceCollector& Collector)
+	{
+		Collector.AddReferencedObjects(Actors);
+		Collector.AddReferencedObject(HealthData);
+		Collector.AddReferencedObject(DamageEffect);
+		Collector.AddReferencedObject(HealEffect);
+	}
+
+	FString FRun::GetReferencerName() const
+	{
+		return TEXT("GAHABenchmark::FRun");
+	}
+
+	bool FRun::Start()
+	{
+		auto* CurrentWorld{ World.Get() };
+		if (!CurrentWorld || (CurrentWorld->GetNetMode() == NM_Client))
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Run: Requires a world with authority."));
+			return false;
+		}
+
+		HealthData = NewObject<UHealthData>(GetTransientPackage(), NAME_None, RF_Transient);
+		if (Config.DeathAbilityClass)
+		{
+			HealthData->DeathEventAbilityClass = Config.DeathAbilityClass.Get();
+		}
+		else
+		{
+			HealthData->DeathEventAbilityClass = TSoftClassPtr<UGameplayAbility_Death>(FSoftObjectPath(CVarDeathAbilityClass.GetValueOnGameThread()));
+			HealthData->DeathEventAbilityClass.LoadSynchronous();
+		}
+
+		DamageEffect = CreateExecutionEffect(UDamageExecution::StaticClass());
+		HealEffect = CreateExecutionEffect(UHealExecution::StaticClass());
+
+		for (auto Index{ 0 }; Index < Config.NumActors; ++Index)
+		{
+			const auto SpawnTransform{ FTransform(FVector(200.0 * (Index % 100), 200.0 * (Index / 100), 0.0)) };
+
+			auto* NewActor{ CurrentWorld->SpawnActor<AHealthBenchmarkActor>(AHealthBenchmarkActor::StaticClass(), SpawnTransform) };
+			if (!NewActor)
+			{
+				continue;
+			}
+
+			NewActor->GetHealthComponent()->OnDeathStartedNative.AddLambda([this](AActor*) { ++Deaths; });
+			NewActor->GetHealthComponent()->SetHealthData(HealthData);
+
+			Actors.Add(NewActor);
+		}
+
+		InitStartTime = FPlatformTime::Seconds();
+
+		UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Run: Spawned %d actors, waiting for initialization."), Actors.Num());
+
+		return true;
+	}
+
+	bool FRun::Tick(float DeltaTime)
+	{
+		if (!World.IsValid())
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Run: World was destroyed during the benchmark."));
+			return false;
+		}
+
+		// Wait until all health components are initialized
+
+		if (FramesRun == 0 && !bCapturing)
+		{
+			if (!IsInitialized())
+			{
+				if (FPlatformTime::Seconds() - InitStartTime > 10.0)
+				{
+					UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Run: Timed out waiting for the health components to initialize."));
+					return false;
+				}
+
+				return true;
+			}
+
+			ResetPhases();
+			bCapturing = true;
+		}
+
+		if (FramesRun < Config.NumFrames)
+		{
+			RunFrame();
+			return true;
+		}
+
+		// Let the notifications deferred to the next frame run before finishing
+
+		Finish();
+		return false;
+	}
+
+	bool FRun::IsInitialized() const
+	{
+		for (const auto& Actor : Actors)
+		{
+			if (!Actor->GetHealthComponent()->HasReachedInitState(TAG_InitState_DataInitialized))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void FRun::RunFrame()
+	{
+		const auto NumActors{ Actors.Num() };
+		const auto StartCycles{ FPlatformTime::Cycles64() };
+
+		for (auto Index{ 0 }; Index < NumActors; ++Index)
+		{
+			auto* TargetASC{ Actors[Index]->GetAbilitySystemComponent() };
+			auto* SourceASC{ Actors[(Index + 1) % NumActors]->GetAbilitySystemComponent() };
+
+			SourceASC->SetNumericAttributeBase(UCombatAttributeSet::GetBaseDamageAttribute(), Config.Damage);
+			SourceASC->SetNumericAttributeBase(UCombatAttributeSet::GetBaseHealAttribute(), Config.Heal);
+
+			for (auto Count{ 0 }; Count < Config.DamagePerFrame; ++Count)
+			{
+				SourceASC->ApplyGameplayEffectToTarget(DamageEffect, TargetASC, 1.0f, SourceASC->MakeEffectContext());
+			}
+
+			for (auto Count{ 0 }; Count < Config.HealPerFrame; ++Count)
+			{
+				SourceASC->ApplyGameplayEffectToTarget(HealEffect, TargetASC, 1.0f, SourceASC->MakeEffectContext());
+			}
+		}
+
+		ApplyCycles += FPlatformTime::Cycles64() - StartCycles;
+		Applications += static_cast<int64>(NumActors) * (Config.DamagePerFrame + Config.HealPerFrame);
+		++FramesRun;
+	}
+
+	void FRun::Finish()
+	{
+		bCapturing = false;
+		bFinished = true;
+
+		const auto ApplyMilliseconds{ FPlatformTime::ToMilliseconds64(ApplyCycles) };
+		const auto ApplicationsPerSecond{ (ApplyMilliseconds > 0.0) ? (Applications * 1000.0 / ApplyMilliseconds) : 0.0 };
+
+		UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Run: %lld applications in %.3f ms (%.0f/s), %d deaths"), Applications, ApplyMilliseconds, ApplicationsPerSecond, Deaths);
+
+		auto Header{ FString(TEXT("Date,NumActors,NumFrames,DamagePerFrame,HealPerFrame,Applications,ApplyMs,ApplicationsPerSecond,Deaths")) };
+		auto Row{ FString::Printf(TEXT("%s,%d,%d,%d,%d,%lld,%.3f,%.1f,%d"),
+			*FDateTime::Now().ToString(), Actors.Num(), FramesRun, Config.DamagePerFrame, Config.HealPerFrame, Applications, ApplyMilliseconds, ApplicationsPerSecond, Deaths) };
+
+		for (auto PhaseIndex{ 0 }; PhaseIndex < static_cast<int32>(EHealthBenchmarkPhase::MAX); ++PhaseIndex)
+		{
+			const auto Phase{ static_cast<EHealthBenchmarkPhase>(PhaseIndex) };
+			const auto PhaseMilliseconds{ GetPhaseMilliseconds(Phase) };
+
+			UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Run:   %-12s %10.3f ms"), GetPhaseName(Phase), PhaseMilliseconds);
+
+			Header += FString::Printf(TEXT(",%sMs"), GetPhaseName(Phase));
+			Row += FString::Printf(TEXT(",%.3f"), PhaseMilliseconds);
+		}
+
+		if (!Config.bWriteResults)
+		{
+			return;
+		}
+
+		const auto FilePath{ FPaths::ProfilingDir() / TEXT("GAHA") / TEXT("HealthBenchmark.csv") };
+		const auto bNewFile{ !FPaths::FileExists(FilePath) };
+
+		const auto Contents{ bNewFile ? (Header + LINE_TERMINATOR + Row + LINE_TERMINATOR) : (Row + LINE_TERMINATOR) };
+		if (FFileHelper::SaveStringToFile(Contents, *FilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+		{
+			UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Run: Results written to %s"), *FilePath);
+		}
+		else
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Run: Failed to write results to %s"), *FilePath);
+		}
+	}
+
+	static TUniquePtr<FRun> ActiveRun;
+
+	static bool TickActiveRun(float DeltaTime)
+	{
+		if (ActiveRun.IsValid() && ActiveRun->Tick(DeltaTime))
+		{
+			return true;
+		}
+
+		// Destroyed here rather than inside FRun::Tick, which would free the run while it is still executing
+
+		ActiveRun.Reset();
+		return false;
+	}
+
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchRunCommand(
+		TEXT("GAHA.Bench.Run"),
+		TEXT("Benchmark the damage and heal pipeline. Usage: GAHA.Bench.Run [NumActors=100] [NumFrames=300] [DamagePerFrame=1] [HealPerFrame=1] [Damage=10] [Heal=5]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+			[](const TArray<FString>& Args, UWorld* World)
+			{
+				if (ActiveRun.IsValid())
+				{
+					UE_LOG(LogGAHA, Warning, TEXT("GAHA.Bench.Run: A benchmark is already running."));
+					return;
+				}
+
+				FRunConfig Config;
+				if (Args.IsValidIndex(0)) { LexFromString(Config.NumActors, *Args[0]); }
+				if (Args.IsValidIndex(1)) { LexFromString(Config.NumFrames, *Args[1]); }
+				if (Args.IsValidIndex(2)) { LexFromString(Config.DamagePerFrame, *Args[2]); }
+				if (Args.IsValidIndex(3)) { LexFromString(Config.HealPerFrame, *Args[3]); }
+				if (Args.IsValidIndex(4)) { LexFromString(Config.Damage, *Args[4]); }
+				if (Args.IsValidIndex(5)) { LexFromString(Config.Heal, *Args[5]); }
+
+				Config.NumActors = FMath::Max(Config.NumActors, 2);
+				Config.NumFrames = FMath::Max(Config.NumFrames, 1);
+
+				ActiveRun = MakeUnique<FRun>(World, Config);
+
+				if (!ActiveRun->Start())
+				{
+					ActiveRun.Reset();
+					return;
+				}
+
+				FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickActiveRun));
+			}));
+}
+
+#endif // #if GAHA_WITH_BENCHMARK
@@ -0,0 +1,95 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Benchmark/HealthBenchmark.h"
+
+#if GAHA_WITH_BENCHMARK
+
+#include "UObject/GCObject.h"
+#include "Templates/SubclassOf.h"
+
+class AHealthBenchmarkActor;
+class UGameplayAbility_Death;
+class UGameplayEffect;
+class UHealthData;
+class UWorld;
+
+
+/**
+ * Benchmark of the damage and heal pipeline
+ * 
+ * Tips:
+ *	Spawns actors with an ability system and a health component, applies streams of damage and heal effects
+ *	executed by UDamageExecution and UHealExecution every frame and appends the throughput and per phase timings
+ *	to <ProfilingDir>/GAHA/HealthBenchmark.csv.
+ *	Can be run headless, e.g. -game -nullrhi -ExecCmds="GAHA.Bench.Run 500 300 2 1", or driven by an automation test.
+ */
+namespace GAHABenchmark
+{
+	struct FRunConfig
+	{
+		int32 NumActors{ 100 };
+		int32 NumFrames{ 300 };
+		int32 DamagePerFrame{ 1 };
+		int32 HealPerFrame{ 1 };
+		float Damage{ 10.0f };
+		float Heal{ 5.0f };
+		bool bWriteResults{ true };
+
+		//
+		// Death ability granted to the actors, "GAHA.Bench.DeathAbilityClass" is used if not set
+		//
+		TSubclassOf<UGameplayAbility_Death> DeathAbilityClass;
+	};
+
+	class GAHADDONTESTS_API FRun : public FGCObject
+	{
+	public:
+		FRun(UWorld* InWorld, const FRunConfig& InConfig);
+		virtual ~FRun();
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+		virtual FString GetReferencerName() const override;
+
+		/**
+		 * Spawn the actors, returns false if the run cannot start in the world
+		 */
+		bool Start();
+
+		/**
+		 * Advance the run by one frame, returns false once it has finished or failed.
+		 * The run must not be destroyed from inside its own tick.
+		 */
+		bool Tick(float DeltaTime);
+
+		bool HasFinished() const { return bFinished; }
+		int64 GetApplications() const { return Applications; }
+		int32 GetFramesRun() const { return FramesRun; }
+		int32 GetDeaths() const { return Deaths; }
+		const TArray<TObjectPtr<AHealthBenchmarkActor>>& GetActors() const { return Actors; }
+
+	private:
+		bool IsInitialized() const;
+		void RunFrame();
+		void Finish();
+
+	private:
+		TWeakObjectPtr<UWorld> World;
+		FRunConfig Config;
+
+		TArray<TObjectPtr<AHealthBenchmarkActor>> Actors;
+		TObjectPtr<UHealthData> HealthData{ nullptr };
+		TObjectPtr<UGameplayEffect> DamageEffect{ nullptr };
+		TObjectPtr<UGameplayEffect> HealEffect{ nullptr };
+
+		double InitStartTime{ 0.0 };
+		int32 FramesRun{ 0 };
+		int64 Applications{ 0 };
+		uint64 ApplyCycles{ 0 };
+		int32 Deaths{ 0 };
+		bool bFinished{ false };
+	};
+}
+
+#endif // #if GAHA_WITH_BENCHMARK
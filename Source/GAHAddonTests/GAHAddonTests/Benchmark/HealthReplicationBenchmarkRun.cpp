@@ -0,0 +1,493 @@
+// Copyright (C) 2024 owoDra
+
+#include "Benchmark/HealthBenchmark.h"
+
+#if GAHA_WITH_BENCHMARK
+
+#include "HealthBenchmarkEffects.h"
+#include "Attribute/HealthAttributeSet.h"
+#include "Subsystem/HealthComponentRegistrySubsystem.h"
+#include "HealthComponent.h"
+#include "GAHAddonLogs.h"
+
+#include "InitState/InitStateTags.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+#include "Containers/Ticker.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "UObject/GCObject.h"
+
+
+/**
+ * Replication bandwidth benchmark of the health state
+ *
+ * Tips:
+ *	Run on the server of a session with connected clients, e.g. PIE as listen server with several clients
+ *	in one process, or a dedicated server with clients connected over the loopback.
+ *	Measures the outgoing bytes of every client connection during an idle baseline and during a scripted
+ *	scenario driven against every registered health component, and counts the health rep notifies received
+ *	by the clients running in the same process.
+ *	The scenario applies instant effects that modify the meta attributes, so every change runs through
+ *	UHealthAttributeSet::PostGameplayEffectExecute and the death flow exactly like gameplay damage and heals.
+ *	Results are appended to <ProfilingDir>/GAHA/HealthReplicationBenchmark.csv.
+ */
+namespace GAHABenchmark
+{
+	enum class EReplicationScenario : uint8
+	{
+		Damage,		// Non lethal damage every frame
+		Heal,		// Heavy damage every second and healing every frame
+		Regen,		// Small heals at a fixed rate
+		Death,		// Lethal damage once, then the death transitions
+		MAX
+	};
+
+	static const TCHAR* GetScenarioName(EReplicationScenario Scenario)
+	{
+		switch (Scenario)
+		{
+		case EReplicationScenario::Damage:	return TEXT("Damage");
+		case EReplicationScenario::Heal:	return TEXT("Heal");
+		case EReplicationScenario::Regen:	return TEXT("Regen");
+		case EReplicationScenario::Death:	return TEXT("Death");
+		default:							return TEXT("Unknown");
+		}
+	}
+
+	struct FReplicationRunConfig
+	{
+		EReplicationScenario Scenario{ EReplicationScenario::Damage };
+		float Seconds{ 10.0f };
+		float Damage{ 10.0f };
+		float Heal{ 5.0f };
+		float RegenRate{ 10.0f };
+	};
+
+	class FReplicationRun : public FGCObject
+	{
+	public:
+		FReplicationRun(UWorld* InWorld, const FReplicationRunConfig& InConfig)
+			: World(InWorld)
+			, Config(InConfig)
+		{
+		}
+
+		virtual ~FReplicationRun()
+		{
+			bCapturing = false;
+
+			for (auto Index{ 0 }; Index < HealthComponents.Num(); ++Index)
+			{
+				if (auto* HealthComponent{ HealthComponents[Index].Get() })
+				{
+					HealthComponent->OnDeathStartedNative.Remove(DeathHandles[Index]);
+				}
+			}
+		}
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+		{
+			Collector.AddReferencedObject(DamageEffect);
+			Collector.AddReferencedObject(HealEffect);
+		}
+
+		virtual FString GetReferencerName() const override
+		{
+			return TEXT("GAHABenchmark::FReplicationRun");
+		}
+
+		bool Start();
+		bool Tick(float DeltaTime);
+
+	private:
+		enum class EStage : uint8
+		{
+			Baseline,
+			Scenario,
+			Drain
+		};
+
+		struct FConnectionBytes
+		{
+			TWeakObjectPtr<UNetConnection> Connection;
+			FString Name;
+			int64 StartBytes{ 0 };
+			int64 BaselineBytes{ 0 };
+			int64 ScenarioBytes{ 0 };
+		};
+
+		void SampleConnections(bool bEndOfStage);
+		void RunScenarioFrame(float DeltaTime);
+		void Finish();
+
+		void ApplyEffect(UHealthComponent* HealthComponent, UGameplayEffect* Effect, float Magnitude) const;
+
+	private:
+		TWeakObjectPtr<UWorld> World;
+		FReplicationRunConfig Config;
+
+		TArray<FConnectionBytes> Connections;
+		TArray<TWeakObjectPtr<UHealthComponent>> HealthComponents;
+		TArray<FDelegateHandle> DeathHandles;
+
+		TObjectPtr<UGameplayEffect> DamageEffect{ nullptr };
+		TObjectPtr<UGameplayEffect> HealEffect{ nullptr };
+
+		EStage Stage{ EStage::Baseline };
+		double StageTime{ 0.0 };
+		double BaselineSeconds{ 0.0 };
+		double ScenarioSeconds{ 0.0 };
+		double ScenarioAccumulator{ 0.0 };
+		bool bScenarioStarted{ false };
+		int32 Deaths{ 0 };
+	};
+
+
+
+	bool FReplicationRun::Start()
+	{
+		auto* CurrentWorld{ World.Get() };
+		auto* NetDriver{ CurrentWorld ? CurrentWorld->GetNetDriver() : nullptr };
+
+		if (!NetDriver || (CurrentWorld->GetNetMode() == NM_Client) || (CurrentWorld->GetNetMode() == NM_Standalone))
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Replication: Requires a listen or dedicated server world."));
+			return false;
+		}
+
+		if (NetDriver->ClientConnections.IsEmpty())
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Replication: No client is connected."));
+			return false;
+		}
+
+		auto* Registry{ CurrentWorld->GetSubsystem<UHealthComponentRegistrySubsystem>() };
+		if (!Registry)
+		{
+			return false;
+		}
+
+		for (const auto& HealthComponent : Registry->GetHealthComponents())
+		{
+			if (HealthComponent && HealthComponent->HasReachedInitState(TAG_InitState_DataInitialized))
+			{
+				HealthComponents.Add(HealthComponent);
+			}
+		}
+
+		if (HealthComponents.IsEmpty())
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Replication: No initialized health component to drive."));
+			return false;
+		}
+
+		for (const auto& WeakHealthComponent : HealthComponents)
+		{
+			DeathHandles.Add(WeakHealthComponent->OnDeathStartedNative.AddLambda([this](AActor*) { if (Stage != EStage::Baseline) { ++Deaths; } }));
+		}
+
+		DamageEffect = CreateAttributeEffect(UHealthAttributeSet::GetDamageAttribute());
+		HealEffect = CreateAttributeEffect(UHealthAttributeSet::GetHealingAttribute());
+
+		for (const auto& Connection : NetDriver->ClientConnections)
+		{
+			auto& Entry{ Connections.AddDefaulted_GetRef() };
+			Entry.Connection = Connection;
+			Entry.Name = Connection->PlayerController ? Connection->PlayerController->GetName() : Connection->LowLevelGetRemoteAddress(true);
+		}
+
+		SampleConnections(false);
+
+		UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Replication: Measuring the %.1fs baseline of %d connections."), Config.Seconds, Connections.Num());
+
+		return true;
+	}
+
+	bool FReplicationRun::Tick(float DeltaTime)
+	{
+		if (!World.IsValid())
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Replication: World was destroyed during the benchmark."));
+			return false;
+		}
+
+		StageTime += DeltaTime;
+
+		switch (Stage)
+		{
+		case EStage::Baseline:
+			if (StageTime >= Config.Seconds)
+			{
+				SampleConnections(true);
+				BaselineSeconds = StageTime;
+
+				ResetPhases();
+				ResetRepNotifies();
+				bCapturing = true;
+
+				Stage = EStage::Scenario;
+				StageTime = 0.0;
+
+				UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Replication: Running the %s scenario on %d health components."), GetScenarioName(Config.Scenario), HealthComponents.Num());
+			}
+			break;
+
+		case EStage::Scenario:
+			RunScenarioFrame(DeltaTime);
+
+			if (StageTime >= Config.Seconds)
+			{
+				Stage = EStage::Drain;
+				StageTime = 0.0;
+			}
+			break;
+
+		case EStage::Drain:
+			// Give the last updates a moment to reach the clients
+
+			if (StageTime >= 0.5)
+			{
+				SampleConnections(true);
+				ScenarioSeconds = Config.Seconds + StageTime;
+
+				Finish();
+				return false;
+			}
+			break;
+		}
+
+		return true;
+	}
+
+	void FReplicationRun::SampleConnections(bool bEndOfStage)
+	{
+		for (auto& Entry : Connections)
+		{
+			const auto* Connection{ Entry.Connection.Get() };
+			const auto TotalBytes{ Connection ? static_cast<int64>(Connection->OutTotalBytes) : Entry.StartBytes };
+
+			if (bEndOfStage)
+			{
+				auto& StageBytes{ (Stage == EStage::Baseline) ? Entry.BaselineBytes : Entry.ScenarioBytes };
+				StageBytes = TotalBytes - Entry.StartBytes;
+			}
+
+			Entry.StartBytes = TotalBytes;
+		}
+	}
+
+	void FReplicationRun::RunScenarioFrame(float DeltaTime)
+	{
+		const auto PreviousTime{ ScenarioAccumulator };
+		ScenarioAccumulator += DeltaTime;
+
+		for (const auto& WeakHealthComponent : HealthComponents)
+		{
+			auto* HealthComponent{ WeakHealthComponent.Get() };
+			if (!HealthComponent || HealthComponent->IsDeadOrDying())
+			{
+				continue;
+			}
+
+			switch (Config.Scenario)
+			{
+			case EReplicationScenario::Damage:
+				// Refill before the damage becomes lethal so that only the damage path is measured
+
+				if (HealthComponent->GetHealth() <= Config.Damage)
+				{
+					ApplyEffect(HealthComponent, HealEffect, HealthComponent->GetMaxHealth());
+				}
+
+				ApplyEffect(HealthComponent, DamageEffect, Config.Damage);
+				break;
+
+			case EReplicationScenario::Heal:
+				if (FMath::FloorToInt(PreviousTime) != FMath::FloorToInt(ScenarioAccumulator) || !bScenarioStarted)
+				{
+					ApplyEffect(HealthComponent, DamageEffect, FMath::Min(Config.Damage * 10.0f, HealthComponent->GetHealth() - 1.0f));
+				}
+
+				ApplyEffect(HealthComponent, HealEffect, Config.Heal);
+				break;
+
+			case EReplicationScenario::Regen:
+				{
+					const auto Ticks{ FMath::FloorToInt(ScenarioAccumulator * Config.RegenRate) - FMath::FloorToInt(PreviousTime * Config.RegenRate) };
+
+					for (auto Count{ 0 }; Count < Ticks; ++Count)
+					{
+						ApplyEffect(HealthComponent, HealEffect, Config.Heal);
+					}
+				}
+				break;
+
+			case EReplicationScenario::Death:
+				if (!bScenarioStarted)
+				{
+					ApplyEffect(HealthComponent, DamageEffect, UE_BIG_NUMBER);
+				}
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		bScenarioStarted = true;
+	}
+
+	void FReplicationRun::ApplyEffect(UHealthComponent* HealthComponent, UGameplayEffect* Effect, float Magnitude) const
+	{
+		if (Magnitude <= 0.0f)
+		{
+			return;
+		}
+
+		if (auto* ASC{ UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(HealthComponent->GetOwner()) })
+		{
+			ApplyAttributeEffect(ASC, Effect, Magnitude);
+		}
+	}
+
+	void FReplicationRun::Finish()
+	{
+		bCapturing = false;
+
+		const auto* NetDriver{ World->GetNetDriver() };
+		const auto ReplicationMode{ FString::Printf(TEXT("%s%s"),
+			(NetDriver && NetDriver->IsUsingIrisReplication()) ? TEXT("Iris") : TEXT("Generic"),
+			UE::Net::IsPushModelEnabled() ? TEXT("+PushModel") : TEXT("")) };
+
+		const auto NumComponents{ FMath::Max(HealthComponents.Num(), 1) };
+
+		int64 TotalScenarioBytes{ 0 };
+		for (const auto& Entry : Connections)
+		{
+			TotalScenarioBytes += Entry.ScenarioBytes;
+		}
+
+		UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Replication: %s scenario, %s, %d health components, %lld bytes sent, %d deaths"),
+			GetScenarioName(Config.Scenario), *ReplicationMode, HealthComponents.Num(), TotalScenarioBytes, Deaths);
+
+		const auto FilePath{ FPaths::ProfilingDir() / TEXT("GAHA") / TEXT("HealthReplicationBenchmark.csv") };
+		const auto bNewFile{ !FPaths::FileExists(FilePath) };
+
+		FString Contents;
+		if (bNewFile)
+		{
+			Contents += TEXT("Date,Scenario,ReplicationMode,NumHealthComponents,Connection,ScenarioBytes,Deaths,BaselineBytesPerSecond,ScenarioBytesPerSecond,HealthBytesPerSecond,HealthBytesPerSecondPerPawn");
+
+			for (auto PropertyIndex{ 0 }; PropertyIndex < static_cast<int32>(EHealthBenchmarkRepProperty::MAX); ++PropertyIndex)
+			{
+				Contents += FString::Printf(TEXT(",%sRepNotifies"), GetRepPropertyName(static_cast<EHealthBenchmarkRepProperty>(PropertyIndex)));
+			}
+
+			Contents += LINE_TERMINATOR;
+		}
+
+		FString RepNotifyColumns;
+
+		for (auto PropertyIndex{ 0 }; PropertyIndex < static_cast<int32>(EHealthBenchmarkRepProperty::MAX); ++PropertyIndex)
+		{
+			const auto Property{ static_cast<EHealthBenchmarkRepProperty>(PropertyIndex) };
+
+			UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Replication:   %-18s %8lld rep notifies"), GetRepPropertyName(Property), GetRepNotifyCount(Property));
+
+			RepNotifyColumns += FString::Printf(TEXT(",%lld"), GetRepNotifyCount(Property));
+		}
+
+		for (const auto& Entry : Connections)
+		{
+			const auto BaselineRate{ (BaselineSeconds > 0.0) ? (Entry.BaselineBytes / BaselineSeconds) : 0.0 };
+			const auto ScenarioRate{ (ScenarioSeconds > 0.0) ? (Entry.ScenarioBytes / ScenarioSeconds) : 0.0 };
+			const auto HealthRate{ FMath::Max(ScenarioRate - BaselineRate, 0.0) };
+
+			UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Replication:   %-24s baseline %10.1f B/s, scenario %10.1f B/s, health %10.1f B/s (%.1f B/s per pawn)"),
+				*Entry.Name, BaselineRate, ScenarioRate, HealthRate, HealthRate / NumComponents);
+
+			Contents += FString::Printf(TEXT("%s,%s,%s,%d,%s,%lld,%d,%.1f,%.1f,%.1f,%.2f%s" LINE_TERMINATOR),
+				*FDateTime::Now().ToString(), GetScenarioName(Config.Scenario), *ReplicationMode, HealthComponents.Num(), *Entry.Name, Entry.ScenarioBytes, Deaths,
+				BaselineRate, ScenarioRate, HealthRate, HealthRate / NumComponents, *RepNotifyColumns);
+		}
+
+		if (FFileHelper::SaveStringToFile(Contents, *FilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+		{
+			UE_LOG(LogGAHA, Log, TEXT("GAHA.Bench.Replication: Results written to %s"), *FilePath);
+		}
+		else
+		{
+			UE_LOG(LogGAHA, Error, TEXT("GAHA.Bench.Replication: Failed to write results to %s"), *FilePath);
+		}
+	}
+
+
+	static TUniquePtr<FReplicationRun> ActiveReplicationRun;
+
+	static bool TickActiveReplicationRun(float DeltaTime)
+	{
+		if (ActiveReplicationRun.IsValid() && ActiveReplicationRun->Tick(DeltaTime))
+		{
+			return true;
+		}
+
+		// Destroyed here rather than inside FReplicationRun::Tick, which would free the run while it is still executing
+
+		ActiveReplicationRun.Reset();
+		return false;
+	}
+
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchReplicationCommand(
+		TEXT("GAHA.Bench.Replication"),
+		TEXT("Measure the replication bandwidth of the health state. Usage: GAHA.Bench.Replication [Damage|Heal|Regen|Death] [Seconds=10] [Damage=10] [Heal=5]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+			[](const TArray<FString>& Args, UWorld* World)
+			{
+				if (ActiveReplicationRun.IsValid() || bCapturing)
+				{
+					UE_LOG(LogGAHA, Warning, TEXT("GAHA.Bench.Replication: A benchmark is already running."));
+					return;
+				}
+
+				FReplicationRunConfig Config;
+
+				if (Args.IsValidIndex(0))
+				{
+					for (auto ScenarioIndex{ 0 }; ScenarioIndex < static_cast<int32>(EReplicationScenario::MAX); ++ScenarioIndex)
+					{
+						if (Args[0].Equals(GetScenarioName(static_cast<EReplicationScenario>(ScenarioIndex)), ESearchCase::IgnoreCase))
+						{
+							Config.Scenario = static_cast<EReplicationScenario>(ScenarioIndex);
+						}
+					}
+				}
+
+				if (Args.IsValidIndex(1)) { LexFromString(Config.Seconds, *Args[1]); }
+				if (Args.IsValidIndex(2)) { LexFromString(Config.Damage, *Args[2]); }
+				if (Args.IsValidIndex(3)) { LexFromString(Config.Heal, *Args[3]); }
+
+				Config.Seconds = FMath::Max(Config.Seconds, 1.0f);
+
+				ActiveReplicationRun = MakeUnique<FReplicationRun>(World, Config);
+
+				if (!ActiveReplicationRun->Start())
+				{
+					ActiveReplicationRun.Reset();
+					return;
+				}
+
+				FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickActiveReplicationRun));
+			}));
+}
+
+#endif // #if GAHA_WITH_BENCHMARK
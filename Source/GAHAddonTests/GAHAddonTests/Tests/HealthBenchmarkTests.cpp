@@ -0,0 +1,139 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTestWorld.h"
+#include "HealthTestDeathAbility.h"
+
+#include "Benchmark/HealthBenchmarkRun.h"
+#include "Benchmark/HealthBenchmarkActor.h"
+#include "HealthComponent.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && GAHA_WITH_BENCHMARK
+
+namespace GAHABenchmarkTests
+{
+	/**
+	 * Run the benchmark to completion in the test world, returns null if it did not finish
+	 */
+	static TUniquePtr<GAHABenchmark::FRun> RunBenchmark(FAutomationTestBase& Test, FHealthTestWorld& TestWorld, const GAHABenchmark::FRunConfig& Config)
+	{
+		// The run is owned here and ticked alongside the world, so it is also destroyed outside of its own tick
+
+		auto Run{ MakeUnique<GAHABenchmark::FRun>(TestWorld.GetWorld(), Config) };
+
+		if (!Test.TestTrue(TEXT("Run started"), Run->Start()))
+		{
+			return nullptr;
+		}
+
+		auto bRunning{ true };
+		TestWorld.TickUntil([&Run, &bRunning]()
+		{
+			bRunning = Run->Tick(1.0f / 60.0f);
+			return !bRunning;
+		}, Config.NumFrames + 600);
+
+		if (!Test.TestFalse(TEXT("Run stopped"), bRunning) || !Test.TestTrue(TEXT("Run finished"), Run->HasFinished()))
+		{
+			return nullptr;
+		}
+
+		Test.TestEqual(TEXT("Actors spawned"), Run->GetActors().Num(), Config.NumActors);
+		Test.TestEqual(TEXT("Frames run"), Run->GetFramesRun(), Config.NumFrames);
+
+		return Run;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHealthBenchmarkRunTest, "GAHAddon.Benchmark.Run",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool FHealthBenchmarkRunTest::RunTest(const FString& Parameters)
+{
+	using namespace GAHABenchmarkTests;
+
+	FHealthTestWorld TestWorld;
+
+	// Damage outpaces healing without killing anyone
+
+	GAHABenchmark::FRunConfig Config;
+	Config.NumActors = 8;
+	Config.NumFrames = 30;
+	Config.Damage = 2.0f;
+	Config.Heal = 1.0f;
+	Config.bWriteResults = false;
+
+	auto Run{ RunBenchmark(*this, TestWorld, Config) };
+	if (!Run)
+	{
+		return false;
+	}
+
+	for (const auto& Actor : Run->GetActors())
+	{
+		const auto* HealthComponent{ Actor->GetHealthComponent() };
+
+		TestTrue(TEXT("Damage applied"), HealthComponent->GetTotalHealth() < HealthComponent->GetTotalMaxHealth());
+		TestTrue(TEXT("Healing applied"), HealthComponent->GetTotalHealth() > HealthComponent->GetTotalMaxHealth() - (Config.NumFrames * Config.Damage));
+		TestTrue(TEXT("Alive"), HealthComponent->GetDeathState() == EDeathState::NotDead);
+	}
+
+	TestEqual(TEXT("Deaths"), Run->GetDeaths(), 0);
+
+	// Every measured phase of the pipeline ran
+
+	TestTrue(TEXT("Execution phase measured"), GAHABenchmark::GetPhaseMilliseconds(EHealthBenchmarkPhase::Execution) > 0.0);
+	TestTrue(TEXT("PreExecute phase measured"), GAHABenchmark::GetPhaseMilliseconds(EHealthBenchmarkPhase::PreExecute) > 0.0);
+	TestTrue(TEXT("PostExecute phase measured"), GAHABenchmark::GetPhaseMilliseconds(EHealthBenchmarkPhase::PostExecute) > 0.0);
+	TestTrue(TEXT("Notification phase measured"), GAHABenchmark::GetPhaseMilliseconds(EHealthBenchmarkPhase::Notification) > 0.0);
+
+	Run.Reset();
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHealthBenchmarkLethalRunTest, "GAHAddon.Benchmark.LethalRun",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool FHealthBenchmarkLethalRunTest::RunTest(const FString& Parameters)
+{
+	using namespace GAHABenchmarkTests;
+
+	FHealthTestWorld TestWorld;
+
+	// Every actor runs out of health within the run
+
+	GAHABenchmark::FRunConfig Config;
+	Config.NumActors = 8;
+	Config.NumFrames = 10;
+	Config.HealPerFrame = 0;
+	Config.Damage = 100.0f;
+	Config.bWriteResults = false;
+	Config.DeathAbilityClass = UHealthTestDeathAbility::StaticClass();
+
+	auto Run{ RunBenchmark(*this, TestWorld, Config) };
+	if (!Run)
+	{
+		return false;
+	}
+
+	for (const auto& Actor : Run->GetActors())
+	{
+		const auto* HealthComponent{ Actor->GetHealthComponent() };
+
+		TestTrue(TEXT("Out of health"), HealthComponent->GetHealth() <= 0.0f);
+		TestTrue(TEXT("Dead or dying"), HealthComponent->IsDeadOrDying());
+	}
+
+	TestEqual(TEXT("Deaths"), Run->GetDeaths(), Config.NumActors);
+	TestTrue(TEXT("Death phase measured"), GAHABenchmark::GetPhaseMilliseconds(EHealthBenchmarkPhase::Death) > 0.0);
+
+	Run.Reset();
+
+	return true;
+}
+
+#endif // #if WITH_DEV_AUTOMATION_TESTS && GAHA_WITH_BENCHMARK
@@ -0,0 +1,56 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTestWorld.h"
+
+#include "Benchmark/HealthBenchmarkActor.h"
+#include "Ability/GameplayAbility_Death.h"
+#include "HealthComponent.h"
+#include "HealthData.h"
+
+#include "AbilitySystemComponent.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHealthDataMissingAssetsTest, "GAHAddon.HealthComponent.MissingHealthDataAssets",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool FHealthDataMissingAssetsTest::RunTest(const FString& Parameters)
+{
+	AddExpectedError(TEXT("Failed to load"), EAutomationExpectedErrorFlags::Contains, 0);
+
+	FHealthTestWorld TestWorld;
+
+	// Death ability that does not exist, as left behind by a deleted or renamed asset
+
+	const TStrongObjectPtr<UHealthData> HealthData{ NewObject<UHealthData>(GetTransientPackage(), NAME_None, RF_Transient) };
+	HealthData->DeathEventAbilityClass = TSoftClassPtr<UGameplayAbility_Death>(FSoftObjectPath(TEXT("/Game/GAHAddonTests/Missing/GA_MissingDeath.GA_MissingDeath_C")));
+
+	for (const auto bGrantDeathAbilityOnDeath : { false, true })
+	{
+		HealthData->bGrantDeathAbilityOnDeath = bGrantDeathAbilityOnDeath;
+
+		auto* Actor{ TestWorld.SpawnHealthActor(HealthData.Get()) };
+		if (!TestNotNull(TEXT("Initialized health actor"), Actor))
+		{
+			return false;
+		}
+
+		auto* HealthComponent{ Actor->GetHealthComponent() };
+		auto* AbilitySystemComponent{ Actor->GetAbilitySystemComponent() };
+
+		TestFalse(TEXT("Death ability loaded"), HealthData->DeathEventAbilityClass.IsValid());
+		TestEqual(TEXT("Health applied"), HealthComponent->GetHealth(), HealthData->Health);
+
+		const auto bHasDeathAbility{ AbilitySystemComponent->GetActivatableAbilities().ContainsByPredicate([](const FGameplayAbilitySpec& Spec) { return Spec.Ability && Spec.Ability->IsA<UGameplayAbility_Death>(); }) };
+		TestFalse(TEXT("Death ability granted"), bHasDeathAbility);
+
+		Actor->Destroy();
+	}
+
+	return true;
+}
+
+#endif // #if WITH_DEV_AUTOMATION_TESTS
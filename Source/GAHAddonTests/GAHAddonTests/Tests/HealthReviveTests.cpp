@@ -0,0 +1,99 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTestWorld.h"
+#include "HealthTestDeathAbility.h"
+
+#include "Benchmark/HealthBenchmarkActor.h"
+#include "Benchmark/HealthBenchmarkEffects.h"
+#include "Attribute/HealthAttributeSet.h"
+#include "HealthComponent.h"
+#include "HealthData.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayEffect.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GAHAReviveTests
+{
+	static bool IsDeathAbilityActive(const UAbilitySystemComponent* AbilitySystemComponent)
+	{
+		for (const auto& Spec : AbilitySystemComponent->GetActivatableAbilities())
+		{
+			if (Spec.IsActive() && Spec.Ability && Spec.Ability->IsA<UGameplayAbility_Death>())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHealthReviveMidDeathTest, "GAHAddon.HealthComponent.ReviveMidDeathThenDieAgain",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::EngineFilter)
+
+bool FHealthReviveMidDeathTest::RunTest(const FString& Parameters)
+{
+	using namespace GAHAReviveTests;
+
+	FHealthTestWorld TestWorld;
+
+	const TStrongObjectPtr<UGameplayEffect> DamageEffect{ GAHABenchmark::CreateAttributeEffect(UHealthAttributeSet::GetDamageAttribute()) };
+
+	// Once with the death ability granted for the lifetime of the health data, once granted only on death
+
+	for (const auto bGrantDeathAbilityOnDeath : { false, true })
+	{
+		const TStrongObjectPtr<UHealthData> HealthData{ NewObject<UHealthData>(GetTransientPackage(), NAME_None, RF_Transient) };
+		HealthData->DeathEventAbilityClass = UHealthTestDeathAbility::StaticClass();
+		HealthData->bGrantDeathAbilityOnDeath = bGrantDeathAbilityOnDeath;
+
+		auto* Actor{ TestWorld.SpawnHealthActor(HealthData.Get()) };
+		if (!TestNotNull(TEXT("Initialized health actor"), Actor))
+		{
+			return false;
+		}
+
+		auto* HealthComponent{ Actor->GetHealthComponent() };
+		auto* AbilitySystemComponent{ Actor->GetAbilitySystemComponent() };
+
+		const auto Kill
+		{
+			[&]()
+			{
+				GAHABenchmark::ApplyAttributeEffect(AbilitySystemComponent, DamageEffect.Get(), HealthComponent->GetTotalHealth() + 1.0f);
+				return TestWorld.TickUntil([HealthComponent]() { return HealthComponent->GetDeathState() == EDeathState::DeathStarted; }, 60);
+			}
+		};
+
+		// First death, left unfinished by the test death ability
+
+		TestTrue(TEXT("Death started"), Kill());
+		TestTrue(TEXT("Death ability active while dying"), IsDeathAbilityActive(AbilitySystemComponent));
+
+		// Revive mid death
+
+		TestTrue(TEXT("Revived"), HealthComponent->Revive(HealthComponent->GetMaxHealth(), 0.0f));
+		TestTrue(TEXT("Not dead after revive"), HealthComponent->GetDeathState() == EDeathState::NotDead);
+		TestFalse(TEXT("Death ability active after revive"), IsDeathAbilityActive(AbilitySystemComponent));
+		TestTrue(TEXT("Health restored"), HealthComponent->GetHealth() > 0.0f);
+
+		TestWorld.Tick();
+
+		// Second death must go through the death ability again
+
+		TestTrue(TEXT("Died again"), Kill());
+		TestTrue(TEXT("Death ability active on second death"), IsDeathAbilityActive(AbilitySystemComponent));
+
+		Actor->Destroy();
+	}
+
+	return true;
+}
+
+#endif // #if WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,11 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTestDeathAbility.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(HealthTestDeathAbility)
+
+
+UHealthTestDeathAbility::UHealthTestDeathAbility(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
@@ -0,0 +1,20 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "Ability/GameplayAbility_Death.h"
+
+#include "HealthTestDeathAbility.generated.h"
+
+
+/**
+ * Death ability used by the automation tests, starts the death on activation and never finishes it by itself
+ */
+UCLASS(NotBlueprintable, Transient)
+class GAHADDONTESTS_API UHealthTestDeathAbility : public UGameplayAbility_Death
+{
+	GENERATED_BODY()
+public:
+	UHealthTestDeathAbility(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+};
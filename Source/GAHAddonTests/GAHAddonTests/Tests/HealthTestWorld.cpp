@@ -0,0 +1,90 @@
+// Copyright (C) 2024 owoDra
+
+#include "HealthTestWorld.h"
+
+#include "Benchmark/HealthBenchmarkActor.h"
+#include "HealthComponent.h"
+
+#include "InitState/InitStateTags.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+
+FHealthTestWorld::FHealthTestWorld()
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->InitializeStandalone(TEXT("GAHATestWorld"));
+
+	World = GameInstance->GetWorld();
+
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+}
+
+FHealthTestWorld::~FHealthTestWorld()
+{
+	if (GameInstance)
+	{
+		GameInstance->Shutdown();
+	}
+
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+}
+
+void FHealthTestWorld::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(GameInstance);
+	Collector.AddReferencedObject(World);
+}
+
+FString FHealthTestWorld::GetReferencerName() const
+{
+	return TEXT("FHealthTestWorld");
+}
+
+AHealthBenchmarkActor* FHealthTestWorld::SpawnHealthActor(const UHealthData* HealthData)
+{
+	auto* NewActor{ World->SpawnActor<AHealthBenchmarkActor>(AHealthBenchmarkActor::StaticClass(), FTransform::Identity) };
+	if (!NewActor)
+	{
+		return nullptr;
+	}
+
+	auto* HealthComponent{ NewActor->GetHealthComponent() };
+	HealthComponent->SetHealthData(HealthData);
+
+	const auto bInitialized{ TickUntil([HealthComponent]() { return HealthComponent->HasReachedInitState(TAG_InitState_DataInitialized); }) };
+
+	return bInitialized ? NewActor : nullptr;
+}
+
+void FHealthTestWorld::Tick(int32 NumFrames, float DeltaTime)
+{
+	for (auto Frame{ 0 }; Frame < NumFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+}
+
+bool FHealthTestWorld::TickUntil(TFunctionRef<bool()> Predicate, int32 MaxFrames, float DeltaTime)
+{
+	for (auto Frame{ 0 }; Frame < MaxFrames; ++Frame)
+	{
+		if (Predicate())
+		{
+			return true;
+		}
+
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	return Predicate();
+}
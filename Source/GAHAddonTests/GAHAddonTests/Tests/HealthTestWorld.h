@@ -0,0 +1,51 @@
+// Copyright (C) 2024 owoDra
+
+#pragma once
+
+#include "UObject/GCObject.h"
+
+class AHealthBenchmarkActor;
+class UGameInstance;
+class UHealthData;
+class UWorld;
+
+
+/**
+ * Standalone game world with a game instance used by the automation tests
+ *
+ * Tips:
+ *	Runs without a viewport, so the tests work in the editor and in -nullrhi commandlet sessions.
+ *	The world is destroyed with the fixture.
+ */
+class GAHADDONTESTS_API FHealthTestWorld : public FGCObject
+{
+public:
+	FHealthTestWorld();
+	virtual ~FHealthTestWorld();
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	virtual FString GetReferencerName() const override;
+
+	UWorld* GetWorld() const { return World; }
+
+	/**
+	 * Spawn an actor with an ability system and a health component initialized from the health data.
+	 * Returns null if the health component does not finish its initialization.
+	 */
+	AHealthBenchmarkActor* SpawnHealthActor(const UHealthData* HealthData);
+
+	/**
+	 * Tick the world NumFrames times with a fixed delta time
+	 */
+	void Tick(int32 NumFrames = 1, float DeltaTime = 1.0f / 60.0f);
+
+	/**
+	 * Tick the world until the predicate returns true, returns false if it did not within MaxFrames
+	 */
+	bool TickUntil(TFunctionRef<bool()> Predicate, int32 MaxFrames = 600, float DeltaTime = 1.0f / 60.0f);
+
+private:
+	TObjectPtr<UGameInstance> GameInstance{ nullptr };
+	TObjectPtr<UWorld> World{ nullptr };
+
+};